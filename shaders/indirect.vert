@@ -0,0 +1,17 @@
+#version 450
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec4 inTransform;
+
+layout(location = 0) out vec3 fragColor;
+
+layout(std140, set = 1, binding = 0) uniform Frame {
+    mat4 viewProjection;
+    vec4 time;          // Seconds since the engine started in x
+} frame;
+
+void main() {
+    gl_Position = frame.viewProjection * vec4(inPosition * inTransform.z + inTransform.xy, 0.0, 1.0);
+    fragColor = inColor;
+}
@@ -1,20 +1,20 @@
 #version 450
 
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
 layout(location = 0) out vec3 fragColor;
 
-vec2 positions[3] = vec2[](
-vec2(0.0, -0.5),
-vec2(0.5, 0.5),
-vec2(-0.5, 0.5)
-);
+layout(std140, set = 1, binding = 0) uniform Frame {
+    mat4 viewProjection;
+    vec4 time;          // Seconds since the engine started in x
+} frame;
 
-vec3 colors[3] = vec3[](
-vec3(1.0, 0.0, 0.0),
-vec3(0.0, 1.0, 0.0),
-vec3(0.0, 0.0, 1.0)
-);
+layout(push_constant) uniform Draw {
+    vec4 transform;     // Offset in xy and uniform scale in z
+} draw;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
-}
\ No newline at end of file
+    gl_Position = frame.viewProjection * vec4(inPosition * draw.transform.z + draw.transform.xy, 0.0, 1.0);
+    fragColor = inColor;
+}
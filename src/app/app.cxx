@@ -17,7 +17,11 @@ namespace app {
     void App::mainLoop()
     {
         while (!m_window.shouldClose()) {
-            vkfw::pollEvents();
+            // Sleep while minimized rather than spinning, the engine skips frames for a zero-sized framebuffer
+            if (const auto [ width, height ]{ m_window.getFramebufferSize() }; width == 0 || height == 0)
+                vkfw::waitEvents();
+            else
+                vkfw::pollEvents();
             m_engine.drawFrame();
         }
     }
@@ -23,7 +23,7 @@ namespace app {
                   720,
                   "Vulkan Demo",
                   {
-                      .resizable = false,
+                      .resizable = true,
                       .clientAPI = vkfw::ClientAPI::eNone
                   }
               },
@@ -0,0 +1,36 @@
+#include <exception>
+#include <iostream>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+import bench;
+
+auto main(const int argc, const char* const argv[]) -> int
+{
+    const std::span<const char* const> args{ argv + 1, static_cast<std::size_t>(argc - 1) };
+    if (!args.empty() && (std::string_view{ args.front() } == "--help" || std::string_view{ args.front() } == "-h")) {
+        std::print("{}", bench::getUsage());
+        return EXIT_SUCCESS;
+    }
+
+    try {
+        const auto config{ bench::parseArguments(args) };
+        if (config.culling_microbenchmark)
+            std::print("{}", bench::formatCullingResult(bench::runCullingBenchmark(config)));
+        else
+            std::print("{}", bench::formatResult(bench::runBenchmark(config)));
+    } catch (const std::invalid_argument& err) {
+        std::println(std::cerr, "{}\n{}", err.what(), bench::getUsage());
+        return EXIT_FAILURE;
+    } catch (const std::exception& err) {
+        std::println(std::cerr, "PANIC: {}", err.what());
+        return EXIT_FAILURE;
+    } catch (...) {
+        std::println(std::cerr, "PANIC: Unknown exception");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,441 @@
+module;
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+module bench;
+
+// External Dependencies
+import glm;
+import vulkan_hpp;
+
+// Internal Dependencies
+import engine;
+import capture;
+import command;
+import culling;
+import init;
+import scene;
+import thread_pool;
+
+namespace bench {
+    namespace {
+        std::uint64_t parseInteger(const std::string_view option, const std::string_view value)
+        {
+            std::uint64_t result{ 0 };
+            const auto [ end, error ]{ std::from_chars(value.data(), value.data() + value.size(), result) };
+            if (error != std::errc{ } || end != value.data() + value.size())
+                throw std::invalid_argument(std::format("invalid value for {}: \"{}\"", option, value));
+            return result;
+        }
+
+        std::uint32_t parseCount(const std::string_view option, const std::string_view value)
+        {
+            const auto result{ parseInteger(option, value) };
+            if (result == 0 || result > std::numeric_limits<std::uint32_t>::max())
+                throw std::invalid_argument(std::format("value for {} is out of range: {}", option, value));
+            return static_cast<std::uint32_t>(result);
+        }
+
+        double parseSeconds(const std::string_view option, const std::string_view value)
+        {
+            try {
+                std::size_t parsed{ 0 };
+                const double result{ std::stod(std::string{ value }, &parsed) };
+                if (parsed == value.size() && result > 0.0)
+                    return result;
+            } catch (const std::logic_error&) {
+                // Fall through to the common error below
+            }
+            throw std::invalid_argument(std::format("invalid value for {}: \"{}\"", option, value));
+        }
+
+        Scenario findScenario(const std::string_view name)
+        {
+            const auto iter{ std::ranges::find(SCENARIOS, name, &Scenario::name) };
+            if (iter == SCENARIOS.end())
+                throw std::invalid_argument(std::format("unknown scenario: \"{}\"", name));
+            return *iter;
+        }
+
+        // The implementations measured by the culling microbenchmark for each scene size
+        constexpr std::size_t CULLING_KERNEL_COUNT{ 4 };
+
+        /**
+         * The baseline the culling kernels are measured against, a plain loop testing one interleaved object at a
+         * time against every plane with glm
+         */
+        std::uint32_t cullWithGlm(const std::span<const eng::cull::ObjectData> objects,
+                                  const eng::scene::CullingParams& params,
+                                  std::vector<std::uint32_t>& visible)
+        {
+            visible.clear();
+            for (std::uint32_t i = 0; i < objects.size(); ++i) {
+                const glm::vec4 center{ glm::vec3{ objects[i].bounds }, 1.0f };
+                const float radius{ objects[i].bounds.w };
+                const glm::vec3 offset{ glm::vec3{ center } - params.camera_position };
+                const float reach{ params.max_distance + radius };
+                bool inside{ glm::dot(offset, offset) <= reach * reach };
+                for (const auto& plane : params.frustum)
+                    inside &= glm::dot(plane, center) >= -radius;
+                if (inside)
+                    visible.push_back(i);
+            }
+            return static_cast<std::uint32_t>(visible.size());
+        }
+
+        /**
+         * Runs a culling implementation for the warm-up count, then measures it for the configured frame count or
+         * duration
+         * @param cull the implementation, returning the number of visible objects
+         */
+        template <typename F>
+        CullingSample measureCulling(const BenchConfig& config, const std::string_view kernel, F&& cull)
+        {
+            using clock = std::chrono::steady_clock;
+            CullingSample sample{ .kernel = kernel };
+            for (std::uint32_t i = 0; i < config.warmup_frames; ++i)
+                sample.visible_count = cull();
+
+            clock::duration total{ 0 };
+            clock::duration fastest{ clock::duration::max() };
+            const auto deadline{ clock::now() + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>{ config.duration_seconds }) };
+            while (config.duration_seconds > 0.0 ? clock::now() < deadline : sample.iterations < config.frame_count) {
+                const auto start{ clock::now() };
+                sample.visible_count = cull();
+                const auto elapsed{ clock::now() - start };
+                total += elapsed;
+                fastest = std::min(fastest, elapsed);
+                ++sample.iterations;
+            }
+
+            using microseconds = std::chrono::duration<double, std::micro>;
+            if (sample.iterations > 0) {
+                sample.mean_us = microseconds{ total }.count() / static_cast<double>(sample.iterations);
+                sample.min_us = microseconds{ fastest }.count();
+            }
+            return sample;
+        }
+    }
+
+    BenchConfig parseArguments(const std::span<const char* const> args)
+    {
+        BenchConfig config{ };
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            const std::string_view option{ args[i] };
+            if (i + 1 >= args.size())
+                throw std::invalid_argument(std::format("missing value for {}", option));
+            const std::string_view value{ args[++i] };
+
+            if (option == "--scenario")
+                config.scenario = findScenario(value);
+            else if (option == "--frames")
+                config.frame_count = parseCount(option, value);
+            else if (option == "--duration")
+                config.duration_seconds = parseSeconds(option, value);
+            else if (option == "--warmup")
+                config.warmup_frames = static_cast<std::uint32_t>(parseInteger(option, value));
+            else if (option == "--frames-in-flight")
+                config.frames_in_flight = parseCount(option, value);
+            else if (option == "--width")
+                config.scenario.width = parseCount(option, value);
+            else if (option == "--height")
+                config.scenario.height = parseCount(option, value);
+            else if (option == "--triangles")
+                config.scenario.triangle_count = parseCount(option, value);
+            else if (option == "--draws")
+                config.scenario.draw_count = parseCount(option, value);
+            else if (option == "--gpu-driven" && (value == "on" || value == "off"))
+                config.gpu_driven = value == "on";
+            else if (option == "--parallel-recording" && (value == "on" || value == "off"))
+                config.parallel_recording = value == "on";
+            else if (option == "--async-compute" && (value == "on" || value == "off"))
+                config.async_compute = value == "on";
+            else if (option == "--command-caching" && (value == "on" || value == "off"))
+                config.command_caching = value == "on";
+            else if (option == "--microbench" && value == "culling")
+                config.culling_microbenchmark = true;
+            else if (option == "--capture")
+                config.capture_path = value;
+            else if (option == "--capture-format" && value == "raw")
+                config.capture_format = eng::capture::CaptureFormat::Raw;
+            else if (option == "--capture-format" && value == "png")
+                config.capture_format = eng::capture::CaptureFormat::Png;
+            else if (option == "--capture-format" && value == "stream")
+                config.capture_format = eng::capture::CaptureFormat::Stream;
+            else if (option == "--format" && value == "json")
+                config.format = OutputFormat::JSON;
+            else if (option == "--format" && value == "csv")
+                config.format = OutputFormat::CSV;
+            else
+                throw std::invalid_argument(std::format("unrecognized argument: {} {}", option, value));
+        }
+        return config;
+    }
+
+    BenchResult runBenchmark(const BenchConfig& config)
+    {
+        const auto& scenario{ config.scenario };
+        eng::Engine engine{ vk::Extent2D{ scenario.width, scenario.height }, config.frames_in_flight };
+        engine.setWorkload({ scenario.triangle_count, scenario.draw_count });
+        engine.setParallelRecording(config.parallel_recording);
+        engine.setAsyncCompute(config.async_compute);
+        engine.setCommandCaching(config.command_caching);
+        engine.setGpuDriven(config.gpu_driven);
+
+        // Warm up the driver and caches, then discard the warm-up samples
+        for (std::uint32_t i = 0; i < config.warmup_frames; ++i)
+            engine.drawFrame();
+        engine.waitIdle();
+        engine.getProfiler().reset();
+        engine.getScheduler().resetWaitStatistics();
+        engine.resetCommandCacheStatistics();
+        if (!config.capture_path.empty())
+            engine.startCapture({ .output = config.capture_path, .format = config.capture_format });
+
+        // Render for the configured number of frames or the configured duration
+        using clock = std::chrono::steady_clock;
+        std::uint64_t frames_rendered{ 0 };
+        const auto start{ clock::now() };
+        if (config.duration_seconds > 0.0) {
+            const auto deadline{ start + std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>{ config.duration_seconds }) };
+            while (clock::now() < deadline) {
+                engine.drawFrame();
+                ++frames_rendered;
+            }
+        } else {
+            for (; frames_rendered < config.frame_count; ++frames_rendered)
+                engine.drawFrame();
+        }
+
+        // Throughput includes the time for the GPU to drain the final frames
+        engine.waitIdle();
+        const std::chrono::duration<double> elapsed{ clock::now() - start };
+
+        // Writing out the last captured frames is excluded from the measurement
+        const auto capture_statistics{ engine.stopCapture() };
+
+        const auto& profiler{ engine.getProfiler() };
+        const auto cache_statistics{ engine.getPipelineCacheStatistics() };
+        const auto& wait_statistics{ engine.getScheduler().getWaitStatistics() };
+        const auto& command_cache_statistics{ engine.getCommandCacheStatistics() };
+        return {
+            config,
+            frames_rendered,
+            elapsed.count(),
+            std::string{ engine.getGPU().getProperties().deviceName },
+            cache_statistics.hits,
+            cache_statistics.misses,
+            cache_statistics.creation_ms,
+            wait_statistics.blocking_waits,
+            std::chrono::duration<double, std::milli>{ wait_statistics.blocked }.count(),
+            capture_statistics.written,
+            capture_statistics.dropped,
+            command_cache_statistics.replayed,
+            engine.getStartupTimings(),
+            config.format == OutputFormat::JSON ? profiler.exportJSON() : profiler.exportCSV()
+        };
+    }
+
+    CullingBenchResult runCullingBenchmark(const BenchConfig& config)
+    {
+        // A view of the engine's spinning grid, with a draw distance which also culls the grid's corners
+        constexpr float aspect{ 16.0f / 9.0f };
+        const auto view_projection{ glm::rotate(glm::scale(glm::mat4{ 1.0f }, glm::vec3{ 1.0f / aspect, 1.0f, 1.0f }),
+                                                0.5f,
+                                                glm::vec3{ 0.0f, 0.0f, 1.0f }) };
+        const eng::scene::CullingParams params{
+            .frustum = eng::cull::extractFrustum(view_projection),
+            .camera_position = glm::vec3{ 0.0f },
+            .max_distance = 1.25f * eng::cull::GRID_HALF_EXTENT
+        };
+
+        // Culling in parallel from the first object, so the split is measured below the engine's threshold too
+        eng::scene::SceneCuller parallel_culler{
+            static_cast<std::uint32_t>(util::ThreadPool::getDefaultThreadCount()),
+            0
+        };
+        CullingBenchResult result{
+            .config = config,
+            .simd_kernel = eng::scene::SIMD_KERNEL_NAME,
+            .worker_count = parallel_culler.getWorkerCount()
+        };
+
+        for (const auto object_count : CULLING_OBJECT_COUNTS) {
+            const auto objects{ eng::cull::createObjectGrid(object_count, 1.0f) };
+            const eng::scene::Scene scene{ objects };
+            std::vector<std::uint32_t> baseline_visible;
+            baseline_visible.reserve(object_count);
+            std::vector<std::uint32_t> visible(scene.getPaddedCount());
+
+            const auto cullRange = [&](const eng::scene::CullingKernel kernel) {
+                return eng::scene::cullRange(scene, params, 0, scene.getPaddedCount(), visible, kernel);
+            };
+            const std::array samples{
+                measureCulling(config, "glm_scalar", [&] { return cullWithGlm(objects, params, baseline_visible); }),
+                measureCulling(config, "soa_scalar", [&] { return cullRange(eng::scene::CullingKernel::Scalar); }),
+                measureCulling(config, "soa_simd", [&] { return cullRange(eng::scene::CullingKernel::Simd); }),
+                measureCulling(config, "soa_simd_parallel", [&] {
+                    return static_cast<std::uint32_t>(parallel_culler.cull(scene, params).size());
+                })
+            };
+            static_assert(std::tuple_size_v<decltype(samples)> == CULLING_KERNEL_COUNT);
+            for (auto sample : samples) {
+                sample.object_count = object_count;
+                result.samples.push_back(sample);
+            }
+        }
+        return result;
+    }
+
+    std::string formatResult(const BenchResult& result)
+    {
+        const auto& [ name, width, height, triangle_count, draw_count ]{ result.config.scenario };
+        const double frames_per_second{
+            result.elapsed_seconds > 0.0 ? static_cast<double>(result.frames_rendered) / result.elapsed_seconds : 0.0
+        };
+
+        if (result.config.format == OutputFormat::CSV) {
+            return std::format(
+                "scenario,device,width,height,triangles,draws,frames_in_flight,frames,elapsed_s,fps,"
+                "pipeline_cache_hits,pipeline_cache_misses,pipeline_creation_ms,blocking_waits,blocked_ms,"
+                "frames_captured,frames_dropped,frames_replayed,startup_ms,device_selection_ms,device_snapshot_hit\n"
+                "{},\"{}\",{},{},{},{},{},{},{:.6f},{:.3f},{},{},{:.3f},{},{:.3f},{},{},{},{:.3f},{:.3f},{}\n\n{}",
+                name, result.device_name, width, height, triangle_count, draw_count,
+                result.config.frames_in_flight, result.frames_rendered, result.elapsed_seconds, frames_per_second,
+                result.pipeline_cache_hits, result.pipeline_cache_misses, result.pipeline_creation_ms,
+                result.blocking_waits, result.blocked_ms,
+                result.frames_captured, result.frames_dropped, result.frames_replayed,
+                result.startup.total_ms, result.startup.device_selection_ms, result.startup.device_snapshot_hit,
+                result.phase_report
+            );
+        }
+
+        return std::format(
+            "{{\n"
+            "\"scenario\": {{ \"name\": \"{}\", \"width\": {}, \"height\": {}, \"triangles\": {}, \"draws\": {} }},\n"
+            "\"device\": \"{}\",\n"
+            "\"frames_in_flight\": {},\n"
+            "\"frames\": {},\n"
+            "\"elapsed_s\": {:.6f},\n"
+            "\"fps\": {:.3f},\n"
+            "\"pipeline_cache\": {{ \"hits\": {}, \"misses\": {}, \"creation_ms\": {:.3f} }},\n"
+            "\"queue_waits\": {{ \"blocking\": {}, \"blocked_ms\": {:.3f} }},\n"
+            "\"capture\": {{ \"written\": {}, \"dropped\": {} }},\n"
+            "\"command_cache\": {{ \"replayed\": {} }},\n"
+            "\"startup\": {{ \"total_ms\": {:.3f}, \"instance_ms\": {:.3f}, \"device_selection_ms\": {:.3f}, "
+            "\"device_creation_ms\": {:.3f}, \"render_targets_ms\": {:.3f}, \"rendering_resources_ms\": {:.3f}, "
+            "\"device_snapshot_hit\": {}, \"probed_devices\": {} }},\n"
+            "\"profile\": {}"
+            "}}\n",
+            name, width, height, triangle_count, draw_count,
+            result.device_name,
+            result.config.frames_in_flight,
+            result.frames_rendered,
+            result.elapsed_seconds,
+            frames_per_second,
+            result.pipeline_cache_hits,
+            result.pipeline_cache_misses,
+            result.pipeline_creation_ms,
+            result.blocking_waits,
+            result.blocked_ms,
+            result.frames_captured,
+            result.frames_dropped,
+            result.frames_replayed,
+            result.startup.total_ms,
+            result.startup.instance_ms,
+            result.startup.device_selection_ms,
+            result.startup.device_creation_ms,
+            result.startup.render_targets_ms,
+            result.startup.rendering_resources_ms,
+            result.startup.device_snapshot_hit,
+            result.startup.probed_devices,
+            result.phase_report
+        );
+    }
+
+    std::string formatCullingResult(const CullingBenchResult& result)
+    {
+        // Each sample's speedup is over the glm baseline of the same scene size, the first sample of its group
+        const auto getSpeedup = [&result](const std::size_t i) {
+            const auto& baseline{ result.samples[i - i % CULLING_KERNEL_COUNT] };
+            return result.samples[i].mean_us > 0.0 ? baseline.mean_us / result.samples[i].mean_us : 0.0;
+        };
+
+        if (result.config.format == OutputFormat::CSV) {
+            std::string csv{ "kernel,simd,workers,objects,visible,iterations,mean_us,min_us,speedup\n" };
+            for (std::size_t i = 0; i < result.samples.size(); ++i) {
+                const auto& sample{ result.samples[i] };
+                csv += std::format("{},{},{},{},{},{},{:.3f},{:.3f},{:.3f}\n",
+                                   sample.kernel, result.simd_kernel, result.worker_count, sample.object_count,
+                                   sample.visible_count, sample.iterations, sample.mean_us, sample.min_us, getSpeedup(i));
+            }
+            return csv;
+        }
+
+        std::string samples;
+        for (std::size_t i = 0; i < result.samples.size(); ++i) {
+            const auto& sample{ result.samples[i] };
+            samples += std::format(
+                "{}  {{ \"kernel\": \"{}\", \"objects\": {}, \"visible\": {}, \"iterations\": {}, "
+                "\"mean_us\": {:.3f}, \"min_us\": {:.3f}, \"speedup\": {:.3f} }}",
+                i == 0 ? "" : ",\n", sample.kernel, sample.object_count, sample.visible_count, sample.iterations,
+                sample.mean_us, sample.min_us, getSpeedup(i)
+            );
+        }
+        return std::format(
+            "{{\n"
+            "\"microbenchmark\": \"culling\",\n"
+            "\"simd\": \"{}\",\n"
+            "\"workers\": {},\n"
+            "\"samples\": [\n{}\n]\n"
+            "}}\n",
+            result.simd_kernel,
+            result.worker_count,
+            samples
+        );
+    }
+
+    std::string getUsage()
+    {
+        std::string scenario_names;
+        for (const auto& scenario : SCENARIOS)
+            scenario_names += std::format("{}{}", scenario_names.empty() ? "" : ", ", scenario.name);
+
+        return std::format(
+            "usage: vulkan_demo_bench [options]\n"
+            "  --scenario <name>         one of: {}\n"
+            "  --frames <count>          number of measured frames (default 1000)\n"
+            "  --duration <seconds>      measure for a fixed duration instead of a frame count\n"
+            "  --warmup <count>          number of discarded warm-up frames (default 100)\n"
+            "  --frames-in-flight <n>    depth of the frames-in-flight ring (default 2)\n"
+            "  --width <px>              override the scenario resolution width\n"
+            "  --height <px>             override the scenario resolution height\n"
+            "  --triangles <count>       override the triangles per draw call\n"
+            "  --draws <count>           override the draw calls per frame\n"
+            "  --gpu-driven <on|off>     cull on the GPU and draw with one indirect draw (default off)\n"
+            "  --parallel-recording <on|off>\n"
+            "                            record large draw counts on worker threads (default on)\n"
+            "  --async-compute <on|off>  cull on a dedicated compute queue while GPU-driven (default on)\n"
+            "  --command-caching <on|off>\n"
+            "                            resubmit unchanged frames' command buffers (default off)\n"
+            "  --microbench culling      time the CPU culling kernels against a scalar glm baseline instead of rendering\n"
+            "  --capture <path>          write the measured frames to a directory, or to a file or pipe if streamed\n"
+            "  --capture-format <raw|png|stream>\n"
+            "                            one file per frame, or every frame appended to one stream (default png)\n"
+            "  --format <json|csv>       output format (default json)\n",
+            scenario_names
+        );
+    }
+}
@@ -0,0 +1,159 @@
+module;
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module bench;
+
+// Internal Dependencies
+import capture;
+import init;
+
+namespace bench {
+    /**
+     * A named, reproducible rendering workload
+     */
+    export struct Scenario
+    {
+        std::string_view name;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t triangle_count;   // Triangles per draw call
+        std::uint32_t draw_count;       // Draw calls per frame
+    };
+
+    /**
+     * The built-in scenarios, selectable by name. Individual parameters may be overridden on the command line.
+     */
+    export constexpr std::array SCENARIOS{
+        Scenario{ "triangle",       1280,  720,      1,    1 },
+        Scenario{ "many_triangles", 1280,  720, 100000,    1 },
+        Scenario{ "many_draws",     1280,  720,      1, 10000 },
+        Scenario{ "high_res",       3840, 2160,      1,    1 },
+    };
+
+    export enum class OutputFormat : std::uint8_t
+    {
+        JSON,
+        CSV
+    };
+
+    export struct BenchConfig
+    {
+        Scenario scenario{ SCENARIOS.front() };
+        std::uint64_t frame_count{ 1000 };      // Ignored if a duration is specified
+        double duration_seconds{ 0.0 };         // Runs for a fixed duration instead of a fixed frame count if nonzero
+        std::uint32_t warmup_frames{ 100 };
+        std::uint32_t frames_in_flight{ 2 };
+        bool gpu_driven{ false };               // Culls on the GPU and draws every object with one indirect draw
+        bool parallel_recording{ true };        // Records large draw counts on worker threads into secondary buffers
+        bool async_compute{ true };             // Culls on a dedicated compute queue while GPU-driven, if available
+        bool command_caching{ false };          // Resubmits unchanged frames' command buffers instead of recording them
+        bool culling_microbenchmark{ false };   // Times the CPU culling kernels instead of rendering
+        std::filesystem::path capture_path;     // Captures the measured frames to this path if not empty
+        eng::capture::CaptureFormat capture_format{ eng::capture::CaptureFormat::Png };
+        OutputFormat format{ OutputFormat::JSON };
+    };
+
+    export struct BenchResult
+    {
+        BenchConfig config;
+        std::uint64_t frames_rendered{ 0 };
+        double elapsed_seconds{ 0.0 };
+        std::string device_name;
+        std::uint32_t pipeline_cache_hits{ 0 };
+        std::uint32_t pipeline_cache_misses{ 0 };
+        double pipeline_creation_ms{ 0.0 };
+        std::uint64_t blocking_waits{ 0 };  // Waits on a queue timeline which blocked the CPU
+        double blocked_ms{ 0.0 };           // Total time the CPU spent blocked on queue timelines
+        std::uint64_t frames_captured{ 0 }; // Frames written out by the capture, if capturing
+        std::uint64_t frames_dropped{ 0 };  // Frames the capture skipped because every readback buffer was busy
+        std::uint64_t frames_replayed{ 0 }; // Frames which resubmitted cached command buffers
+        eng::init::StartupTimings startup;  // The engine's startup, before warm-up
+        std::string phase_report;   // The engine profiler's report, in the configured output format
+    };
+
+    /**
+     * The scene sizes the culling microbenchmark measures, spanning the threshold culling is split across threads at
+     */
+    export constexpr std::array CULLING_OBJECT_COUNTS{ 1'000u, 10'000u, 100'000u, 1'000'000u };
+
+    /**
+     * The time one culling implementation took to cull one scene size, per cull
+     */
+    export struct CullingSample
+    {
+        std::string_view kernel;            // glm_scalar, soa_scalar, soa_simd or soa_simd_parallel
+        std::uint32_t object_count{ 0 };
+        std::uint32_t visible_count{ 0 };
+        std::uint64_t iterations{ 0 };
+        double mean_us{ 0.0 };
+        double min_us{ 0.0 };
+    };
+
+    export struct CullingBenchResult
+    {
+        BenchConfig config;
+        std::string_view simd_kernel;       // The instruction set the vectorized kernel was compiled for
+        std::uint32_t worker_count{ 0 };    // Workers culling alongside the calling thread in parallel
+        std::vector<CullingSample> samples; // Grouped by scene size, the glm baseline first
+    };
+
+    /* Benchmark Functions */
+
+    /**
+     * Parses the benchmark command line arguments into a benchmark configuration
+     * @param args the command line arguments, excluding the program name
+     * @return the benchmark configuration described by the arguments
+     * @throws std::invalid_argument if an argument is unrecognized or its value is malformed
+     */
+    export [[nodiscard]] BenchConfig
+    parseArguments(std::span<const char* const> args);
+
+    /**
+     * Renders the configured scenario headlessly, with no vsync and no event polling, after first rendering
+     * and discarding the warm-up frames
+     * @param config the benchmark configuration
+     * @return the measured throughput and the per-phase frame latency distribution
+     */
+    export [[nodiscard]] BenchResult
+    runBenchmark(const BenchConfig& config);
+
+    /**
+     * Culls grids of each scene size against a fixed frustum and draw distance, comparing a scalar loop over the
+     * interleaved objects using glm against the structure-of-arrays kernel, scalar, vectorized and split across
+     * threads. Each implementation is run for the warm-up count, then for the frame count or duration.
+     * @param config the benchmark configuration, of which the counts, the duration and the format are used
+     * @return the time per cull of every implementation and scene size
+     */
+    export [[nodiscard]] CullingBenchResult
+    runCullingBenchmark(const BenchConfig& config);
+
+    /**
+     * Formats the benchmark result in the configured machine-readable output format
+     * @param result the benchmark result
+     * @return the formatted result
+     */
+    export [[nodiscard]] std::string
+    formatResult(const BenchResult& result);
+
+    /**
+     * Formats the culling microbenchmark result in the configured machine-readable output format, with the speedup
+     * of each implementation over the glm baseline
+     * @param result the culling microbenchmark result
+     * @return the formatted result
+     */
+    export [[nodiscard]] std::string
+    formatCullingResult(const CullingBenchResult& result);
+
+    /**
+     * Returns the command line usage text for the benchmark
+     */
+    export [[nodiscard]] std::string
+    getUsage();
+}
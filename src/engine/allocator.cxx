@@ -0,0 +1,414 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+module allocator;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::mem {
+    namespace {
+        // Rounds a value up to a multiple of alignment, which Vulkan guarantees to be a power of two
+        [[nodiscard]] constexpr vk::DeviceSize alignUp(const vk::DeviceSize value, const vk::DeviceSize alignment)
+        { return (value + alignment - 1) & ~(alignment - 1); }
+    }
+
+    /* LinearRange */
+
+    std::optional<vk::DeviceSize> LinearRange::allocate(const vk::DeviceSize size, const vk::DeviceSize alignment)
+    {
+        const auto offset{ alignUp(m_head, alignment) };
+        if (offset > m_capacity || size > m_capacity - offset)
+            return std::nullopt;
+        m_head = offset + size;
+        return offset;
+    }
+
+    void LinearRange::free(vk::DeviceSize)
+    {
+        // Linear memory is only reclaimed by reset
+    }
+
+    void LinearRange::reset()
+    {
+        m_head = 0;
+    }
+
+    /* PoolRange */
+
+    PoolRange::PoolRange(const vk::DeviceSize slot_size, const std::uint32_t slot_count)
+        : m_slot_size{ slot_size },
+          m_slot_count{ slot_count }
+    {
+        reset();
+    }
+
+    std::optional<vk::DeviceSize> PoolRange::allocate(const vk::DeviceSize size, const vk::DeviceSize alignment)
+    {
+        if (m_free_slots.empty() || size > m_slot_size || m_slot_size % alignment != 0)
+            return std::nullopt;
+        const auto slot{ m_free_slots.back() };
+        m_free_slots.pop_back();
+        return slot * m_slot_size;
+    }
+
+    void PoolRange::free(const vk::DeviceSize offset)
+    {
+        m_free_slots.push_back(static_cast<std::uint32_t>(offset / m_slot_size));
+    }
+
+    void PoolRange::reset()
+    {
+        // Hand out low slots first, keeping live data packed towards the start of the block
+        m_free_slots.resize(m_slot_count);
+        std::iota(m_free_slots.rbegin(), m_free_slots.rend(), 0u);
+    }
+
+    /* FreeListRange */
+
+    FreeListRange::FreeListRange(const vk::DeviceSize capacity)
+        : m_capacity{ capacity }
+    {
+        reset();
+    }
+
+    std::optional<vk::DeviceSize> FreeListRange::allocate(const vk::DeviceSize size, const vk::DeviceSize alignment)
+    {
+        // Best fit, the smallest free range which still holds the aligned allocation
+        auto best{ m_free_ranges.end() };
+        for (auto iter{ m_free_ranges.begin() }; iter != m_free_ranges.end(); ++iter) {
+            const auto& [ range_offset, range_size ]{ *iter };
+            const auto padding{ alignUp(range_offset, alignment) - range_offset };
+            if (padding + size <= range_size && (best == m_free_ranges.end() || range_size < best->second))
+                best = iter;
+        }
+        if (best == m_free_ranges.end())
+            return std::nullopt;
+
+        // Split the range, the alignment padding before the allocation and any tail after it remain free
+        const auto [ range_offset, range_size ]{ *best };
+        const auto offset{ alignUp(range_offset, alignment) };
+        const auto tail_offset{ offset + size };
+        const auto tail_size{ range_offset + range_size - tail_offset };
+
+        m_free_ranges.erase(best);
+        if (offset > range_offset)
+            m_free_ranges.emplace(range_offset, offset - range_offset);
+        if (tail_size > 0)
+            m_free_ranges.emplace(tail_offset, tail_size);
+
+        m_allocations.emplace(offset, size);
+        m_used_bytes += size;
+        return offset;
+    }
+
+    void FreeListRange::free(const vk::DeviceSize offset)
+    {
+        const auto allocation{ m_allocations.find(offset) };
+        if (allocation == m_allocations.end())
+            throw std::invalid_argument("freed offset was not allocated from this block");
+
+        auto range_offset{ offset };
+        auto range_size{ allocation->second };
+        m_used_bytes -= range_size;
+        m_allocations.erase(allocation);
+
+        // Merge with the following free range
+        if (const auto next{ m_free_ranges.find(range_offset + range_size) }; next != m_free_ranges.end()) {
+            range_size += next->second;
+            m_free_ranges.erase(next);
+        }
+
+        // Merge with the preceding free range
+        if (auto next{ m_free_ranges.lower_bound(range_offset) }; next != m_free_ranges.begin()) {
+            if (const auto prev{ std::prev(next) }; prev->first + prev->second == range_offset) {
+                prev->second += range_size;
+                return;
+            }
+        }
+        m_free_ranges.emplace(range_offset, range_size);
+    }
+
+    void FreeListRange::reset()
+    {
+        m_free_ranges.clear();
+        m_allocations.clear();
+        m_free_ranges.emplace(0, m_capacity);
+        m_used_bytes = 0;
+    }
+
+    vk::DeviceSize FreeListRange::getLargestFreeRange() const
+    {
+        vk::DeviceSize largest{ 0 };
+        for (const auto& [ offset, size ] : m_free_ranges)
+            largest = std::max(largest, size);
+        return largest;
+    }
+
+    /* MemoryBlock */
+
+    MemoryBlock::MemoryBlock(const vk::SharedDevice& device,
+                             const std::uint32_t memory_type,
+                             const vk::DeviceSize size,
+                             const bool host_visible,
+                             const vk::DeviceSize min_alignment,
+                             const Strategy strategy,
+                             const ResourceKind kind,
+                             const vk::DeviceSize slot_size)
+        : m_memory_type{ memory_type },
+          m_size{ size },
+          m_min_alignment{ min_alignment },
+          m_strategy{ strategy },
+          m_kind{ kind },
+          m_ranges{ std::in_place_type<LinearRange>, size }
+    {
+        if (strategy == Strategy::Pool) {
+            if (slot_size == 0 || slot_size % min_alignment != 0)
+                throw std::invalid_argument("pool slot size must be a non-zero multiple of the block alignment");
+            m_ranges.emplace<PoolRange>(slot_size, static_cast<std::uint32_t>(size / slot_size));
+        } else if (strategy == Strategy::FreeList) {
+            m_ranges.emplace<FreeListRange>(size);
+        }
+
+        m_memory = vk::SharedDeviceMemory{
+            device->allocateMemory(vk::MemoryAllocateInfo()
+                .setAllocationSize( size )
+                .setMemoryTypeIndex( memory_type )),
+            device
+        };
+        dbg::setObjectName(device, m_memory.get(), "memory block (type {}, {} bytes)", memory_type, size);
+
+        // Host-visible blocks stay mapped for their whole lifetime, so sub-allocations never map individually
+        if (host_visible)
+            m_mapped = static_cast<std::byte*>(device->mapMemory(m_memory.get(), 0, vk::WholeSize));
+    }
+
+    std::optional<Allocation> MemoryBlock::allocate(const vk::MemoryRequirements& requirements)
+    {
+        if (!(requirements.memoryTypeBits & (1u << m_memory_type)))
+            throw std::invalid_argument("the block's memory type is not permitted for the resource");
+
+        const auto alignment{ std::max(requirements.alignment, m_min_alignment) };
+        const auto size{ alignUp(requirements.size, m_min_alignment) };
+
+        const std::scoped_lock lock{ m_mutex };
+        const auto offset{ std::visit([&](auto& ranges) { return ranges.allocate(size, alignment); }, m_ranges) };
+        if (!offset)
+            return std::nullopt;
+
+        ++m_allocation_count;
+        return Allocation{
+            m_memory.get(),
+            *offset,
+            size,
+            m_mapped ? m_mapped + *offset : nullptr,
+            this
+        };
+    }
+
+    void MemoryBlock::free(const Allocation& allocation)
+    {
+        const std::scoped_lock lock{ m_mutex };
+        std::visit([&](auto& ranges) { ranges.free(allocation.offset); }, m_ranges);
+        --m_allocation_count;
+    }
+
+    void MemoryBlock::reset()
+    {
+        const std::scoped_lock lock{ m_mutex };
+        std::visit([](auto& ranges) { ranges.reset(); }, m_ranges);
+        m_allocation_count = 0;
+    }
+
+    bool MemoryBlock::isEmpty() const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        return m_allocation_count == 0;
+    }
+
+    void MemoryBlock::accumulateStatistics(MemoryStatistics& statistics, vk::DeviceSize& free_list_free_bytes) const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        const auto used_bytes{ std::visit([](const auto& ranges) { return ranges.getUsedBytes(); }, m_ranges) };
+
+        ++statistics.block_count;
+        statistics.allocation_count += m_allocation_count;
+        statistics.reserved_bytes += m_size;
+        statistics.used_bytes += used_bytes;
+
+        if (const auto* free_list{ std::get_if<FreeListRange>(&m_ranges) }) {
+            statistics.largest_free_range = std::max(statistics.largest_free_range, free_list->getLargestFreeRange());
+            free_list_free_bytes += m_size - used_bytes;
+        }
+    }
+
+    /* DeviceAllocator */
+
+    DeviceAllocator::DeviceAllocator(vk::SharedDevice device, const GPU& gpu, const vk::DeviceSize block_size)
+        : m_device{ std::move(device) },
+          m_gpu{ gpu },
+          m_block_size{ block_size },
+          m_buffer_image_granularity{ gpu.getProperties().limits.bufferImageGranularity },
+          m_non_coherent_atom_size{ gpu.getProperties().limits.nonCoherentAtomSize }
+    {
+        // Small heaps, e.g., the 256 MiB host-visible device-local heap without resizable BAR, must still fit blocks
+        const auto& memory_properties{ m_gpu.getMemoryProperties() };
+        for (std::uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i)
+            m_block_size = std::min(m_block_size, memory_properties.memoryHeaps[i].size / 8);
+    }
+
+    Allocation DeviceAllocator::allocate(const vk::MemoryRequirements& requirements,
+                                         const vk::MemoryPropertyFlags properties,
+                                         ResourceKind kind)
+    {
+        const auto memory_type{ m_gpu.findMemoryType(requirements.memoryTypeBits, properties) };
+
+        // Linear and optimal resources share blocks only when the granularity cannot cause aliasing between them
+        if (m_buffer_image_granularity <= 1)
+            kind = ResourceKind::Linear;
+
+        const std::scoped_lock lock{ m_mutex };
+        for (const auto& block : m_blocks) {
+            if (block->getStrategy() == Strategy::FreeList
+                && block->getMemoryType() == memory_type
+                && block->getKind() == kind) {
+                if (const auto allocation{ block->allocate(requirements) })
+                    return *allocation;
+            }
+        }
+
+        // Large resources get a block of their own rather than leaving most of a shared block unusable
+        const auto min_alignment{ getMinAlignment(memory_type) };
+        const auto required_size{ alignUp(requirements.size, std::max(requirements.alignment, min_alignment)) };
+        const auto block_size{ required_size > m_block_size / 2 ? required_size : m_block_size };
+        return addBlock(memory_type, block_size, Strategy::FreeList, kind).allocate(requirements).value();
+    }
+
+    void DeviceAllocator::free(const Allocation& allocation)
+    {
+        if (!allocation.isValid())
+            return;
+
+        // The lock is held throughout, so a block emptied here cannot be released by another thread in between
+        const std::scoped_lock lock{ m_mutex };
+        auto* block{ allocation.block };
+        block->free(allocation);
+
+        // Release empty free-list blocks, keeping one per memory type and kind to avoid churn at the boundary
+        if (block->getStrategy() != Strategy::FreeList || !block->isEmpty())
+            return;
+
+        const auto siblings{ std::ranges::count_if(m_blocks, [block](const auto& other) {
+            return other->getStrategy() == Strategy::FreeList
+                && other->getMemoryType() == block->getMemoryType()
+                && other->getKind() == block->getKind();
+        }) };
+        if (siblings > 1 || block->getSize() > m_block_size)
+            std::erase_if(m_blocks, [block](const auto& other) { return other.get() == block; });
+    }
+
+    AllocatedBuffer DeviceAllocator::createBuffer(const vk::BufferCreateInfo& create_info,
+                                                  const vk::MemoryPropertyFlags properties)
+    {
+        vk::SharedBuffer buffer{ m_device->createBuffer(create_info), m_device };
+        const auto allocation{
+            allocate(m_device->getBufferMemoryRequirements(buffer.get()), properties, ResourceKind::Linear)
+        };
+        m_device->bindBufferMemory(buffer.get(), allocation.memory, allocation.offset);
+        return { *this, std::move(buffer), allocation };
+    }
+
+    AllocatedImage DeviceAllocator::createImage(const vk::ImageCreateInfo& create_info,
+                                                const vk::MemoryPropertyFlags properties)
+    {
+        vk::SharedImage image{ m_device->createImage(create_info), m_device };
+        const auto kind{
+            create_info.tiling == vk::ImageTiling::eLinear ? ResourceKind::Linear : ResourceKind::Optimal
+        };
+        const auto allocation{ allocate(m_device->getImageMemoryRequirements(image.get()), properties, kind) };
+        m_device->bindImageMemory(image.get(), allocation.memory, allocation.offset);
+        return { *this, std::move(image), allocation };
+    }
+
+    MemoryBlock& DeviceAllocator::createLinearBlock(const vk::DeviceSize capacity,
+                                                    const std::uint32_t memory_type_bits,
+                                                    const vk::MemoryPropertyFlags properties,
+                                                    const ResourceKind kind)
+    {
+        const auto memory_type{ m_gpu.findMemoryType(memory_type_bits, properties) };
+        const std::scoped_lock lock{ m_mutex };
+        return addBlock(memory_type, capacity, Strategy::Linear, kind);
+    }
+
+    MemoryBlock& DeviceAllocator::createPoolBlock(const vk::DeviceSize slot_size,
+                                                  const std::uint32_t slot_count,
+                                                  const std::uint32_t memory_type_bits,
+                                                  const vk::MemoryPropertyFlags properties,
+                                                  const ResourceKind kind)
+    {
+        const auto memory_type{ m_gpu.findMemoryType(memory_type_bits, properties) };
+        const auto aligned_slot_size{ alignUp(slot_size, getMinAlignment(memory_type)) };
+        const std::scoped_lock lock{ m_mutex };
+        return addBlock(memory_type, aligned_slot_size * slot_count, Strategy::Pool, kind, aligned_slot_size);
+    }
+
+    void DeviceAllocator::releaseBlock(const MemoryBlock& block)
+    {
+        const std::scoped_lock lock{ m_mutex };
+        std::erase_if(m_blocks, [&block](const auto& other) { return other.get() == &block; });
+    }
+
+    MemoryStatistics DeviceAllocator::getStatistics() const
+    {
+        MemoryStatistics statistics{ };
+        vk::DeviceSize free_list_free_bytes{ 0 };
+        {
+            const std::scoped_lock lock{ m_mutex };
+            for (const auto& block : m_blocks)
+                block->accumulateStatistics(statistics, free_list_free_bytes);
+        }
+
+        if (free_list_free_bytes > 0) {
+            statistics.fragmentation = 1.0 - static_cast<double>(statistics.largest_free_range)
+                                           / static_cast<double>(free_list_free_bytes);
+        }
+        return statistics;
+    }
+
+    MemoryBlock& DeviceAllocator::addBlock(const std::uint32_t memory_type,
+                                           const vk::DeviceSize size,
+                                           const Strategy strategy,
+                                           const ResourceKind kind,
+                                           const vk::DeviceSize slot_size)
+    {
+        const auto flags{ m_gpu.getMemoryProperties().memoryTypes[memory_type].propertyFlags };
+        return *m_blocks.emplace_back(std::make_unique<MemoryBlock>(m_device,
+                                                                    memory_type,
+                                                                    size,
+                                                                    static_cast<bool>(flags & vk::MemoryPropertyFlagBits::eHostVisible),
+                                                                    getMinAlignment(memory_type),
+                                                                    strategy,
+                                                                    kind,
+                                                                    slot_size));
+    }
+
+    vk::DeviceSize DeviceAllocator::getMinAlignment(const std::uint32_t memory_type) const
+    {
+        // Flushes and invalidates of non-coherent memory operate on whole atoms, so allocations must not share one
+        const auto flags{ m_gpu.getMemoryProperties().memoryTypes[memory_type].propertyFlags };
+        if ((flags & vk::MemoryPropertyFlagBits::eHostVisible) && !(flags & vk::MemoryPropertyFlagBits::eHostCoherent))
+            return m_non_coherent_atom_size;
+        return 1;
+    }
+}
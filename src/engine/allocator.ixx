@@ -0,0 +1,426 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+export module allocator;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import gpu;
+
+namespace eng::mem {
+    /**
+     * The size of each general-purpose device memory block. Resources larger than half a block receive
+     * a block of their own.
+     */
+    export constexpr vk::DeviceSize DEFAULT_BLOCK_SIZE{ 64ull * 1024 * 1024 };
+
+    /**
+     * How a block hands out its memory
+     */
+    export enum class Strategy
+    {
+        Linear,     // Bump allocation, freed all at once by reset, e.g., per-frame transient data
+        Pool,       // Fixed-size slots, e.g., many same-sized uniform or staging buffers
+        FreeList,   // Arbitrary sizes with coalescing on free, for general long-lived resources
+    };
+
+    /**
+     * The two resource classes which bufferImageGranularity requires to be kept apart within one allocation
+     */
+    export enum class ResourceKind
+    {
+        Linear,     // Buffers and linearly tiled images
+        Optimal,    // Optimally tiled images
+    };
+
+    export class MemoryBlock;
+
+    /**
+     * A sub-range of a device memory block bound to one resource
+     */
+    export struct Allocation
+    {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset{ 0 };
+        vk::DeviceSize size{ 0 };
+        std::byte* mapped{ nullptr };   // Null unless the memory type is host-visible
+        MemoryBlock* block{ nullptr };
+
+        [[nodiscard]] bool isValid() const
+        { return block != nullptr; }
+    };
+
+    export struct MemoryStatistics
+    {
+        std::uint32_t block_count{ 0 };         // Device memory allocations, each counting towards maxMemoryAllocationCount
+        std::uint32_t allocation_count{ 0 };    // Live sub-allocations across all blocks
+        vk::DeviceSize reserved_bytes{ 0 };     // Total size of all blocks
+        vk::DeviceSize used_bytes{ 0 };         // Bytes held by live sub-allocations, including alignment padding
+        vk::DeviceSize largest_free_range{ 0 }; // Largest contiguous free range in any free-list block
+        double fragmentation{ 0.0 };            // 1 - largest free range / free bytes, over free-list blocks only
+    };
+
+    /* Sub-Allocation Strategies */
+
+    // Bump allocator over a single range, individual frees only adjust the live count
+    class LinearRange
+    {
+    public:
+        explicit LinearRange(const vk::DeviceSize capacity)
+            : m_capacity{ capacity }
+        {}
+
+        [[nodiscard]] std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+        void free(vk::DeviceSize offset);
+        void reset();
+
+        [[nodiscard]] vk::DeviceSize getUsedBytes() const
+        { return m_head; }
+
+        [[nodiscard]] vk::DeviceSize getLargestFreeRange() const
+        { return m_capacity - m_head; }
+
+    private:
+        vk::DeviceSize m_capacity;
+        vk::DeviceSize m_head{ 0 };
+    };
+
+    // Fixed-size slots, any request no larger than a slot whose alignment divides the slot size is accepted
+    class PoolRange
+    {
+    public:
+        PoolRange(vk::DeviceSize slot_size, std::uint32_t slot_count);
+
+        [[nodiscard]] std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+        void free(vk::DeviceSize offset);
+        void reset();
+
+        [[nodiscard]] vk::DeviceSize getUsedBytes() const
+        { return (m_slot_count - m_free_slots.size()) * m_slot_size; }
+
+        [[nodiscard]] vk::DeviceSize getLargestFreeRange() const
+        { return m_free_slots.empty() ? 0 : m_slot_size; }
+
+    private:
+        vk::DeviceSize              m_slot_size;
+        std::uint32_t               m_slot_count;
+        std::vector<std::uint32_t>  m_free_slots;
+    };
+
+    // Best-fit allocator over an ordered set of free ranges, adjacent ranges are merged on free
+    class FreeListRange
+    {
+    public:
+        explicit FreeListRange(vk::DeviceSize capacity);
+
+        [[nodiscard]] std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+        void free(vk::DeviceSize offset);
+        void reset();
+
+        [[nodiscard]] vk::DeviceSize getUsedBytes() const
+        { return m_used_bytes; }
+
+        [[nodiscard]] vk::DeviceSize getLargestFreeRange() const;
+
+    private:
+        vk::DeviceSize                                          m_capacity;
+        vk::DeviceSize                                          m_used_bytes{ 0 };
+        std::map<vk::DeviceSize, vk::DeviceSize>                m_free_ranges;  // Offset to size
+        std::unordered_map<vk::DeviceSize, vk::DeviceSize>      m_allocations;  // Offset to size
+    };
+
+    /**
+     * A single device memory allocation, persistently mapped if host-visible, which is sub-allocated with one
+     * strategy. Safe to use from multiple threads.
+     */
+    export class MemoryBlock
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Allocates the block's device memory
+         * @param device the logical device which will own the memory
+         * @param memory_type the index of the memory type to allocate from
+         * @param size the size of the block in bytes
+         * @param host_visible whether the memory type is host-visible, in which case the block is mapped
+         * @param min_alignment the alignment applied to every sub-allocation, e.g., nonCoherentAtomSize
+         * @param strategy how the block is sub-allocated
+         * @param kind the class of resource held by the block
+         * @param slot_size the slot size of a pool block, ignored by the other strategies
+         */
+        MemoryBlock(const vk::SharedDevice& device,
+                    std::uint32_t memory_type,
+                    vk::DeviceSize size,
+                    bool host_visible,
+                    vk::DeviceSize min_alignment,
+                    Strategy strategy,
+                    ResourceKind kind,
+                    vk::DeviceSize slot_size = 0);
+
+        MemoryBlock(const MemoryBlock&) = delete;
+        MemoryBlock& operator=(const MemoryBlock&) = delete;
+
+        /* Allocation Methods */
+
+        /**
+         * Sub-allocates a range satisfying the resource's requirements
+         * @param requirements the memory requirements of the resource
+         * @return the allocation, or std::nullopt if the block has no suitable free range
+         * @throws std::invalid_argument if the block's memory type is not permitted by the requirements
+         */
+        [[nodiscard]] std::optional<Allocation> allocate(const vk::MemoryRequirements& requirements);
+
+        void free(const Allocation& allocation);
+
+        // Releases every sub-allocation at once, the resources bound to them must no longer be in use
+        void reset();
+
+        /* Accessors */
+
+        [[nodiscard]] std::uint32_t getMemoryType() const
+        { return m_memory_type; }
+
+        [[nodiscard]] vk::DeviceSize getSize() const
+        { return m_size; }
+
+        [[nodiscard]] Strategy getStrategy() const
+        { return m_strategy; }
+
+        [[nodiscard]] ResourceKind getKind() const
+        { return m_kind; }
+
+        [[nodiscard]] bool isEmpty() const;
+
+        // Adds this block's usage to the statistics
+        void accumulateStatistics(MemoryStatistics& statistics, vk::DeviceSize& free_list_free_bytes) const;
+
+    private:
+        /* Data Members */
+
+        vk::SharedDeviceMemory  m_memory;
+        std::uint32_t           m_memory_type;
+        vk::DeviceSize          m_size;
+        vk::DeviceSize          m_min_alignment;
+        Strategy                m_strategy;
+        ResourceKind            m_kind;
+        std::byte*              m_mapped{ nullptr };
+
+        mutable std::mutex                                      m_mutex;
+        std::variant<LinearRange, PoolRange, FreeListRange>     m_ranges;
+        std::uint32_t                                           m_allocation_count{ 0 };
+    };
+
+    export template <typename Handle>
+    class AllocatedResource;
+
+    export using AllocatedBuffer = AllocatedResource<vk::SharedBuffer>;
+    export using AllocatedImage = AllocatedResource<vk::SharedImage>;
+
+    /**
+     * Sub-allocates buffers and images from large device memory blocks, so the number of device allocations stays
+     * far below maxMemoryAllocationCount regardless of the resource count. Safe to use from multiple threads.
+     */
+    export class DeviceAllocator
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates an allocator with no blocks, memory is reserved on the first allocation of each memory type
+         * @param device the logical device which will own the memory
+         * @param gpu the GPU the device was created from, its memory types and limits are captured once
+         * @param block_size the size of general-purpose blocks, clamped to an eighth of the smallest heap
+         */
+        DeviceAllocator(vk::SharedDevice device, const GPU& gpu, vk::DeviceSize block_size = DEFAULT_BLOCK_SIZE);
+
+        DeviceAllocator(const DeviceAllocator&) = delete;
+        DeviceAllocator& operator=(const DeviceAllocator&) = delete;
+
+        /* General Allocation Methods */
+
+        /**
+         * Sub-allocates memory from a free-list block, reserving a new block if none has room
+         * @param requirements the memory requirements of the resource
+         * @param properties the property flags the memory type must support
+         * @param kind the class of the resource, used to honor bufferImageGranularity
+         * @return the allocation, to be returned with free once the resource is destroyed
+         * @throws std::runtime_error if no memory type satisfies the requirements
+         */
+        [[nodiscard]] Allocation allocate(const vk::MemoryRequirements& requirements,
+                                          vk::MemoryPropertyFlags properties,
+                                          ResourceKind kind);
+
+        // Returns an allocation made by allocate, or by a block created by this allocator
+        void free(const Allocation& allocation);
+
+        /**
+         * Creates a buffer and binds it to newly sub-allocated memory
+         * @param create_info the buffer creation parameters
+         * @param properties the property flags the memory type must support
+         * @return the buffer, which returns its memory to the allocator on destruction
+         */
+        [[nodiscard]] AllocatedBuffer createBuffer(const vk::BufferCreateInfo& create_info,
+                                                   vk::MemoryPropertyFlags properties);
+
+        /**
+         * Creates an image and binds it to newly sub-allocated memory
+         * @param create_info the image creation parameters
+         * @param properties the property flags the memory type must support
+         * @return the image, which returns its memory to the allocator on destruction
+         */
+        [[nodiscard]] AllocatedImage createImage(const vk::ImageCreateInfo& create_info,
+                                                 vk::MemoryPropertyFlags properties);
+
+        /* Dedicated Block Methods */
+
+        /**
+         * Reserves a block for bump allocation, e.g., one per frame in flight which is reset once its frame retires.
+         * All resources placed in the block must be of the passed-in kind.
+         * @param capacity the size of the block in bytes
+         * @param memory_type_bits the memory types permitted for the resources which will be placed in the block
+         * @param properties the property flags the memory type must support
+         * @param kind the class of resource held by the block
+         * @return the block, owned by the allocator until released
+         */
+        [[nodiscard]] MemoryBlock& createLinearBlock(vk::DeviceSize capacity,
+                                                     std::uint32_t memory_type_bits,
+                                                     vk::MemoryPropertyFlags properties,
+                                                     ResourceKind kind = ResourceKind::Linear);
+
+        /**
+         * Reserves a block of fixed-size slots
+         * @param slot_size the size of each slot, rounded up to the block's minimum alignment
+         * @param slot_count the number of slots
+         * @param memory_type_bits the memory types permitted for the resources which will be placed in the block
+         * @param properties the property flags the memory type must support
+         * @param kind the class of resource held by the block
+         * @return the block, owned by the allocator until released
+         */
+        [[nodiscard]] MemoryBlock& createPoolBlock(vk::DeviceSize slot_size,
+                                                   std::uint32_t slot_count,
+                                                   std::uint32_t memory_type_bits,
+                                                   vk::MemoryPropertyFlags properties,
+                                                   ResourceKind kind = ResourceKind::Linear);
+
+        // Frees a block created by createLinearBlock or createPoolBlock, its resources must already be destroyed
+        void releaseBlock(const MemoryBlock& block);
+
+        /* Statistics Methods */
+
+        [[nodiscard]] MemoryStatistics getStatistics() const;
+
+        /* Accessors */
+
+        [[nodiscard]] const vk::SharedDevice& getDevice() const
+        { return m_device; }
+
+    private:
+        /* Data Members */
+
+        vk::SharedDevice                            m_device;
+        GPU                                         m_gpu;
+        vk::DeviceSize                              m_block_size;
+        vk::DeviceSize                              m_buffer_image_granularity;
+        vk::DeviceSize                              m_non_coherent_atom_size;
+
+        mutable std::mutex                          m_mutex;
+        std::vector<std::unique_ptr<MemoryBlock>>   m_blocks;
+
+        /* Helper Methods */
+
+        // Creates and registers a block, the caller must hold the mutex
+        [[nodiscard]] MemoryBlock& addBlock(std::uint32_t memory_type,
+                                            vk::DeviceSize size,
+                                            Strategy strategy,
+                                            ResourceKind kind,
+                                            vk::DeviceSize slot_size = 0);
+
+        [[nodiscard]] vk::DeviceSize getMinAlignment(std::uint32_t memory_type) const;
+    };
+
+    /**
+     * Owns a buffer or image together with its sub-allocation, returning the memory to the allocator once
+     * the resource is destroyed. The allocator must outlive the resource.
+     * @tparam Handle the shared handle type of the resource
+     */
+    export template <typename Handle>
+    class AllocatedResource
+    {
+    public:
+        /* Constructors */
+
+        AllocatedResource() = default;
+
+        AllocatedResource(DeviceAllocator& allocator, Handle handle, const Allocation& allocation)
+            : m_allocator{ &allocator },
+              m_allocation{ allocation },
+              m_handle{ std::move(handle) }
+        {}
+
+        AllocatedResource(const AllocatedResource&) = delete;
+        AllocatedResource& operator=(const AllocatedResource&) = delete;
+
+        AllocatedResource(AllocatedResource&& other) noexcept
+            : m_allocator{ std::exchange(other.m_allocator, nullptr) },
+              m_allocation{ std::exchange(other.m_allocation, {}) },
+              m_handle{ std::move(other.m_handle) }
+        {}
+
+        AllocatedResource& operator=(AllocatedResource&& other) noexcept
+        {
+            if (this != &other) {
+                release();
+                m_allocator = std::exchange(other.m_allocator, nullptr);
+                m_allocation = std::exchange(other.m_allocation, {});
+                m_handle = std::move(other.m_handle);
+            }
+            return *this;
+        }
+
+        /* Destructor */
+
+        ~AllocatedResource()
+        { release(); }
+
+        /* Accessors */
+
+        [[nodiscard]] const Handle& get() const
+        { return m_handle; }
+
+        [[nodiscard]] const Allocation& getAllocation() const
+        { return m_allocation; }
+
+        // Returns the host address of the resource's memory, or null if it is not host-visible
+        [[nodiscard]] std::byte* getMapped() const
+        { return m_allocation.mapped; }
+
+    private:
+        /* Data Members */
+
+        DeviceAllocator*    m_allocator{ nullptr };
+        Allocation          m_allocation;
+        Handle              m_handle;
+
+        // Destroys the resource before its memory is handed back for reuse
+        void release()
+        {
+            m_handle.reset();
+            if (m_allocator)
+                m_allocator->free(m_allocation);
+            m_allocator = nullptr;
+        }
+    };
+}
@@ -0,0 +1,352 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+module capture;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::capture {
+    namespace {
+        constexpr vk::DeviceSize BYTES_PER_PIXEL{ 4 };
+
+        // The largest block a stored (uncompressed) deflate block may hold
+        constexpr std::size_t MAX_STORED_BLOCK{ 65535 };
+
+        [[nodiscard]] bool isSupportedFormat(const vk::Format format)
+        {
+            switch (format) {
+                case vk::Format::eR8G8B8A8Unorm:
+                case vk::Format::eR8G8B8A8Srgb:
+                case vk::Format::eB8G8R8A8Unorm:
+                case vk::Format::eB8G8R8A8Srgb:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        [[nodiscard]] bool isBGRA(const vk::Format format)
+        {
+            return format == vk::Format::eB8G8R8A8Unorm || format == vk::Format::eB8G8R8A8Srgb;
+        }
+
+        [[nodiscard]] constexpr std::array<std::uint32_t, 256> makeCrcTable()
+        {
+            std::array<std::uint32_t, 256> table{ };
+            for (std::uint32_t i = 0; i < table.size(); ++i) {
+                std::uint32_t crc{ i };
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = crc & 1u ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+                table[i] = crc;
+            }
+            return table;
+        }
+        constexpr auto CRC_TABLE{ makeCrcTable() };
+
+        [[nodiscard]] std::uint32_t updateCrc(std::uint32_t crc, const std::span<const std::uint8_t> bytes)
+        {
+            for (const auto byte : bytes)
+                crc = CRC_TABLE[(crc ^ byte) & 0xFFu] ^ (crc >> 8);
+            return crc;
+        }
+
+        void appendBigEndian(std::vector<std::uint8_t>& bytes, const std::uint32_t value)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                bytes.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+
+        void writeChunk(std::ofstream& file, const std::string_view type, const std::span<const std::uint8_t> data)
+        {
+            std::vector<std::uint8_t> header;
+            appendBigEndian(header, static_cast<std::uint32_t>(data.size()));
+            header.insert(header.end(), type.begin(), type.end());
+
+            auto crc{ updateCrc(0xFFFFFFFFu, std::span{ header }.subspan(4)) };
+            crc = updateCrc(crc, data) ^ 0xFFFFFFFFu;
+            std::vector<std::uint8_t> footer;
+            appendBigEndian(footer, crc);
+
+            file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+        }
+
+        /**
+         * Writes an 8-bit RGBA PNG whose image data is stored in uncompressed deflate blocks, trading file size for
+         * an encoder with no dependencies which keeps up with the render loop
+         */
+        void writePng(const std::filesystem::path& path,
+                      const std::span<const std::byte> pixels,
+                      const vk::Extent2D& extent,
+                      const bool bgra)
+        {
+            std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+            if (!file)
+                throw std::runtime_error(std::format("failed to open {} for writing", path.string()));
+
+            constexpr std::array<std::uint8_t, 8> signature{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            file.write(reinterpret_cast<const char*>(signature.data()), signature.size());
+
+            std::vector<std::uint8_t> header;
+            appendBigEndian(header, extent.width);
+            appendBigEndian(header, extent.height);
+            header.insert(header.end(), { 8, 6, 0, 0, 0 });    // 8-bit RGBA, deflate, no filtering, no interlacing
+            writeChunk(file, "IHDR", header);
+
+            // Each row is preceded by its filter type, none, and the channels are reordered to RGBA
+            const std::size_t row_size{ extent.width * BYTES_PER_PIXEL };
+            std::vector<std::uint8_t> scanlines;
+            scanlines.reserve((row_size + 1) * extent.height);
+            for (std::uint32_t y = 0; y < extent.height; ++y) {
+                scanlines.push_back(0);
+                const auto row{ pixels.subspan(y * row_size, row_size) };
+                for (std::size_t x = 0; x < row_size; x += BYTES_PER_PIXEL) {
+                    const auto channel = [&](const std::size_t i) { return std::to_integer<std::uint8_t>(row[x + i]); };
+                    scanlines.insert(scanlines.end(), {
+                        channel(bgra ? 2 : 0), channel(1), channel(bgra ? 0 : 2), channel(3)
+                    });
+                }
+            }
+
+            // Wrap the scanlines in a zlib stream of stored blocks, followed by their Adler-32 checksum
+            std::vector<std::uint8_t> zlib{ 0x78, 0x01 };
+            zlib.reserve(scanlines.size() + scanlines.size() / MAX_STORED_BLOCK * 5 + 16);
+            std::uint32_t adler_a{ 1 }, adler_b{ 0 };
+            for (std::size_t offset = 0; offset < scanlines.size() || offset == 0; offset += MAX_STORED_BLOCK) {
+                const auto length{ static_cast<std::uint16_t>(std::min(MAX_STORED_BLOCK, scanlines.size() - offset)) };
+                const bool final_block{ offset + length >= scanlines.size() };
+                zlib.insert(zlib.end(), {
+                    static_cast<std::uint8_t>(final_block ? 1 : 0),
+                    static_cast<std::uint8_t>(length), static_cast<std::uint8_t>(length >> 8),
+                    static_cast<std::uint8_t>(~length), static_cast<std::uint8_t>(~length >> 8)
+                });
+                for (std::size_t i = offset; i < offset + length; ++i) {
+                    adler_a = (adler_a + scanlines[i]) % 65521u;
+                    adler_b = (adler_b + adler_a) % 65521u;
+                }
+                zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + length);
+                if (final_block)
+                    break;
+            }
+            appendBigEndian(zlib, adler_b << 16 | adler_a);
+            writeChunk(file, "IDAT", zlib);
+            writeChunk(file, "IEND", {});
+        }
+    }
+
+    FrameCapture::FrameCapture(mem::DeviceAllocator& allocator,
+                               const vk::Format color_format,
+                               const vk::Extent2D& max_extent,
+                               CaptureConfig config)
+        : m_config{ std::move(config) },
+          m_color_format{ color_format },
+          m_slot_size{ static_cast<vk::DeviceSize>(max_extent.width) * max_extent.height * BYTES_PER_PIXEL }
+    {
+        if (!isSupportedFormat(color_format))
+            throw std::invalid_argument("frame capture requires a render target with four 8-bit channels");
+        if (m_config.readback_buffers == 0 || m_slot_size == 0)
+            throw std::invalid_argument("frame capture requires at least one readback buffer and a non-empty extent");
+
+        // Open the outputs up front, so a bad path fails on the caller's thread
+        std::filesystem::path timestamps_path;
+        if (m_config.format == CaptureFormat::Stream) {
+            m_stream.open(m_config.output, std::ios::binary | std::ios::trunc);
+            if (!m_stream)
+                throw std::runtime_error(std::format("failed to open capture stream {}", m_config.output.string()));
+            timestamps_path = std::filesystem::path{ m_config.output }.concat(".csv");
+        } else {
+            std::filesystem::create_directories(m_config.output);
+            timestamps_path = m_config.output / "timestamps.csv";
+        }
+        m_timestamps.open(timestamps_path, std::ios::trunc);
+        if (!m_timestamps)
+            throw std::runtime_error(std::format("failed to open capture timestamps {}", timestamps_path.string()));
+        m_timestamps << "frame,submitted_ns,width,height\n";
+
+        // Host-visible and coherent, so the capture thread reads the pixels without an invalidation
+        m_slots.resize(m_config.readback_buffers);
+        for (std::uint32_t i = 0; i < m_slots.size(); ++i) {
+            m_slots[i].buffer = allocator.createBuffer(vk::BufferCreateInfo()
+                .setSize( m_slot_size )
+                .setUsage( vk::BufferUsageFlagBits::eTransferDst )
+                .setSharingMode( vk::SharingMode::eExclusive ),
+                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+            dbg::setObjectName(allocator.getDevice(), m_slots[i].buffer.get().get(), "capture readback {}", i);
+            m_free.push_back(i);
+        }
+
+        m_thread = std::jthread{ [this](const std::stop_token& stop_token) { captureLoop(stop_token); } };
+    }
+
+    FrameCapture::~FrameCapture()
+    {
+        m_thread.request_stop();
+    }
+
+    bool FrameCapture::recordCopy(const vk::CommandBuffer& command_buffer,
+                                  const vk::Image image,
+                                  const vk::Extent2D& extent,
+                                  const std::uint64_t frame_number)
+    {
+        std::uint32_t slot_index;
+        {
+            std::unique_lock lock{ m_mutex };
+            if (static_cast<vk::DeviceSize>(extent.width) * extent.height * BYTES_PER_PIXEL > m_slot_size
+                || (m_free.empty() && m_config.drop_when_full)) {
+                ++m_statistics.dropped;
+                return false;
+            }
+
+            // Only a buffer queued for or being written can be freed without a submission completing
+            if (m_free.empty()) {
+                ++m_statistics.stalls;
+                m_slot_ready.wait(lock, [this] { return !m_free.empty() || (m_ready.empty() && !m_writing); });
+                if (m_free.empty()) {
+                    ++m_statistics.dropped;
+                    return false;
+                }
+            }
+            slot_index = m_free.front();
+            m_free.pop_front();
+            ++m_statistics.captured;
+        }
+
+        auto& slot{ m_slots[slot_index] };
+        slot.extent = extent;
+        slot.frame_number = frame_number;
+        slot.timeline_value = 0;
+        m_in_flight.push_back(slot_index);
+
+        const auto region = vk::BufferImageCopy()
+            .setBufferOffset( 0 )
+            .setBufferRowLength( 0 )
+            .setBufferImageHeight( 0 )
+            .setImageSubresource({ vk::ImageAspectFlagBits::eColor, 0, 0, 1 })
+            .setImageExtent({ extent.width, extent.height, 1 });
+        command_buffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, slot.buffer.get(), region);
+        return true;
+    }
+
+    void FrameCapture::markSubmitted(const std::uint64_t timeline_value)
+    {
+        const auto submitted_at{
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start) };
+        for (const auto slot_index : m_in_flight) {
+            if (auto& slot{ m_slots[slot_index] }; slot.timeline_value == 0) {
+                slot.timeline_value = timeline_value;
+                slot.submitted_at = submitted_at;
+            }
+        }
+    }
+
+    void FrameCapture::poll(const std::uint64_t completed_value)
+    {
+        // Submissions complete in order, so only the oldest copies need checking
+        std::size_t completed{ 0 };
+        while (completed < m_in_flight.size()) {
+            const auto& slot{ m_slots[m_in_flight[completed]] };
+            if (slot.timeline_value == 0 || slot.timeline_value > completed_value)
+                break;
+            ++completed;
+        }
+        if (completed == 0)
+            return;
+
+        {
+            const std::scoped_lock lock{ m_mutex };
+            m_ready.insert(m_ready.end(), m_in_flight.begin(), m_in_flight.begin() + static_cast<std::ptrdiff_t>(completed));
+        }
+        m_in_flight.erase(m_in_flight.begin(), m_in_flight.begin() + static_cast<std::ptrdiff_t>(completed));
+        m_slot_ready.notify_all();
+    }
+
+    CaptureStatistics FrameCapture::finish()
+    {
+        m_thread.request_stop();
+        if (m_thread.joinable())
+            m_thread.join();
+        return getStatistics();
+    }
+
+    CaptureStatistics FrameCapture::getStatistics() const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        return m_statistics;
+    }
+
+    void FrameCapture::captureLoop(const std::stop_token& stop_token)
+    {
+        while (true) {
+            std::uint32_t slot_index;
+            {
+                std::unique_lock lock{ m_mutex };
+                m_slot_ready.wait(lock, stop_token, [this] { return !m_ready.empty(); });
+                if (m_ready.empty())
+                    return;     // Stopped with nothing left to write
+                slot_index = m_ready.front();
+                m_ready.pop_front();
+                m_writing = true;
+            }
+
+            // A failed write loses the frame, but must not take down the render loop
+            bool written{ true };
+            try {
+                writeFrame(m_slots[slot_index]);
+            } catch (const std::exception&) {
+                written = false;
+            }
+
+            {
+                const std::scoped_lock lock{ m_mutex };
+                m_free.push_back(slot_index);
+                m_writing = false;
+                ++(written ? m_statistics.written : m_statistics.dropped);
+            }
+            m_slot_ready.notify_all();
+        }
+    }
+
+    void FrameCapture::writeFrame(const ReadbackSlot& slot)
+    {
+        const auto& [ width, height ]{ slot.extent };
+        const std::span pixels{ slot.buffer.getMapped(), static_cast<std::size_t>(width) * height * BYTES_PER_PIXEL };
+        switch (m_config.format) {
+            case CaptureFormat::Raw: {
+                const auto path{ m_config.output / std::format("frame_{:08}.raw", slot.frame_number) };
+                std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+                if (!file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size())))
+                    throw std::runtime_error(std::format("failed to write {}", path.string()));
+                break;
+            }
+            case CaptureFormat::Png:
+                writePng(m_config.output / std::format("frame_{:08}.png", slot.frame_number),
+                         pixels,
+                         slot.extent,
+                         isBGRA(m_color_format));
+                break;
+            case CaptureFormat::Stream:
+                if (!m_stream.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size())))
+                    throw std::runtime_error("failed to write to capture stream");
+                break;
+        }
+        m_timestamps << std::format("{},{},{},{}\n", slot.frame_number, slot.submitted_at.count(), width, height);
+    }
+}
@@ -0,0 +1,165 @@
+module;
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+export module capture;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+
+namespace eng::capture {
+    /**
+     * How captured frames are written by the capture thread
+     */
+    export enum class CaptureFormat : std::uint8_t
+    {
+        Raw,        // One file per frame holding the tightly packed pixels, in the render target's channel order
+        Png,        // One uncompressed RGBA PNG per frame, for golden-image comparisons
+        Stream      // Every frame's raw pixels appended to a single file or named pipe, e.g., for a video encoder
+    };
+
+    export struct CaptureConfig
+    {
+        std::filesystem::path output;           // The directory frames are written to, or the file or pipe streamed to
+        CaptureFormat format{ CaptureFormat::Png };
+        std::uint32_t readback_buffers{ 4 };    // The depth of the readback ring
+        bool drop_when_full{ true };            // Skip frames rather than stall rendering when every buffer is busy
+    };
+
+    export struct CaptureStatistics
+    {
+        std::uint64_t captured{ 0 };    // Frames copied into a readback buffer
+        std::uint64_t written{ 0 };     // Frames written out by the capture thread
+        std::uint64_t dropped{ 0 };     // Frames skipped because every readback buffer was busy, or too large
+        std::uint64_t stalls{ 0 };      // Frames which waited for a readback buffer, only when not dropping
+    };
+
+    /**
+     * Copies rendered frames into a ring of persistently mapped, host-visible readback buffers, and writes them out
+     * on a background thread, so capturing costs the render loop one copy command per frame. A buffer is handed to
+     * the capture thread once the graphics timeline passes the frame which filled it, and returns to the ring once
+     * written. Each written frame is listed with its frame number, extent and submission time in a CSV file
+     * alongside the output.
+     */
+    export class FrameCapture
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the readback ring and starts the capture thread
+         * @param allocator the allocator the readback buffers are sub-allocated from, must outlive the capture
+         * @param color_format the format of the captured render targets, must have four 8-bit channels
+         * @param max_extent the largest extent captured, larger frames are dropped
+         * @param config the output and readback ring configuration
+         * @throws std::invalid_argument if the format is not supported or the ring is empty
+         * @throws std::runtime_error if the output cannot be opened
+         */
+        FrameCapture(mem::DeviceAllocator& allocator,
+                     vk::Format color_format,
+                     const vk::Extent2D& max_extent,
+                     CaptureConfig config);
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        /* Destructor */
+
+        // Writes out the frames already handed to the capture thread, every submitted copy must have completed
+        ~FrameCapture();
+
+        /* Frame Methods */
+
+        /**
+         * Records the copy of a frame's render target into a free readback buffer
+         * @param command_buffer the command buffer to record into, must be in the recording state
+         * @param image the render target, in the transfer source layout
+         * @param extent the extent of the render target
+         * @param frame_number the number of the frame, used to name its output
+         * @return true if the copy was recorded, false if the frame was dropped
+         */
+        bool recordCopy(const vk::CommandBuffer& command_buffer,
+                        vk::Image image,
+                        const vk::Extent2D& extent,
+                        std::uint64_t frame_number);
+
+        /**
+         * Associates the copies recorded since the last call with the submission which executes them
+         * @param timeline_value the graphics timeline value signaled once the submission completes
+         */
+        void markSubmitted(std::uint64_t timeline_value);
+
+        /**
+         * Hands the readback buffers of completed submissions to the capture thread
+         * @param completed_value the value the graphics timeline has reached
+         */
+        void poll(std::uint64_t completed_value);
+
+        /**
+         * Stops the capture thread once it has written out every frame handed to it, no further frames may be
+         * captured afterwards
+         * @return the final statistics
+         */
+        CaptureStatistics finish();
+
+        /* Accessors */
+
+        [[nodiscard]] const CaptureConfig& getConfig() const
+        { return m_config; }
+
+        [[nodiscard]] CaptureStatistics getStatistics() const;
+
+    private:
+        /* Data Members */
+
+        struct ReadbackSlot
+        {
+            mem::AllocatedBuffer    buffer;
+            vk::Extent2D            extent;
+            std::uint64_t           frame_number{ 0 };
+            std::uint64_t           timeline_value{ 0 };    // Zero until submitted
+            std::chrono::nanoseconds submitted_at{ 0 };     // Since the capture started
+        };
+
+        CaptureConfig                           m_config;
+        vk::Format                              m_color_format;
+        vk::DeviceSize                          m_slot_size;
+        std::vector<ReadbackSlot>               m_slots;
+        std::deque<std::uint32_t>               m_in_flight;    // Recorded or submitted, oldest first
+        std::chrono::steady_clock::time_point   m_start{ std::chrono::steady_clock::now() };
+
+        // Shared with the capture thread
+        mutable std::mutex                      m_mutex;
+        std::condition_variable_any             m_slot_ready;   // Signaled when a slot is queued or freed
+        std::deque<std::uint32_t>               m_free;
+        std::deque<std::uint32_t>               m_ready;        // Completed copies, awaiting the capture thread
+        bool                                    m_writing{ false };
+        CaptureStatistics                       m_statistics;
+
+        // Only accessed by the capture thread once started
+        std::ofstream                           m_stream;       // The streamed frames, only for CaptureFormat::Stream
+        std::ofstream                           m_timestamps;
+
+        std::jthread                            m_thread;       // Declared last, so it stops before anything it uses
+
+        /* Helper Methods */
+
+        // Writes the queued frames until stopped, draining the queue before returning
+        void captureLoop(const std::stop_token& stop_token);
+
+        void writeFrame(const ReadbackSlot& slot);
+    };
+}
@@ -1,10 +1,43 @@
 module;
 
+#include <array>
+#include <cstdint>
+#include <span>
 #include <stdexcept>
 
 module command;
 
+// Internal Dependencies
+import debug_utils;
+
 namespace eng::cmd {
+    namespace {
+        // Binds the pipeline and sets the dynamic viewport and scissor to cover the render target
+        void bindDrawState(const vk::CommandBuffer& command_buffer,
+                           const vk::Pipeline& graphics_pipeline,
+                           const vk::Extent2D& image_extent)
+        {
+            // Bind the pipeline
+            command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, graphics_pipeline);
+
+            // Dynamically set the viewport
+            const auto viewport = vk::Viewport()
+                .setX( 0.0f )
+                .setY( 0.0f )
+                .setWidth( static_cast<float>(image_extent.width) )
+                .setHeight( static_cast<float>(image_extent.height) )
+                .setMinDepth( 0.0f )
+                .setMaxDepth( 1.0f );
+            command_buffer.setViewport(0, viewport);
+
+            // Dynamically set the scissor rectangle
+            const auto scissor = vk::Rect2D()
+                .setOffset( {0, 0} )
+                .setExtent( image_extent );
+            command_buffer.setScissor(0, scissor);
+        }
+    }
+
     vk::CommandBuffer allocateCommandBuffer(const vk::Device& device,
                                             const vk::CommandPool& command_pool,
                                             const vk::CommandBufferLevel level)
@@ -16,90 +49,134 @@ namespace eng::cmd {
         )[0];
     }
 
-    void recordDrawCommand(const vk::CommandBuffer& command_buffer,
-                           const vk::Pipeline& graphics_pipeline,
-                           const vk::ImageView& target_image_view,
-                           const vk::Image& target_image,
-                           const vk::Extent2D& image_extent)
+    void bindFrameResources(const vk::CommandBuffer& command_buffer,
+                            const FrameBindings& bindings,
+                            const std::span<const vk::PipelineBindPoint> bind_points)
+    {
+        bindings.descriptor_heap->bind(command_buffer, bind_points);
+        bindings.uniform_ring->bind(command_buffer,
+                                    bindings.descriptor_heap->getPipelineLayout().get(),
+                                    bindings.frame_uniforms,
+                                    bind_points);
+    }
+
+    void recordFrame(const vk::CommandBuffer& command_buffer,
+                     const FrameBindings& bindings,
+                     graph::RenderGraph& render_graph,
+                     const vk::QueryPool& timestamp_pool,
+                     const std::uint32_t first_timestamp)
+    {
+        constexpr vk::CommandBufferBeginInfo begin_info{ };
+        if (command_buffer.begin(&begin_info) != vk::Result::eSuccess)
+            throw std::runtime_error("failed to begin command buffer recording");
+
+        // Mark the start of the frame's GPU work
+        if (timestamp_pool) {
+            command_buffer.resetQueryPool(timestamp_pool, first_timestamp, 2);
+            command_buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eNone, timestamp_pool, first_timestamp);
+        }
+
+        {
+            const dbg::ScopedLabel label{ command_buffer, "frame" };
+
+            // Every pass selects its resources through push constants and dynamic offsets, so the sets are bound only once
+            bindFrameResources(command_buffer, bindings);
+
+            // The graph records the passes, the layout transitions of the render target, and the barriers between them
+            render_graph.execute(command_buffer);
+        }
+
+        // Mark the end of the frame's GPU work
+        if (timestamp_pool)
+            command_buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, timestamp_pool, first_timestamp + 1);
+        command_buffer.end();   // Will throw error on failure
+    }
+
+    void recordComputeFrame(const vk::CommandBuffer& command_buffer,
+                            const FrameBindings& bindings,
+                            graph::RenderGraph& render_graph)
     {
         constexpr vk::CommandBufferBeginInfo begin_info{ };
         if (command_buffer.begin(&begin_info) != vk::Result::eSuccess)
             throw std::runtime_error("failed to begin command buffer recording");
 
-        // Manually transition image layout for rendering
-        const auto rendering_image_barrier = vk::ImageMemoryBarrier()
-            .setDstAccessMask( vk::AccessFlagBits::eColorAttachmentWrite )
-            .setOldLayout( vk::ImageLayout::eUndefined )
-            .setNewLayout( vk::ImageLayout::eColorAttachmentOptimal )
-            .setImage( target_image )
-            .setSubresourceRange( vk::ImageSubresourceRange()
-                .setAspectMask(vk::ImageAspectFlagBits::eColor )
-                .setBaseMipLevel( 0 )
-                .setLevelCount( 1 )
-                .setBaseArrayLayer( 0 )
-                .setLayerCount( 1 ) );
-        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-                                       vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                                       vk::DependencyFlags{ },
-                                       {},
-                                       {},
-                                       rendering_image_barrier);
-
-        // Prepare dynamic rendering info
-        const auto color_attachment = vk::RenderingAttachmentInfo()
-            .setImageView( target_image_view )
-            .setImageLayout( vk::ImageLayout::eColorAttachmentOptimal )
-            .setLoadOp( vk::AttachmentLoadOp::eClear )
-            .setStoreOp( vk::AttachmentStoreOp::eStore )
-            .setClearValue( {{0.0f, 0.0f, 0.0f, 1.0f}} );
-
-        const auto rendering_info = vk::RenderingInfo()
-            .setRenderArea( vk::Rect2D{{0, 0}, image_extent} )
-            .setLayerCount( 1 )
-            .setColorAttachments( color_attachment );
-
-        // Bind rendering state and pipeline
-        command_buffer.beginRendering(rendering_info);
-        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, graphics_pipeline);
-
-        // Dynamically set the viewport
-        const auto viewport = vk::Viewport()
-            .setX( 0.0f )
-            .setY( 0.0f )
-            .setWidth( static_cast<float>(image_extent.width) )
-            .setHeight( static_cast<float>(image_extent.height) )
-            .setMinDepth( 0.0f )
-            .setMaxDepth( 1.0f );
-        command_buffer.setViewport(0, viewport);
-
-        // Dynamically set the scissor rectangle
-        const auto scissor = vk::Rect2D()
-            .setOffset( {0, 0} )
-            .setExtent( image_extent );
-        command_buffer.setScissor(0, scissor);
-
-        // Draw call
-        command_buffer.draw(3, 1, 0, 0);
-
-        // Cleanup
-        command_buffer.endRendering();
-        const auto presentation_image_barrier = vk::ImageMemoryBarrier()
-            .setSrcAccessMask( vk::AccessFlagBits::eColorAttachmentWrite )
-            .setOldLayout( vk::ImageLayout::eColorAttachmentOptimal )
-            .setNewLayout( vk::ImageLayout::ePresentSrcKHR )
-            .setImage( target_image )
-            .setSubresourceRange( vk::ImageSubresourceRange()
-                .setAspectMask( vk::ImageAspectFlagBits::eColor )
-                .setBaseMipLevel( 0 )
-                .setLevelCount( 1 )
-                .setBaseArrayLayer( 0 )
-                .setLayerCount( 1 ) );
-        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
-                                       vk::PipelineStageFlagBits::eBottomOfPipe,
-                                       vk::DependencyFlags{ },
-                                       {},
-                                       {},
-                                       presentation_image_barrier);
+        {
+            const dbg::ScopedLabel label{ command_buffer, "compute frame", dbg::COMPUTE_LABEL_COLOR };
+            bindFrameResources(command_buffer, bindings, desc::COMPUTE_BIND_POINTS);
+            render_graph.execute(command_buffer);
+        }
         command_buffer.end();   // Will throw error on failure
     }
+
+    void recordDraws(const vk::CommandBuffer& command_buffer,
+                     const vk::Pipeline& graphics_pipeline,
+                     const desc::DescriptorHeap& descriptor_heap,
+                     const mesh::Mesh& mesh,
+                     const vk::Extent2D& image_extent,
+                     const scene::Scene& scene,
+                     const std::span<const std::uint32_t> draws)
+    {
+        bindDrawState(command_buffer, graphics_pipeline, image_extent);
+
+        // Bind the mesh's vertex and index buffers
+        const std::array vertex_buffers{ mesh.vertex_buffer.get().get() };
+        constexpr std::array<vk::DeviceSize, 1> vertex_offsets{ 0 };
+        command_buffer.bindVertexBuffers(0, vertex_buffers, vertex_offsets);
+        command_buffer.bindIndexBuffer(mesh.index_buffer.get(), 0, vk::IndexType::eUint32);
+
+        // Draw calls, each placing its object through push constants rather than a per-draw descriptor set
+        for (const auto object : draws) {
+            descriptor_heap.pushConstants(command_buffer, DrawConstants{ scene.getTransform(object) });
+            command_buffer.drawIndexed(mesh.index_count, 1, 0, 0, 0);
+        }
+    }
+
+    void recordIndirectDraws(const vk::CommandBuffer& command_buffer,
+                             const vk::Pipeline& graphics_pipeline,
+                             const mesh::Mesh& mesh,
+                             const vk::Extent2D& image_extent,
+                             const cull::CullingPass& culling,
+                             const std::uint32_t frame_index)
+    {
+        bindDrawState(command_buffer, graphics_pipeline, image_extent);
+
+        // Bind the mesh's vertices alongside the objects, whose transforms are read per instance
+        const std::array vertex_buffers{ mesh.vertex_buffer.get().get(), culling.getObjectBuffer() };
+        constexpr std::array<vk::DeviceSize, 2> vertex_offsets{ 0, 0 };
+        command_buffer.bindVertexBuffers(0, vertex_buffers, vertex_offsets);
+        command_buffer.bindIndexBuffer(mesh.index_buffer.get(), 0, vk::IndexType::eUint32);
+
+        // A single draw of every surviving object, with the count read from the buffer the culling pass wrote
+        command_buffer.drawIndexedIndirectCount(culling.getDrawBuffer(frame_index),
+                                                0,
+                                                culling.getCountBuffer(frame_index),
+                                                0,
+                                                culling.getObjectCount(),
+                                                sizeof(vk::DrawIndexedIndirectCommand));
+    }
+
+    void recordSecondaryDraws(const vk::CommandBuffer& command_buffer,
+                              const vk::Format color_format,
+                              const vk::Pipeline& graphics_pipeline,
+                              const FrameBindings& bindings,
+                              const mesh::Mesh& mesh,
+                              const vk::Extent2D& image_extent,
+                              const scene::Scene& scene,
+                              const std::span<const std::uint32_t> draws)
+    {
+        // Describe the rendering scope the draws continue, in place of a render pass and framebuffer
+        const std::array color_formats{ color_format };
+        const auto inheritance_rendering_info = vk::CommandBufferInheritanceRenderingInfo()
+            .setColorAttachmentFormats( color_formats )
+            .setRasterizationSamples( vk::SampleCountFlagBits::e1 );
+        const auto inheritance_info = vk::CommandBufferInheritanceInfo()
+            .setPNext( &inheritance_rendering_info );
+
+        command_buffer.begin(vk::CommandBufferBeginInfo()
+            .setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue )
+            .setPInheritanceInfo( &inheritance_info ));
+        bindFrameResources(command_buffer, bindings);
+        recordDraws(command_buffer, graphics_pipeline, *bindings.descriptor_heap, mesh, image_extent, scene, draws);
+        command_buffer.end();
+    }
 }
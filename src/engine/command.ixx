@@ -1,13 +1,61 @@
 module;
 
 #include <cstdint>
+#include <span>
 
 export module command;
 
 // External Dependencies
+import glm;
 import vulkan_hpp;
 
+// Internal Dependencies
+import culling;
+import descriptor_heap;
+import mesh;
+import render_graph;
+import scene;
+import uniform_ring;
+
 namespace eng::cmd {
+    /**
+     * Describes the amount of geometry submitted per frame
+     */
+    export struct DrawWorkload
+    {
+        std::uint32_t triangle_count{ 1 };  // Triangles in the default mesh, drawn by each draw call
+        std::uint32_t draw_count{ 1 };      // Draw calls per frame
+    };
+
+    /**
+     * The per-frame camera and scene state, read by every vertex shader from the uniform ring's set. Must match
+     * the std140 Frame block in the vertex shaders.
+     */
+    export struct FrameUniforms
+    {
+        glm::mat4 view_projection{ 1.0f };
+        glm::vec4 time{ 0.0f };     // Seconds since the engine started in x, stepped per frame if headless
+    };
+
+    /**
+     * The push constants of each directly recorded draw, must match the push constant block in the vertex shader
+     */
+    export struct DrawConstants
+    {
+        glm::vec4 transform{ 0.0f };    // Offset in xy and uniform scale in z
+    };
+    static_assert(desc::PushConstantBlock<DrawConstants>);
+
+    /**
+     * The descriptor sets bound for the whole frame: the global descriptor heap and the frame's uniforms
+     */
+    export struct FrameBindings
+    {
+        const desc::DescriptorHeap* descriptor_heap{ nullptr };
+        const ubo::UniformRing* uniform_ring{ nullptr };
+        std::uint32_t frame_uniforms{ 0 };  // The dynamic offset of the frame's FrameUniforms
+    };
+
     /* Command Buffer Functions */
 
     export [[nodiscard]] vk::CommandBuffer
@@ -15,10 +63,97 @@ namespace eng::cmd {
                           const vk::CommandPool& command_pool,
                           vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
 
+    // Binds the frame's descriptor sets, for both graphics and compute pipelines by default
+    export void
+    bindFrameResources(const vk::CommandBuffer& command_buffer,
+                       const FrameBindings& bindings,
+                       std::span<const vk::PipelineBindPoint> bind_points = desc::ALL_BIND_POINTS);
+
+    /**
+     * Records the commands to render a frame, binding the frame's descriptor sets once then executing the frame's
+     * render graph
+     * @param command_buffer the command buffer to record into, must be in the initial state
+     * @param bindings the frame's descriptor sets
+     * @param render_graph the compiled render graph, with its render target bound
+     * @param timestamp_pool optional query pool, if provided, timestamps are written at the start and end of the
+     *                       frame's commands into the two queries beginning at first_timestamp
+     * @param first_timestamp the index of the first of the two timestamp queries
+     */
+    export void
+    recordFrame(const vk::CommandBuffer& command_buffer,
+                const FrameBindings& bindings,
+                graph::RenderGraph& render_graph,
+                const vk::QueryPool& timestamp_pool = {},
+                std::uint32_t first_timestamp = 0);
+
+    /**
+     * Records the commands a frame runs on the asynchronous compute queue, binding the frame's descriptor sets
+     * for compute pipelines only, then executing the frame's compute graph
+     * @param command_buffer the command buffer to record into, allocated from a compute family pool and in the
+     *                       initial state
+     * @param bindings the frame's descriptor sets
+     * @param render_graph the compiled compute graph
+     */
+    export void
+    recordComputeFrame(const vk::CommandBuffer& command_buffer,
+                       const FrameBindings& bindings,
+                       graph::RenderGraph& render_graph);
+
+    /**
+     * Records the draw state and one draw call per drawn object, in a primary buffer inside a rendering scope or in
+     * a secondary buffer continuing one, with the frame's descriptor sets bound
+     * @param command_buffer the command buffer to record into, must be in the recording state
+     * @param graphics_pipeline the pipeline used for the draws
+     * @param descriptor_heap the heap whose pipeline layout the object transforms are pushed through
+     * @param mesh the mesh drawn by each draw call
+     * @param image_extent the extent of the render target, used for the viewport and scissor
+     * @param scene the scene whose objects are drawn, each placed by its transform
+     * @param draws the indices of the objects to draw, e.g., those which survived culling
+     */
+    export void
+    recordDraws(const vk::CommandBuffer& command_buffer,
+                const vk::Pipeline& graphics_pipeline,
+                const desc::DescriptorHeap& descriptor_heap,
+                const mesh::Mesh& mesh,
+                const vk::Extent2D& image_extent,
+                const scene::Scene& scene,
+                std::span<const std::uint32_t> draws);
+
+    /**
+     * Records the draw state and one indirect draw of the objects which survived culling, inside a rendering scope
+     * @param command_buffer the command buffer to record into, must be in the recording state
+     * @param graphics_pipeline the pipeline used for the draws, consuming the per-object vertex input
+     * @param mesh the mesh drawn for each object
+     * @param image_extent the extent of the render target, used for the viewport and scissor
+     * @param culling the culling pass whose draw commands and count have been written for the frame slot
+     * @param frame_index the frame slot whose draw commands are read
+     */
+    export void
+    recordIndirectDraws(const vk::CommandBuffer& command_buffer,
+                        const vk::Pipeline& graphics_pipeline,
+                        const mesh::Mesh& mesh,
+                        const vk::Extent2D& image_extent,
+                        const cull::CullingPass& culling,
+                        std::uint32_t frame_index);
+
+    /**
+     * Records a range of draw calls into a secondary command buffer which continues a dynamic rendering scope
+     * @param command_buffer the secondary command buffer to record into, must be in the initial state
+     * @param color_format the color format of the render target the rendering scope writes to
+     * @param graphics_pipeline the pipeline used for the draws
+     * @param bindings the frame's descriptor sets, rebound as secondary command buffers inherit no bindings
+     * @param mesh the mesh drawn by each draw call
+     * @param image_extent the extent of the render target
+     * @param scene the scene whose objects are drawn, each placed by its transform
+     * @param draws the indices of the objects to draw
+     */
     export void
-    recordDrawCommand(const vk::CommandBuffer& command_buffer,
-                      const vk::Pipeline& graphics_pipeline,
-                      const vk::ImageView& target_image_view,
-                      const vk::Image& target_image,
-                      const vk::Extent2D& image_extent);
+    recordSecondaryDraws(const vk::CommandBuffer& command_buffer,
+                         vk::Format color_format,
+                         const vk::Pipeline& graphics_pipeline,
+                         const FrameBindings& bindings,
+                         const mesh::Mesh& mesh,
+                         const vk::Extent2D& image_extent,
+                         const scene::Scene& scene,
+                         std::span<const std::uint32_t> draws);
 }
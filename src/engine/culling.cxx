@@ -0,0 +1,233 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+module culling;
+
+// Internal Dependencies
+import debug_utils;
+import pipeline;
+
+namespace eng::cull {
+    namespace {
+        // Records one half of a queue family ownership transfer of a frame slot's draw commands and count
+        template <typename Frame>
+        void recordOwnershipTransfer(const vk::CommandBuffer& command_buffer,
+                                     const Frame& frame,
+                                     const std::uint32_t src_family,
+                                     const std::uint32_t dst_family,
+                                     const vk::PipelineStageFlags2 src_stages,
+                                     const vk::AccessFlags2 src_access,
+                                     const vk::PipelineStageFlags2 dst_stages,
+                                     const vk::AccessFlags2 dst_access)
+        {
+            if (src_family == dst_family)
+                return;
+
+            std::array<vk::BufferMemoryBarrier2, 2> barriers;
+            for (std::size_t i = 0; i < barriers.size(); ++i) {
+                barriers[i] = vk::BufferMemoryBarrier2()
+                    .setSrcStageMask( src_stages )
+                    .setSrcAccessMask( src_access )
+                    .setDstStageMask( dst_stages )
+                    .setDstAccessMask( dst_access )
+                    .setSrcQueueFamilyIndex( src_family )
+                    .setDstQueueFamilyIndex( dst_family )
+                    .setBuffer( i == 0 ? frame.draw_buffer.get() : frame.count_buffer.get() )
+                    .setOffset( 0 )
+                    .setSize( vk::WholeSize );
+            }
+            command_buffer.pipelineBarrier2(vk::DependencyInfo().setBufferMemoryBarriers( barriers ));
+        }
+    }
+
+    Frustum extractFrustum(const glm::mat4& view_projection)
+    {
+        // Gribb-Hartmann extraction, GLM matrices are column-major so each row is gathered across the columns
+        const auto row = [&view_projection](const int i) {
+            return glm::vec4{ view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i] };
+        };
+        Frustum frustum{
+            row(3) + row(0),    // Left
+            row(3) - row(0),    // Right
+            row(3) + row(1),    // Bottom
+            row(3) - row(1),    // Top
+            row(2),             // Near, as clip space depth starts at zero rather than -w
+            row(3) - row(2)     // Far
+        };
+
+        // Normalize, so the signed distance to a plane can be compared against a sphere's radius
+        for (auto& plane : frustum)
+            plane /= glm::length(glm::vec3{ plane });
+        return frustum;
+    }
+
+    std::vector<ObjectData> createObjectGrid(const std::uint32_t object_count, const float bounding_radius)
+    {
+        const auto columns{ static_cast<std::uint32_t>(std::ceil(std::sqrt(static_cast<double>(object_count)))) };
+        const float cell_size{ 2.0f * GRID_HALF_EXTENT / static_cast<float>(std::max(columns, 1u)) };
+
+        // Scale each object so its bounding sphere fits within its cell
+        const float scale{ bounding_radius > 0.0f ? 0.5f * cell_size / bounding_radius : cell_size };
+
+        std::vector<ObjectData> objects;
+        objects.reserve(object_count);
+        for (std::uint32_t i = 0; i < object_count; ++i) {
+            const glm::vec2 center{
+                -GRID_HALF_EXTENT + (static_cast<float>(i % columns) + 0.5f) * cell_size,
+                -GRID_HALF_EXTENT + (static_cast<float>(i / columns) + 0.5f) * cell_size
+            };
+            objects.push_back({
+                glm::vec4{ center, 0.0f, bounding_radius * scale },
+                glm::vec4{ center, scale, 0.0f }
+            });
+        }
+        return objects;
+    }
+
+    mesh::VertexInputDesc describeIndirectVertexInput()
+    {
+        auto desc{ mesh::describeVertexInput<mesh::Vertex>(0, 0) };
+        const auto instance_desc{ mesh::describeVertexInput<ObjectData>(1,
+                                                                        static_cast<std::uint32_t>(desc.attributes.size()),
+                                                                        vk::VertexInputRate::eInstance) };
+        desc.bindings.insert(desc.bindings.end(), instance_desc.bindings.begin(), instance_desc.bindings.end());
+        desc.attributes.insert(desc.attributes.end(), instance_desc.attributes.begin(), instance_desc.attributes.end());
+        return desc;
+    }
+
+    CullingPass::CullingPass(vk::SharedDevice device,
+                             mem::DeviceAllocator& allocator,
+                             desc::DescriptorHeap& descriptor_heap,
+                             const vk::PipelineCache& pipeline_cache,
+                             pipe::ShaderModuleCache& shader_cache,
+                             const std::uint32_t frame_count)
+        : m_device{ std::move(device) },
+          m_allocator{ allocator },
+          m_descriptor_heap{ descriptor_heap },
+          m_frames(frame_count)
+    {
+        // The buffers and frustum are reached through the heap and push constants, so the pipeline needs no
+        // layout of its own
+        m_pipeline = vk::SharedPipeline{ pipe::createComputePipeline(m_device,
+                                                                     m_descriptor_heap.getPipelineLayout(),
+                                                                     CULLING_SHADER_PATH,
+                                                                     pipeline_cache,
+                                                                     &shader_cache),
+                                         m_device };
+        dbg::setObjectName(m_device, m_pipeline.get(), "culling pipeline");
+    }
+
+    CullingPass::~CullingPass()
+    {
+        m_descriptor_heap.release(m_object_handle);
+        for (const auto& frame : m_frames) {
+            m_descriptor_heap.release(frame.draw_handle);
+            m_descriptor_heap.release(frame.count_handle);
+        }
+    }
+
+    void CullingPass::setObjects(const std::span<const ObjectData> objects,
+                                 staging::StagingRing& staging,
+                                 const std::span<const std::uint32_t> queue_families)
+    {
+        // Objects written on a dedicated transfer queue and read on the compute and graphics queues are shared
+        // concurrently, while the draw buffers are owned by one family at a time and transferred explicitly
+        std::vector unique_families(queue_families.begin(), queue_families.end());
+        std::ranges::sort(unique_families);
+        const auto [ first, last ]{ std::ranges::unique(unique_families) };
+        unique_families.erase(first, last);
+        const bool concurrent{ unique_families.size() > 1 };
+
+        auto object_info = vk::BufferCreateInfo()
+            .setSize( std::max<vk::DeviceSize>(objects.size_bytes(), sizeof(ObjectData)) )
+            .setUsage( vk::BufferUsageFlagBits::eStorageBuffer
+                     | vk::BufferUsageFlagBits::eVertexBuffer
+                     | vk::BufferUsageFlagBits::eTransferDst )
+            .setSharingMode( concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive );
+        if (concurrent)
+            object_info.setQueueFamilyIndices( unique_families );
+        m_object_buffer = m_allocator.createBuffer(object_info, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        dbg::setObjectName(m_device, m_object_buffer.get().get(), "culling objects");
+
+        m_object_count = static_cast<std::uint32_t>(objects.size());
+        if (!objects.empty())
+            staging.enqueueUpload(objects, m_object_buffer.get());
+
+        // Replace the heap entries of the previous buffers, which are recycled once no frame in flight reads them
+        m_descriptor_heap.release(m_object_handle);
+        m_object_handle = m_descriptor_heap.registerStorageBuffer(m_object_buffer.get());
+        for (std::uint32_t i = 0; i < m_frames.size(); ++i) {
+            auto& frame{ m_frames[i] };
+            frame.draw_buffer = m_allocator.createBuffer(vk::BufferCreateInfo()
+                .setSize( std::max<std::size_t>(objects.size(), 1) * sizeof(vk::DrawIndexedIndirectCommand) )
+                .setUsage( vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer )
+                .setSharingMode( vk::SharingMode::eExclusive ),
+                vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+            frame.count_buffer = m_allocator.createBuffer(vk::BufferCreateInfo()
+                .setSize( sizeof(std::uint32_t) )
+                .setUsage( vk::BufferUsageFlagBits::eStorageBuffer
+                         | vk::BufferUsageFlagBits::eIndirectBuffer
+                         | vk::BufferUsageFlagBits::eTransferDst )
+                .setSharingMode( vk::SharingMode::eExclusive ),
+                vk::MemoryPropertyFlagBits::eDeviceLocal);
+            dbg::setObjectName(m_device, frame.draw_buffer.get().get(), "draw commands (frame {})", i);
+            dbg::setObjectName(m_device, frame.count_buffer.get().get(), "draw count (frame {})", i);
+
+            m_descriptor_heap.release(frame.draw_handle);
+            m_descriptor_heap.release(frame.count_handle);
+            frame.draw_handle = m_descriptor_heap.registerStorageBuffer(frame.draw_buffer.get());
+            frame.count_handle = m_descriptor_heap.registerStorageBuffer(frame.count_buffer.get());
+        }
+    }
+
+    void CullingPass::recordReset(const vk::CommandBuffer& command_buffer, const std::uint32_t frame_index) const
+    {
+        command_buffer.fillBuffer(m_frames.at(frame_index).count_buffer.get(), 0, sizeof(std::uint32_t), 0);
+    }
+
+    void CullingPass::recordDispatch(const vk::CommandBuffer& command_buffer,
+                                     const std::uint32_t index_count,
+                                     const std::uint32_t frame_index) const
+    {
+        // Cull each object against the frustum, appending a draw command for every survivor
+        const auto& frame{ m_frames.at(frame_index) };
+        const CullingConstants constants{
+            m_frustum, m_object_count, index_count, m_object_handle, frame.draw_handle, frame.count_handle
+        };
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline.get());
+        m_descriptor_heap.pushConstants(command_buffer, constants);
+        command_buffer.dispatch((m_object_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    void CullingPass::recordRelease(const vk::CommandBuffer& command_buffer,
+                                    const std::uint32_t frame_index,
+                                    const std::uint32_t src_family,
+                                    const std::uint32_t dst_family) const
+    {
+        // The release makes the dispatch's writes available, the destination access is ignored
+        recordOwnershipTransfer(command_buffer, m_frames.at(frame_index), src_family, dst_family,
+                                vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite,
+                                vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone);
+    }
+
+    void CullingPass::recordAcquire(const vk::CommandBuffer& command_buffer,
+                                    const std::uint32_t frame_index,
+                                    const std::uint32_t src_family,
+                                    const std::uint32_t dst_family) const
+    {
+        // The acquire makes the writes visible to the indirect draw, the source access is ignored and the source
+        // stage chains with the stage the semaphore wait of the submission blocks
+        recordOwnershipTransfer(command_buffer, m_frames.at(frame_index), src_family, dst_family,
+                                vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eNone,
+                                vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead);
+    }
+}
@@ -0,0 +1,224 @@
+module;
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+export module culling;
+
+// External Dependencies
+import glm;
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+import descriptor_heap;
+import mesh;
+import shader_cache;
+import staging;
+
+namespace eng::cull {
+    /**
+     * The SPIR-V files of the GPU-driven path: the culling compute shader and the vertex shader which places
+     * each object using its instance attributes
+     */
+    export constexpr std::string_view CULLING_SHADER_PATH{ "shaders/cull.spv" };
+    export constexpr std::string_view INDIRECT_VERTEX_SHADER_PATH{ "shaders/indirect_vert.spv" };
+
+    /**
+     * The number of objects culled by each compute workgroup, must match local_size_x in the culling shader
+     */
+    export constexpr std::uint32_t WORKGROUP_SIZE{ 64 };
+
+    /**
+     * The half-width of the square the object grid is spread over, in clip space. It exceeds the visible
+     * [-1, 1] range so part of the grid always falls outside the frustum.
+     */
+    export constexpr float GRID_HALF_EXTENT{ 1.5f };
+
+    /**
+     * Per-object data, read by the culling shader as a storage buffer (std430) and by the vertex shader
+     * as per-instance attributes
+     */
+    export struct ObjectData
+    {
+        glm::vec4 bounds{ 0.0f };       // Bounding sphere, center in xyz and radius in w
+        glm::vec4 transform{ 0.0f };    // Offset in xy and uniform scale in z
+
+        // Only the transform is consumed as a vertex attribute
+        static constexpr std::tuple ATTRIBUTES{ &ObjectData::transform };
+    };
+
+    /**
+     * The frustum planes as (normal, distance), a point p is inside a plane if dot(normal, p) + distance >= 0
+     */
+    export using Frustum = std::array<glm::vec4, 6>;
+
+    /**
+     * The culling shader's push constants, must match the push constant block in the culling shader. The buffers
+     * are addressed through their handles in the descriptor heap.
+     */
+    export struct CullingConstants
+    {
+        Frustum frustum;
+        std::uint32_t object_count{ 0 };
+        std::uint32_t index_count{ 0 };     // Written into every surviving draw command
+        desc::StorageBufferHandle objects;
+        desc::StorageBufferHandle draws;
+        desc::StorageBufferHandle draw_count;
+    };
+    static_assert(desc::PushConstantBlock<CullingConstants>);
+
+    /**
+     * Extracts the normalized frustum planes of a view-projection matrix with a [0, 1] depth range
+     * @param view_projection the combined view and projection matrix
+     * @return the left, right, bottom, top, near and far planes
+     */
+    export [[nodiscard]] Frustum extractFrustum(const glm::mat4& view_projection);
+
+    /**
+     * Spreads objects evenly over a square grid centered on the origin
+     * @param object_count the number of objects
+     * @param bounding_radius the bounding radius of the mesh drawn for each object, in model space
+     * @return the object data, with each object scaled to fill its grid cell
+     */
+    export [[nodiscard]] std::vector<ObjectData> createObjectGrid(std::uint32_t object_count, float bounding_radius);
+
+    /**
+     * The vertex input state of the GPU-driven path, the mesh's vertices at binding 0 followed by the object
+     * transforms at binding 1, stepped per instance so each draw's first instance selects its object
+     */
+    export [[nodiscard]] mesh::VertexInputDesc describeIndirectVertexInput();
+
+    /**
+     * Culls the scene's objects against the frustum in a compute pass, writing a compacted list of indexed
+     * indirect draw commands and their count for a single drawIndexedIndirectCount call. The object data is
+     * uploaded once, so the CPU cost of a frame does not grow with the number of objects. Each frame slot has its
+     * own draw commands, so culling the next frame on an asynchronous compute queue can overlap with drawing the
+     * previous one.
+     */
+    export class CullingPass
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the culling pipeline, the pass draws nothing until objects are set
+         * @param device the logical device which will own the resources
+         * @param allocator the allocator the object and draw buffers are sub-allocated from
+         * @param descriptor_heap the heap the buffers are registered in, whose layout the pipeline is created with
+         * @param pipeline_cache the cache used to compile the culling pipeline
+         * @param shader_cache the cache the culling shader module is acquired from
+         * @param frame_count the number of frame slots, each with its own draw commands and count
+         */
+        CullingPass(vk::SharedDevice device,
+                    mem::DeviceAllocator& allocator,
+                    desc::DescriptorHeap& descriptor_heap,
+                    const vk::PipelineCache& pipeline_cache,
+                    pipe::ShaderModuleCache& shader_cache,
+                    std::uint32_t frame_count);
+
+        CullingPass(const CullingPass&) = delete;
+        CullingPass& operator=(const CullingPass&) = delete;
+
+        ~CullingPass();
+
+        /* Scene Methods */
+
+        /**
+         * Replaces the scene's objects, queueing their upload. No frame using the previous objects may be in flight.
+         * @param objects the per-object data
+         * @param staging the staging ring the objects are uploaded through
+         * @param queue_families the queue families which will access the object buffer, the draw commands are
+         *                       owned by one family at a time
+         */
+        void setObjects(std::span<const ObjectData> objects,
+                        staging::StagingRing& staging,
+                        std::span<const std::uint32_t> queue_families);
+
+        void setFrustum(const Frustum& frustum)
+        { m_frustum = frustum; }
+
+        /* Recording Methods */
+
+        // Records the reset of a frame slot's draw count, a transfer write which must complete before the dispatch
+        void recordReset(const vk::CommandBuffer& command_buffer, std::uint32_t frame_index) const;
+
+        /**
+         * Records the culling dispatch, which reads the objects, writes the draw commands, and increments the
+         * draw count. The descriptor heap must be bound, and the caller is responsible for the barriers around it.
+         * @param command_buffer the command buffer to record into, must be in the recording state
+         * @param index_count the index count of the mesh drawn for each object
+         * @param frame_index the frame slot whose draw commands are written
+         */
+        void recordDispatch(const vk::CommandBuffer& command_buffer,
+                            std::uint32_t index_count,
+                            std::uint32_t frame_index) const;
+
+        /**
+         * Records the release of a frame slot's draw commands and count by the family which culled, once the
+         * dispatch has written them. Must be paired with recordAcquire on the drawing family.
+         * @param command_buffer a command buffer of the culling family
+         * @param frame_index the frame slot whose buffers are transferred
+         * @param src_family the family which culled
+         * @param dst_family the family which draws
+         */
+        void recordRelease(const vk::CommandBuffer& command_buffer,
+                           std::uint32_t frame_index,
+                           std::uint32_t src_family,
+                           std::uint32_t dst_family) const;
+
+        /**
+         * Records the acquisition of a frame slot's draw commands and count by the family which draws, before the
+         * indirect draw reads them. The submission must wait for the releasing submission.
+         * @param command_buffer a command buffer of the drawing family
+         * @param frame_index the frame slot whose buffers are transferred
+         * @param src_family the family which culled
+         * @param dst_family the family which draws
+         */
+        void recordAcquire(const vk::CommandBuffer& command_buffer,
+                           std::uint32_t frame_index,
+                           std::uint32_t src_family,
+                           std::uint32_t dst_family) const;
+
+        /* Accessors */
+
+        [[nodiscard]] std::uint32_t getObjectCount() const
+        { return m_object_count; }
+
+        [[nodiscard]] vk::Buffer getObjectBuffer() const
+        { return m_object_buffer.get(); }
+
+        [[nodiscard]] vk::Buffer getDrawBuffer(const std::uint32_t frame_index) const
+        { return m_frames.at(frame_index).draw_buffer.get(); }
+
+        [[nodiscard]] vk::Buffer getCountBuffer(const std::uint32_t frame_index) const
+        { return m_frames.at(frame_index).count_buffer.get(); }
+
+    private:
+        /* Data Members */
+
+        vk::SharedDevice        m_device;
+        mem::DeviceAllocator&   m_allocator;
+        desc::DescriptorHeap&   m_descriptor_heap;
+        vk::SharedPipeline      m_pipeline;
+
+        struct FrameBuffers
+        {
+            mem::AllocatedBuffer        draw_buffer;
+            mem::AllocatedBuffer        count_buffer;
+            desc::StorageBufferHandle   draw_handle;
+            desc::StorageBufferHandle   count_handle;
+        };
+
+        mem::AllocatedBuffer        m_object_buffer;
+        desc::StorageBufferHandle   m_object_handle;
+        std::uint32_t               m_object_count{ 0 };
+        std::vector<FrameBuffers>   m_frames;
+
+        Frustum m_frustum{ extractFrustum(glm::mat4{ 1.0f }) };
+    };
+}
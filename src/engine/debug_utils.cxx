@@ -0,0 +1,43 @@
+module;
+
+#include <iostream>
+#include <print>
+
+module debug_utils;
+
+namespace eng::dbg {
+    namespace {
+        vk::Bool32 printMessage(const vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
+                                const vk::DebugUtilsMessageTypeFlagsEXT types,
+                                const vk::DebugUtilsMessengerCallbackDataEXT* callback_data,
+                                void* /* user_data */)
+        {
+            const auto* category{
+                types & vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation  ? "validation"
+              : types & vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance ? "performance"
+                                                                           : "general"
+            };
+            std::println(std::cerr, "{} ({}): {}",
+                         severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eError ? "ERROR" : "WARNING",
+                         category,
+                         callback_data->pMessage);
+
+            // The call which triggered the message is never aborted
+            return vk::False;
+        }
+    }
+
+    DebugMessenger::DebugMessenger(const vk::SharedInstance& instance)
+    {
+        if constexpr (ENABLED) {
+            const auto messenger_info = vk::DebugUtilsMessengerCreateInfoEXT()
+                .setMessageSeverity( vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning
+                                   | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError )
+                .setMessageType( vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral
+                               | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation
+                               | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance )
+                .setPfnUserCallback( printMessage );
+            m_messenger = vk::SharedDebugUtilsMessengerEXT{ instance->createDebugUtilsMessengerEXT(messenger_info), instance };
+        }
+    }
+}
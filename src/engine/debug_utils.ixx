@@ -0,0 +1,141 @@
+module;
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <utility>
+
+export module debug_utils;
+
+// External Dependencies
+import vulkan_hpp;
+
+namespace eng::dbg {
+    /**
+     * True if debug utils instrumentation is compiled in, which the build does for its Debug and RelWithDebInfo
+     * configurations by defining ENG_DEBUG_UTILS. Otherwise every function below compiles to nothing, no label
+     * or name is ever formatted, and the instance extension is not requested. The extension's entry points are not
+     * exported by the loader, so they are called through the default dispatcher, which loads them with the instance
+     * and the device. Names built from strings which must first be converted, such as paths, are converted under
+     * if constexpr (ENABLED).
+     */
+#ifdef ENG_DEBUG_UTILS
+    export constexpr bool ENABLED{ true };
+#else
+    export constexpr bool ENABLED{ false };
+#endif
+
+    inline constexpr std::array DEBUG_UTILS_EXTENSIONS{ vk::EXTDebugUtilsExtensionName };
+
+    /**
+     * The instance extensions instrumentation requires, empty unless enabled
+     */
+    export constexpr std::span<const char* const> INSTANCE_EXTENSIONS{
+        ENABLED ? std::span<const char* const>{ DEBUG_UTILS_EXTENSIONS } : std::span<const char* const>{ }
+    };
+
+    /**
+     * The colors labels are shown with in GPU debuggers, distinguishing the work of each queue
+     */
+    export constexpr std::array GRAPHICS_LABEL_COLOR{ 0.30f, 0.60f, 0.90f, 1.0f };
+    export constexpr std::array COMPUTE_LABEL_COLOR{ 0.90f, 0.55f, 0.20f, 1.0f };
+
+    /* Object Naming Functions */
+
+    /**
+     * Names a handle, so validation messages and GPU debuggers refer to it by name
+     * @tparam Handle a Vulkan handle type, e.g., vk::Buffer
+     * @param device the device which created the handle
+     * @param handle the handle to name
+     * @param name the name, copied by the implementation
+     */
+    export template <typename Handle>
+    void setObjectName(const vk::Device& device, const Handle& handle, const char* name)
+    {
+        if constexpr (ENABLED) {
+            device.setDebugUtilsObjectNameEXT(vk::DebugUtilsObjectNameInfoEXT()
+                .setObjectType( Handle::objectType )
+                .setObjectHandle( std::bit_cast<std::uint64_t>(static_cast<typename Handle::CType>(handle)) )
+                .setPObjectName( name ));
+        }
+    }
+
+    /**
+     * Names a handle with a formatted name, which is only formatted if instrumentation is enabled
+     * @param device the device which created the handle
+     * @param handle the handle to name
+     * @param format the format string of the name
+     * @param args the arguments of the format string
+     */
+    export template <typename Handle, typename... Args>
+    void setObjectName(const vk::Device& device, const Handle& handle, std::format_string<Args...> format, Args&&... args)
+    {
+        if constexpr (ENABLED)
+            setObjectName(device, handle, std::format(format, std::forward<Args>(args)...).c_str());
+    }
+
+    /* Command Labels */
+
+    /**
+     * Wraps the commands recorded during its lifetime in a labeled region, shown as a group of commands by GPU
+     * debuggers and profilers. The region must begin and end within the same command buffer, and within the same
+     * rendering scope if begun inside one.
+     */
+    export class ScopedLabel
+    {
+    public:
+        /* Constructors */
+
+        ScopedLabel(const vk::CommandBuffer& command_buffer,
+                    const char* name,
+                    const std::array<float, 4>& color = GRAPHICS_LABEL_COLOR)
+        {
+            if constexpr (ENABLED) {
+                command_buffer.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT()
+                    .setPLabelName( name )
+                    .setColor( color ));
+                m_command_buffer = command_buffer;
+            }
+        }
+
+        ScopedLabel(const ScopedLabel&) = delete;
+        ScopedLabel& operator=(const ScopedLabel&) = delete;
+
+        /* Destructor */
+
+        ~ScopedLabel()
+        {
+            if constexpr (ENABLED)
+                m_command_buffer.endDebugUtilsLabelEXT();
+        }
+
+    private:
+        /* Data Members */
+
+        vk::CommandBuffer m_command_buffer;
+    };
+
+    /* Validation Messages */
+
+    /**
+     * Forwards warnings and errors from the validation layers and the driver to the standard error stream, for
+     * the lifetime of the instance. Creates nothing unless instrumentation is enabled.
+     */
+    export class DebugMessenger
+    {
+    public:
+        /* Constructors */
+
+        DebugMessenger() = default;
+
+        // Registers the messenger with the instance, which must have been created with the instance extensions
+        explicit DebugMessenger(const vk::SharedInstance& instance);
+
+    private:
+        /* Data Members */
+
+        vk::SharedDebugUtilsMessengerEXT m_messenger;
+    };
+}
@@ -0,0 +1,233 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <span>
+#include <utility>
+#include <vector>
+
+module descriptor_heap;
+
+// Internal Dependencies
+import debug_utils;
+import pipeline;
+
+namespace eng::desc {
+    namespace {
+        constexpr vk::DescriptorType toDescriptorType(const DescriptorKind kind)
+        {
+            switch (kind) {
+                case DescriptorKind::Sampler:       return vk::DescriptorType::eSampler;
+                case DescriptorKind::StorageBuffer: return vk::DescriptorType::eStorageBuffer;
+                case DescriptorKind::SampledImage:  return vk::DescriptorType::eSampledImage;
+            }
+            return vk::DescriptorType::eSampler;
+        }
+
+        constexpr std::uint32_t toBinding(const DescriptorKind kind)
+        {
+            switch (kind) {
+                case DescriptorKind::Sampler:       return SAMPLER_BINDING;
+                case DescriptorKind::StorageBuffer: return STORAGE_BUFFER_BINDING;
+                case DescriptorKind::SampledImage:  return SAMPLED_IMAGE_BINDING;
+            }
+            return SAMPLER_BINDING;
+        }
+
+        // Clamps the requested capacity to what one update-after-bind set, and each stage, may access
+        HeapCapacity clampCapacity(const HeapCapacity& requested, const vk::PhysicalDeviceVulkan12Properties& limits)
+        {
+            return {
+                .samplers = std::min({ requested.samplers,
+                                       limits.maxDescriptorSetUpdateAfterBindSamplers,
+                                       limits.maxPerStageDescriptorUpdateAfterBindSamplers }),
+                .storage_buffers = std::min({ requested.storage_buffers,
+                                              limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                              limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers }),
+                .sampled_images = std::min({ requested.sampled_images,
+                                             limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                             limits.maxPerStageDescriptorUpdateAfterBindSampledImages })
+            };
+        }
+    }
+
+    std::uint32_t DescriptorHeap::IndexAllocator::allocate()
+    {
+        if (!free_indices.empty()) {
+            const auto index{ free_indices.back() };
+            free_indices.pop_back();
+            return index;
+        }
+        if (next == capacity)
+            throw std::runtime_error("the descriptor heap is full");
+        return next++;
+    }
+
+    DescriptorHeap::DescriptorHeap(vk::SharedDevice device,
+                                   const GPU& gpu,
+                                   const std::uint32_t frames_in_flight,
+                                   const HeapCapacity& capacity,
+                                   const std::span<const vk::DescriptorSetLayout> additional_set_layouts)
+        : m_device{ std::move(device) },
+          m_frames_in_flight{ frames_in_flight },
+          m_capacity{ clampCapacity(capacity, gpu.getVulkan12Properties()) }
+    {
+        m_samplers.capacity = m_capacity.samplers;
+        m_storage_buffers.capacity = m_capacity.storage_buffers;
+        m_sampled_images.capacity = m_capacity.sampled_images;
+
+        // Every binding may be written while the set is bound, and only the descriptors a shader actually
+        // indexes need to be valid
+        constexpr vk::ShaderStageFlags stages{ PUSH_CONSTANT_STAGES };
+        const std::array bindings{
+            vk::DescriptorSetLayoutBinding{ SAMPLER_BINDING, vk::DescriptorType::eSampler, m_capacity.samplers, stages },
+            vk::DescriptorSetLayoutBinding{ STORAGE_BUFFER_BINDING, vk::DescriptorType::eStorageBuffer, m_capacity.storage_buffers, stages },
+            vk::DescriptorSetLayoutBinding{ SAMPLED_IMAGE_BINDING, vk::DescriptorType::eSampledImage, m_capacity.sampled_images, stages },
+        };
+        constexpr vk::DescriptorBindingFlags common_flags{ vk::DescriptorBindingFlagBits::eUpdateAfterBind
+                                                         | vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending
+                                                         | vk::DescriptorBindingFlagBits::ePartiallyBound };
+        constexpr std::array binding_flags{
+            common_flags,
+            common_flags,
+            common_flags | vk::DescriptorBindingFlagBits::eVariableDescriptorCount
+        };
+        const auto binding_flags_info = vk::DescriptorSetLayoutBindingFlagsCreateInfo()
+            .setBindingFlags( binding_flags );
+        m_set_layout = vk::SharedDescriptorSetLayout{ m_device->createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo()
+            .setFlags( vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool )
+            .setBindings( bindings )
+            .setPNext( &binding_flags_info )
+        ), m_device };
+
+        const std::array pool_sizes{
+            vk::DescriptorPoolSize{ vk::DescriptorType::eSampler, m_capacity.samplers },
+            vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, m_capacity.storage_buffers },
+            vk::DescriptorPoolSize{ vk::DescriptorType::eSampledImage, m_capacity.sampled_images },
+        };
+        m_descriptor_pool = vk::SharedDescriptorPool{ m_device->createDescriptorPool(vk::DescriptorPoolCreateInfo()
+            .setFlags( vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind )
+            .setMaxSets( 1 )
+            .setPoolSizes( pool_sizes )
+        ), m_device };
+
+        const std::array set_layouts{ m_set_layout.get() };
+        const std::array variable_counts{ m_capacity.sampled_images };
+        const auto variable_count_info = vk::DescriptorSetVariableDescriptorCountAllocateInfo()
+            .setDescriptorCounts( variable_counts );
+        m_descriptor_set = m_device->allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool( m_descriptor_pool.get() )
+            .setSetLayouts( set_layouts )
+            .setPNext( &variable_count_info )
+        )[0];
+
+        // Every pipeline shares this layout, so binding the sets once serves every draw and dispatch
+        std::vector pipeline_set_layouts{ m_set_layout.get() };
+        pipeline_set_layouts.insert(pipeline_set_layouts.end(), additional_set_layouts.begin(), additional_set_layouts.end());
+        constexpr std::array push_constant_ranges{ PUSH_CONSTANT_RANGE };
+        m_pipeline_layout = vk::SharedPipelineLayout{
+            pipe::createPipelineLayout(m_device, pipeline_set_layouts, push_constant_ranges), m_device };
+
+        dbg::setObjectName(m_device, m_set_layout.get(), "descriptor heap layout");
+        dbg::setObjectName(m_device, m_descriptor_pool.get(), "descriptor heap pool");
+        dbg::setObjectName(m_device, m_descriptor_set, "descriptor heap");
+        dbg::setObjectName(m_device, m_pipeline_layout.get(), "shared pipeline layout");
+    }
+
+    SamplerHandle DescriptorHeap::registerSampler(const vk::Sampler sampler)
+    {
+        const SamplerHandle handle{ m_samplers.allocate() };
+        m_pending_writes.push_back({ DescriptorKind::Sampler,
+                                     handle.index,
+                                     static_cast<std::uint32_t>(m_pending_image_infos.size()) });
+        m_pending_image_infos.push_back(vk::DescriptorImageInfo().setSampler( sampler ));
+        ++m_statistics.live_descriptors;
+        return handle;
+    }
+
+    StorageBufferHandle DescriptorHeap::registerStorageBuffer(const vk::Buffer buffer,
+                                                              const vk::DeviceSize offset,
+                                                              const vk::DeviceSize range)
+    {
+        const StorageBufferHandle handle{ m_storage_buffers.allocate() };
+        m_pending_writes.push_back({ DescriptorKind::StorageBuffer,
+                                     handle.index,
+                                     static_cast<std::uint32_t>(m_pending_buffer_infos.size()) });
+        m_pending_buffer_infos.emplace_back(buffer, offset, range);
+        ++m_statistics.live_descriptors;
+        return handle;
+    }
+
+    SampledImageHandle DescriptorHeap::registerSampledImage(const vk::ImageView image_view, const vk::ImageLayout layout)
+    {
+        const SampledImageHandle handle{ m_sampled_images.allocate() };
+        m_pending_writes.push_back({ DescriptorKind::SampledImage,
+                                     handle.index,
+                                     static_cast<std::uint32_t>(m_pending_image_infos.size()) });
+        m_pending_image_infos.push_back(vk::DescriptorImageInfo()
+            .setImageView( image_view )
+            .setImageLayout( layout )
+        );
+        ++m_statistics.live_descriptors;
+        return handle;
+    }
+
+    void DescriptorHeap::beginFrame(const std::uint64_t frame_number)
+    {
+        m_frame_number = frame_number;
+
+        // Frames complete in order, so once a full ring has been submitted since a release, no frame still reads it
+        while (!m_released.empty() && frame_number >= m_released.front().released_at_frame + m_frames_in_flight) {
+            const auto& released{ m_released.front() };
+            getIndexAllocator(released.kind).free_indices.push_back(released.index);
+            --m_statistics.live_descriptors;
+            m_released.pop_front();
+        }
+
+        if (m_pending_writes.empty())
+            return;
+
+        // Update-after-bind allows writing descriptors no pending command buffer uses, so there is no need to wait
+        m_write_scratch.clear();
+        m_write_scratch.reserve(m_pending_writes.size());
+        for (const auto& [ kind, index, info ] : m_pending_writes) {
+            auto write = vk::WriteDescriptorSet()
+                .setDstSet( m_descriptor_set )
+                .setDstBinding( toBinding(kind) )
+                .setDstArrayElement( index )
+                .setDescriptorCount( 1 )
+                .setDescriptorType( toDescriptorType(kind) );
+            if (kind == DescriptorKind::StorageBuffer)
+                write.setPBufferInfo( &m_pending_buffer_infos[info] );
+            else
+                write.setPImageInfo( &m_pending_image_infos[info] );
+            m_write_scratch.push_back(write);
+        }
+        m_device->updateDescriptorSets(m_write_scratch, {});
+
+        m_statistics.descriptor_writes += static_cast<std::uint32_t>(m_write_scratch.size());
+        ++m_statistics.update_calls;
+        m_pending_writes.clear();
+        m_pending_image_infos.clear();
+        m_pending_buffer_infos.clear();
+    }
+
+    void DescriptorHeap::bind(const vk::CommandBuffer& command_buffer,
+                              const std::span<const vk::PipelineBindPoint> bind_points) const
+    {
+        for (const auto bind_point : bind_points)
+            command_buffer.bindDescriptorSets(bind_point, m_pipeline_layout.get(), 0, m_descriptor_set, {});
+    }
+
+    DescriptorHeap::IndexAllocator& DescriptorHeap::getIndexAllocator(const DescriptorKind kind)
+    {
+        switch (kind) {
+            case DescriptorKind::Sampler:       return m_samplers;
+            case DescriptorKind::StorageBuffer: return m_storage_buffers;
+            case DescriptorKind::SampledImage:  return m_sampled_images;
+        }
+        throw std::logic_error("unknown descriptor kind");
+    }
+}
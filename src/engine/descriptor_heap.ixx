@@ -0,0 +1,242 @@
+module;
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+export module descriptor_heap;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import gpu;
+
+namespace eng::desc {
+    /**
+     * The bindings of the global descriptor set, shaders declare each as an unsized array indexed by the handles
+     * they receive through push constants. The sampled images come last, as only the last binding of a set may
+     * have a variable descriptor count.
+     */
+    export constexpr std::uint32_t SAMPLER_BINDING{ 0 };
+    export constexpr std::uint32_t STORAGE_BUFFER_BINDING{ 1 };
+    export constexpr std::uint32_t SAMPLED_IMAGE_BINDING{ 2 };
+
+    /**
+     * The bind points frame-wide sets are bound to by default. Command buffers of a compute-only queue family may
+     * only bind to the compute bind point.
+     */
+    export constexpr std::array ALL_BIND_POINTS{ vk::PipelineBindPoint::eGraphics, vk::PipelineBindPoint::eCompute };
+    export constexpr std::array GRAPHICS_BIND_POINTS{ vk::PipelineBindPoint::eGraphics };
+    export constexpr std::array COMPUTE_BIND_POINTS{ vk::PipelineBindPoint::eCompute };
+
+    /**
+     * The push constant block shared by every pipeline, the minimum maxPushConstantsSize guaranteed by the spec
+     */
+    export constexpr std::uint32_t PUSH_CONSTANT_SIZE{ 128 };
+    export constexpr vk::ShaderStageFlags PUSH_CONSTANT_STAGES{ vk::ShaderStageFlagBits::eVertex
+                                                              | vk::ShaderStageFlagBits::eFragment
+                                                              | vk::ShaderStageFlagBits::eCompute };
+    export constexpr vk::PushConstantRange PUSH_CONSTANT_RANGE{ PUSH_CONSTANT_STAGES, 0, PUSH_CONSTANT_SIZE };
+
+    /**
+     * A type which may be pushed at an offset into the shared push constant range, checked at compile time against
+     * the range every pipeline layout is created with. Its member layout must match the shaders' push constant block.
+     */
+    export template <typename T, std::uint32_t Offset = 0>
+    concept PushConstantBlock = std::is_trivially_copyable_v<T>
+                                && std::is_standard_layout_v<T>
+                                && Offset % 4 == 0
+                                && sizeof(T) % 4 == 0
+                                && Offset >= PUSH_CONSTANT_RANGE.offset
+                                && Offset + sizeof(T) <= PUSH_CONSTANT_RANGE.offset + PUSH_CONSTANT_RANGE.size;
+
+    export enum class DescriptorKind : std::uint8_t
+    {
+        Sampler,
+        StorageBuffer,
+        SampledImage
+    };
+
+    /**
+     * The index of a descriptor within its binding of the global set, passed to shaders as a plain integer
+     */
+    export template <DescriptorKind Kind>
+    struct DescriptorHandle
+    {
+        std::uint32_t index{ std::numeric_limits<std::uint32_t>::max() };
+
+        [[nodiscard]] bool isValid() const
+        { return index != std::numeric_limits<std::uint32_t>::max(); }
+
+        [[nodiscard]] bool operator==(const DescriptorHandle&) const = default;
+    };
+
+    export using SamplerHandle = DescriptorHandle<DescriptorKind::Sampler>;
+    export using StorageBufferHandle = DescriptorHandle<DescriptorKind::StorageBuffer>;
+    export using SampledImageHandle = DescriptorHandle<DescriptorKind::SampledImage>;
+
+    /**
+     * The number of descriptors of each kind the heap can hold, clamped to the device's update-after-bind limits
+     */
+    export struct HeapCapacity
+    {
+        std::uint32_t samplers{ 256 };
+        std::uint32_t storage_buffers{ 16384 };
+        std::uint32_t sampled_images{ 16384 };
+    };
+
+    export struct HeapStatistics
+    {
+        std::uint32_t live_descriptors{ 0 };
+        std::uint32_t descriptor_writes{ 0 };   // Descriptors written since creation
+        std::uint32_t update_calls{ 0 };        // vkUpdateDescriptorSets calls, at most one per frame
+    };
+
+    /**
+     * A single update-after-bind descriptor set holding every sampler, storage buffer and sampled image, with
+     * the one pipeline layout every pipeline is created with. The set is bound once per command buffer and
+     * resources are selected by the integer handles pushed with each draw or dispatch, so no per-draw descriptor
+     * set binds or per-material layouts are needed.
+     */
+    export class DescriptorHeap
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the global descriptor set and pipeline layout
+         * @param device the logical device which will own the resources
+         * @param gpu the GPU, queried for its update-after-bind limits
+         * @param frames_in_flight the number of frames which may still read a released descriptor
+         * @param capacity the number of descriptors of each kind
+         * @param additional_set_layouts the layouts of the sets following the global set in the pipeline layout
+         */
+        DescriptorHeap(vk::SharedDevice device,
+                       const GPU& gpu,
+                       std::uint32_t frames_in_flight,
+                       const HeapCapacity& capacity = { },
+                       std::span<const vk::DescriptorSetLayout> additional_set_layouts = {});
+
+        DescriptorHeap(const DescriptorHeap&) = delete;
+        DescriptorHeap& operator=(const DescriptorHeap&) = delete;
+
+        /* Registration Methods */
+
+        /**
+         * Allocates a handle for a resource, its descriptor is written on the next beginFrame
+         * @throws std::runtime_error if every descriptor of the kind is in use
+         */
+        [[nodiscard]] SamplerHandle registerSampler(vk::Sampler sampler);
+
+        [[nodiscard]] StorageBufferHandle registerStorageBuffer(vk::Buffer buffer,
+                                                                vk::DeviceSize offset = 0,
+                                                                vk::DeviceSize range = vk::WholeSize);
+
+        [[nodiscard]] SampledImageHandle registerSampledImage(vk::ImageView image_view,
+                                                              vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        /**
+         * Releases a handle, which is reused once every frame in flight at the time of release has completed.
+         * Invalid handles are ignored.
+         */
+        template <DescriptorKind Kind>
+        void release(const DescriptorHandle<Kind> handle)
+        {
+            if (handle.isValid())
+                m_released.push_back({ Kind, handle.index, m_frame_number });
+        }
+
+        /* Frame Methods */
+
+        /**
+         * Writes every descriptor registered since the last call in one update, and recycles the handles released
+         * at least a full ring of frames ago. Called once per frame, before recording.
+         * @param frame_number the number of frames submitted so far
+         */
+        void beginFrame(std::uint64_t frame_number);
+
+        // Binds the global set, for both graphics and compute pipelines by default
+        void bind(const vk::CommandBuffer& command_buffer,
+                  std::span<const vk::PipelineBindPoint> bind_points = ALL_BIND_POINTS) const;
+
+        /**
+         * Pushes a pipeline's constants, typically the handles of the resources a draw or dispatch reads
+         * @tparam Offset the offset of the block within the push constant range
+         * @param command_buffer the command buffer to record into
+         * @param constants the constants
+         */
+        template <typename T, std::uint32_t Offset = 0>
+            requires PushConstantBlock<T, Offset>
+        void pushConstants(const vk::CommandBuffer& command_buffer, const T& constants) const
+        { command_buffer.pushConstants(m_pipeline_layout.get(), PUSH_CONSTANT_RANGE.stageFlags, Offset, sizeof(T), &constants); }
+
+        /* Accessors */
+
+        [[nodiscard]] const vk::SharedPipelineLayout& getPipelineLayout() const
+        { return m_pipeline_layout; }
+
+        [[nodiscard]] const HeapCapacity& getCapacity() const
+        { return m_capacity; }
+
+        [[nodiscard]] const HeapStatistics& getStatistics() const
+        { return m_statistics; }
+
+    private:
+        /* Data Members */
+
+        // Hands out the indices of one binding, preferring recently freed indices
+        struct IndexAllocator
+        {
+            std::uint32_t capacity{ 0 };
+            std::uint32_t next{ 0 };
+            std::vector<std::uint32_t> free_indices;
+
+            [[nodiscard]] std::uint32_t allocate();
+        };
+
+        struct ReleasedDescriptor
+        {
+            DescriptorKind kind;
+            std::uint32_t index;
+            std::uint64_t released_at_frame;
+        };
+
+        struct PendingWrite
+        {
+            DescriptorKind kind;
+            std::uint32_t index;
+            std::uint32_t info;     // Index into the pending image or buffer infos
+        };
+
+        vk::SharedDevice                m_device;
+        std::uint32_t                   m_frames_in_flight;
+        HeapCapacity                    m_capacity;
+
+        vk::SharedDescriptorSetLayout   m_set_layout;
+        vk::SharedDescriptorPool        m_descriptor_pool;
+        vk::DescriptorSet               m_descriptor_set;   // Freed with the pool
+        vk::SharedPipelineLayout        m_pipeline_layout;
+
+        IndexAllocator                  m_samplers;
+        IndexAllocator                  m_storage_buffers;
+        IndexAllocator                  m_sampled_images;
+        std::deque<ReleasedDescriptor>  m_released;
+        std::uint64_t                   m_frame_number{ 0 };
+
+        std::vector<PendingWrite>               m_pending_writes;
+        std::vector<vk::DescriptorImageInfo>    m_pending_image_infos;
+        std::vector<vk::DescriptorBufferInfo>   m_pending_buffer_infos;
+        std::vector<vk::WriteDescriptorSet>     m_write_scratch;
+
+        HeapStatistics                  m_statistics;
+
+        /* Helper Methods */
+
+        [[nodiscard]] IndexAllocator& getIndexAllocator(DescriptorKind kind);
+    };
+}
@@ -1,44 +1,130 @@
 module;
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <print>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 #include "vkfw/vkfw.hpp"
 
 module engine;
 
+// External Dependencies
+import glm;
+
 // Internal Dependencies
-import swapchain;
+import offscreen;
 import pipeline;
-import command;
 
 namespace eng {
-    Engine::Engine(const vkfw::Window& window)
-            : m_vk_instance{ init::createVulkanInstance() }
+    namespace {
+        // The angular speed of the scene about the view axis, in radians per second
+        constexpr float SCENE_ROTATION_SPEED{ 0.25f };
+
+        // The time step between headless frames, which advance the scene by frame rather than by the clock so every
+        // run renders, and culls, the same sequence of frames
+        constexpr double HEADLESS_FRAME_STEP{ 1.0 / 60.0 };
+
+        // The states of the pipelines drawn with, validated and hashed at compile time
+        constexpr auto DEFAULT_PIPELINE{ pipe::validate(pipe::PipelineDesc{ }) };
+        constexpr auto INDIRECT_PIPELINE{
+            pipe::validate(pipe::PipelineDesc{ .shaders{ .vertex_path = cull::INDIRECT_VERTEX_SHADER_PATH } })
+        };
+        static_assert(DEFAULT_PIPELINE.key != INDIRECT_PIPELINE.key);
+
+        // The stages of a frame which may read data uploaded through the staging ring
+        constexpr vk::PipelineStageFlags2 UPLOAD_CONSUMER_STAGES{
+            vk::PipelineStageFlagBits2::eVertexInput | vk::PipelineStageFlagBits2::eComputeShader
+        };
+
+        // How long a frame waits for earlier presents before starting regardless, e.g., while the window is occluded
+        constexpr std::chrono::nanoseconds PRESENT_WAIT_TIMEOUT{ std::chrono::milliseconds{ 100 } };
+
+        // The stages of a frame which read the draw commands culled on the compute queue
+        constexpr vk::PipelineStageFlags2 CULLING_CONSUMER_STAGES{ vk::PipelineStageFlagBits2::eDrawIndirect };
+
+        // Returns the milliseconds elapsed since a time point, then advances it to now, timing consecutive stages
+        double lapMilliseconds(std::chrono::steady_clock::time_point& since)
+        {
+            const auto now{ std::chrono::steady_clock::now() };
+            return std::chrono::duration<double, std::milli>{ now - std::exchange(since, now) }.count();
+        }
+    }
+
+    Engine::Engine(const std::span<const vkfw::Window> windows,
+                   const std::uint32_t frames_in_flight,
+                   const swap::PresentConfig& present_config)
+            : m_vk_instance{ init::createVulkanInstance() },
+              m_debug_messenger{ m_vk_instance },
+              m_present_config{ present_config }
     {
-        // Select the candidate GPU and create the logical device
-        const auto candidate_devices{ m_vk_instance->enumeratePhysicalDevices() };
+        if (windows.empty())
+            throw std::invalid_argument("engine must present to at least one window");
+
+        // Select the candidate GPU for the first window's surface and create the logical device
         const std::vector required_device_extensions{
             vk::KHRSwapchainExtensionName,
             vk::KHRDynamicRenderingExtensionName,
+            vk::KHRSynchronization2ExtensionName,
         };
-        const vk::SharedSurfaceKHR surface{ vkfw::createWindowSurface(m_vk_instance, window), m_vk_instance };
-        m_gpu = init::selectSuitableGPU(candidate_devices, required_device_extensions, surface);
-        m_device = vk::SharedDevice{ m_gpu.createLogicalDevice(required_device_extensions) };
+        auto stage_begin{ m_startup_begin };
+        m_startup_timings.instance_ms = lapMilliseconds(stage_begin);
+        m_windows.reserve(windows.size());
+        for (const auto& window : windows) {
+            m_windows.push_back({
+                .window = window,
+                .surface = vk::SharedSurfaceKHR{ vkfw::createWindowSurface(m_vk_instance, window), m_vk_instance }
+            });
+        }
+        m_startup_timings.surface_ms = lapMilliseconds(stage_begin);
+        initDevice(required_device_extensions, m_windows.front().surface);
 
-        // Create the swapchain
-        const auto [ color_format, extent, swapchain, images, image_views ]{
-            swap::createSwapchain(m_gpu,
-                                  m_device,
-                                  surface,
-                                  util::toExtent2D(window.getFramebufferSize()),
-                                  vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc ) };
-        m_swapchain = vk::SharedSwapchainKHR{ swapchain, m_device, surface };
+        // Create the swapchains, the first of which decides the color format
+        stage_begin = std::chrono::steady_clock::now();
+        for (auto& target : m_windows)
+            initWindowTarget(target, frames_in_flight);
+        m_startup_timings.render_targets_ms = lapMilliseconds(stage_begin);
+        initRenderingResources(m_color_format, frames_in_flight);
+    }
+
+    Engine::Engine(const vk::Extent2D& extent, const std::uint32_t frames_in_flight)
+            : m_vk_instance{ init::createVulkanInstance(true) },
+              m_debug_messenger{ m_vk_instance }
+    {
+        // Select the candidate GPU and create the logical device, no presentation support is required
+        const std::vector required_device_extensions{
+            vk::KHRDynamicRenderingExtensionName,
+            vk::KHRSynchronization2ExtensionName,
+        };
+        auto stage_begin{ m_startup_begin };
+        m_startup_timings.instance_ms = lapMilliseconds(stage_begin);
+        initDevice(required_device_extensions, {});
+
+        // Create one offscreen render target per frame slot, so a target is never reused while in flight
+        stage_begin = std::chrono::steady_clock::now();
+        auto [ color_format, image_extent, images, image_views ]{
+            offscreen::createOffscreenTargets(*m_allocator,
+                                              m_device,
+                                              extent,
+                                              frames_in_flight,
+                                              vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc) };
+        m_extent = image_extent;
 
-        // Convert the swapchain images and views to shared handles
+        // Share the offscreen images and convert the views to shared handles, the allocated images retain
+        // ownership of the memory
         m_images.reserve(images.size());
         std::ranges::transform( images,
                                 std::back_inserter(m_images),
-                                [this](const vk::Image image ) {
-                                    return vk::SharedImage{ image, m_device, vk::SwapchainOwns::yes };
-                                } );
+                                [](const mem::AllocatedImage& image ) { return image.get(); } );
+        m_image_allocations = std::move(images);
 
         m_image_views.reserve(image_views.size());
         std::ranges::transform( image_views,
@@ -46,80 +132,903 @@ namespace eng {
                                 [this](const vk::ImageView image_view ) {
                                     return vk::SharedImageView{ image_view, m_device };
                                 } );
+        m_startup_timings.render_targets_ms = lapMilliseconds(stage_begin);
+
+        initRenderingResources(color_format, frames_in_flight);
+    }
+
+    Engine::~Engine()
+    {
+        if (m_pipeline_registry)
+            m_pipeline_registry->waitForPending();
+        if (m_device)
+            m_device->waitIdle();
+
+        // Hand the last frames' completed copies to the capture thread, which writes them out before it stops
+        if (m_capture)
+            m_capture->poll(m_scheduler->getCompletedValue(sched::QueueType::Graphics));
+
+        // A failure to persist the cache only costs compilation time on the next run, so it is not fatal
+        if (m_pipeline_cache) {
+            try {
+                m_pipeline_cache->save();
+            } catch (const std::exception& err) {
+                std::println(std::cerr, "WARNING: failed to save pipeline cache to {}: {}",
+                             m_pipeline_cache->getPath().string(), err.what());
+            }
+        }
+    }
+
+    void Engine::drawFrame()
+    {
+        // Cap the frame rate before the frame starts, so the time spent sleeping is excluded from the frame
+        m_frame_limiter.wait();
+
+        const auto frame_timer{ m_profiler.scope(prof::Phase::Frame) };
+        const auto frame_start{ std::chrono::steady_clock::now() };
+        auto& current_frame{ m_frames[m_current_frame] };
+        const auto& command_buffer{ current_frame.command_buffer };
+
+        // Recreate the swapchains once invalidated or their window is resized, skipping minimized windows, and
+        // start the frame just in time, once few enough earlier frames are still waiting to be displayed
+        for (auto& target : m_windows) {
+            target.image_index.reset();
+            if (util::toExtent2D(target.window.getFramebufferSize()) != target.window_extent)
+                target.dirty = true;
+            target.minimized = target.dirty && !recreateSwapchain(target);
+            if (!target.minimized)
+                waitForQueuedPresents(target);
+        }
+        if (!isHeadless() && std::ranges::all_of(m_windows, &WindowTarget::minimized))
+            return;
+
+        waitForFrameSlot(current_frame);
+
+        // Acquire an image from every window, a window whose swapchain is out of date sits the frame out. The graph
+        // draws the windows which acquired an image, and is rebuilt whenever those change.
+        for (auto& target : m_windows) {
+            if (target.minimized)
+                continue;
+            target.image_index = acquireNextImage(target);
+            if (!target.image_index)
+                target.dirty = true;
+        }
+        const auto acquired = [this](const std::uint32_t window) { return m_windows[window].image_index.has_value(); };
+        auto acquired_windows{ std::views::iota(0u, getWindowCount()) | std::views::filter(acquired) };
+        if (!isHeadless()) {
+            if (std::ranges::empty(acquired_windows))
+                return;
+            if (!std::ranges::equal(acquired_windows, m_drawn_windows))
+                m_render_graph_dirty = true;
+        }
+
+        // Record and submit draw command
+        vk::CommandBuffer frame_commands{ command_buffer.get() };
+        {
+            const auto record_timer{ m_profiler.scope(prof::Phase::Record) };
+
+            // Write the descriptors registered since the last frame, and rebuild the render graph if the passes
+            // or the resources they use have changed
+            m_descriptor_heap->beginFrame(m_frame_number);
+            if (m_render_graph_dirty)
+                buildRenderGraph();
+            updateFrameUniforms();
+
+            // An unchanged frame resubmits the commands recorded for its slot and image by an earlier frame. Those
+            // read the frame's uniforms from the same offset in the slot's uniform region, so they remain current.
+            // Offscreen targets are paired 1:1 with frame slots, and caching is limited to a single window.
+            bool needs_recording{ true };
+            if (usesCommandCaching()) {
+                const auto image_index{ isHeadless() ? m_current_frame : *m_windows.front().image_index };
+                const auto cached{ m_command_cache->acquire(m_current_frame, image_index) };
+                frame_commands = cached.command_buffer;
+                needs_recording = cached.needs_recording;
+            } else {
+                command_buffer->reset();
+            }
+
+            if (needs_recording) {
+                // Split large workloads across worker threads, each recording into its own secondary command buffer
+                m_secondary_command_buffers = {};
+                if (usesParallelRecording())
+                    m_secondary_command_buffers = m_recorder->recordDraws(m_current_frame,
+                                                                          m_color_format,
+                                                                          m_graphics_pipeline.get(),
+                                                                          m_frame_bindings,
+                                                                          m_mesh,
+                                                                          m_extent,
+                                                                          m_scene,
+                                                                          m_visible_draws);
+
+                for (std::size_t i = 0; i < m_render_targets.size(); ++i) {
+                    if (isHeadless()) {
+                        m_render_graph.bindImage(m_render_targets[i],
+                                                 m_images[m_current_frame],
+                                                 m_image_views[m_current_frame],
+                                                 m_extent);
+                    } else {
+                        const auto& target{ m_windows[m_drawn_windows[i]] };
+                        m_render_graph.bindImage(m_render_targets[i],
+                                                 target.images[*target.image_index],
+                                                 target.image_views[*target.image_index],
+                                                 target.extent);
+                    }
+                }
+                if (m_gpu_driven) {
+                    m_render_graph.bindBuffer(m_draw_buffers.draws, m_culling->getDrawBuffer(m_current_frame));
+                    m_render_graph.bindBuffer(m_draw_buffers.draw_count, m_culling->getCountBuffer(m_current_frame));
+                }
+                cmd::recordFrame(frame_commands,
+                                 m_frame_bindings,
+                                 m_render_graph,
+                                 m_profiler.getQueryPool(),
+                                 prof::Profiler::getFirstQuery(m_current_frame));
+            }
+            m_profiler.markTimestampsWritten(m_current_frame);
+        }
+
+        // Submit the frame's uploads as one transfer batch, which the frame waits on before culling or reading
+        // vertex input, then the culling if it runs on the compute queue
+        const auto upload_complete{ m_staging->submit() };
+        const auto culling_complete{ usesAsyncCompute() ? submitCompute(upload_complete) : std::uint64_t{ 0 } };
+
+        const std::array command_buffers{ frame_commands };
+        const std::array queue_waits{
+            sched::QueueWait{ sched::QueueType::Transfer, upload_complete, UPLOAD_CONSUMER_STAGES },
+            sched::QueueWait{ sched::QueueType::Compute, culling_complete, CULLING_CONSUMER_STAGES }
+        };
+        if (isHeadless()) {
+            // Offscreen targets are guarded by the slot's timeline value alone, so only other queues' work is waited on
+            const auto submit_timer{ m_profiler.scope(prof::Phase::Submit) };
+            current_frame.submitted_value = m_scheduler->submit(sched::QueueType::Graphics, command_buffers, queue_waits);
+            if (m_capture)
+                m_capture->markSubmitted(current_frame.submitted_value);
+        } else {
+            // The one submission waits for every drawn window's image and signals every window's present
+            buildPresentBatch();
+            {
+                const auto submit_timer{ m_profiler.scope(prof::Phase::Submit) };
+                current_frame.submitted_value = m_scheduler->submit(sched::QueueType::Graphics,
+                                                                    command_buffers,
+                                                                    queue_waits,
+                                                                    m_present_batch.acquire_waits,
+                                                                    m_present_batch.present_signals);
+            }
+            if (m_capture)
+                m_capture->markSubmitted(current_frame.submitted_value);
+            presentWindows(frame_start);
+        }
+
+        // Advance to the next slot in the ring
+        m_current_frame = (m_current_frame + 1) % static_cast<std::uint32_t>(m_frames.size());
+        ++m_frame_number;
+    }
+
+    mesh::Mesh Engine::uploadMesh(const mesh::MeshData& mesh_data)
+    {
+        const std::array queue_families{ m_gpu.getGraphicsFamilyIndex(), m_gpu.getTransferFamilyIndex() };
+        auto mesh{ mesh::createMesh(*m_allocator, mesh_data.vertices.size(), mesh_data.indices.size(), queue_families) };
+        m_staging->enqueueUpload(std::span{ mesh_data.vertices }, mesh.vertex_buffer.get());
+        m_staging->enqueueUpload(std::span{ mesh_data.indices }, mesh.index_buffer.get());
+        return mesh;
+    }
+
+    void Engine::setMesh(mesh::Mesh mesh)
+    {
+        // Queued uploads may still target the previous mesh, so they are flushed before it is destroyed
+        m_staging->waitIdle();
+        waitIdle();
+        m_mesh = std::move(mesh);
+        m_command_cache->invalidate();
+    }
+
+    void Engine::setWorkload(const cmd::DrawWorkload& workload)
+    {
+        const bool regenerate_mesh{ workload.triangle_count != m_workload.triangle_count };
+        const bool regenerate_objects{ workload.draw_count != m_scene.getObjectCount() };
+        m_workload = workload;
+        m_render_graph_dirty = true;
+        if (regenerate_mesh)
+            setMesh(uploadMesh(mesh::createTriangleMesh(m_workload.triangle_count)));
+        if (regenerate_objects) {
+            m_scene = scene::Scene{ cull::createObjectGrid(m_workload.draw_count, m_mesh_radius) };
+            if (m_culling)
+                uploadObjects();
+        }
+    }
+
+    void Engine::setGpuDriven(const bool enabled)
+    {
+        if (enabled && !m_gpu.supportsIndirectCount())
+            throw std::runtime_error("GPU-driven rendering requires the drawIndirectCount, multiDrawIndirect and "
+                                     "drawIndirectFirstInstance features");
+
+        // Create the culling pass and the pipeline consuming per-object transforms on first use
+        if (enabled && !m_culling) {
+            m_indirect_pipeline = requestPipeline({
+                .state = INDIRECT_PIPELINE,
+                .vertex_input{ cull::describeIndirectVertexInput() }
+            });
+            m_culling.emplace(m_device,
+                              *m_allocator,
+                              *m_descriptor_heap,
+                              m_pipeline_cache->get(),
+                              *m_shader_cache,
+                              static_cast<std::uint32_t>(m_frames.size()));
+            uploadObjects();
+        }
+        m_gpu_driven = enabled;
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::setParallelRecording(const bool enabled)
+    {
+        m_parallel_recording = enabled;
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::setPresentConfig(const swap::PresentConfig& present_config)
+    {
+        // The present mode and image count are fixed at creation, so the swapchains are recreated next frame
+        m_present_config = present_config;
+        for (auto& target : m_windows)
+            target.dirty = true;
+    }
+
+    std::uint32_t Engine::addWindow(const vkfw::Window& window)
+    {
+        if (isHeadless())
+            throw std::logic_error("headless engine cannot present to windows");
+
+        auto& target{ m_windows.emplace_back(WindowTarget{
+            .window = window,
+            .surface = vk::SharedSurfaceKHR{ vkfw::createWindowSurface(m_vk_instance, window), m_vk_instance }
+        }) };
+        try {
+            initWindowTarget(target, static_cast<std::uint32_t>(m_frames.size()));
+        } catch (...) {
+            // Nothing has been submitted against the window, so it is destroyed right away
+            m_windows.pop_back();
+            throw;
+        }
+        m_render_graph_dirty = true;
+        return static_cast<std::uint32_t>(m_windows.size() - 1);
+    }
+
+    void Engine::removeWindow(const std::uint32_t index)
+    {
+        if (index >= m_windows.size())
+            throw std::invalid_argument("no window exists at the given index");
+        if (m_windows.size() == 1)
+            throw std::logic_error("engine must present to at least one window");
+
+        // Frames in flight may still wait on the window's acquire semaphores or present its images, so those are
+        // retired with its swapchain, which keeps the surface alive
+        retireSwapchain(m_windows[index], true);
+        m_windows.erase(m_windows.begin() + index);
+        m_extent = m_windows.front().extent;
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::startCapture(const capture::CaptureConfig& config)
+    {
+        stopCapture();
+        m_capture.emplace(*m_allocator, m_color_format, m_extent, config);
+        m_render_graph_dirty = true;
+    }
+
+    capture::CaptureStatistics Engine::stopCapture()
+    {
+        if (!m_capture)
+            return { };
+
+        // Every recorded copy must complete and be handed over before the capture thread drains its queue
+        waitIdle();
+        m_capture->poll(m_scheduler->getCompletedValue(sched::QueueType::Graphics));
+        const auto statistics{ m_capture->finish() };
+        m_capture.reset();
+        m_render_graph_dirty = true;
+        return statistics;
+    }
+
+    void Engine::setFrameLimit(const double frames_per_second)
+    {
+        m_frame_limiter.setRate(frames_per_second);
+    }
+
+    void Engine::setCommandCaching(const bool enabled)
+    {
+        m_command_caching = enabled;
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::setAsyncCompute(const bool enabled)
+    {
+        m_async_compute = enabled;
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::uploadObjects()
+    {
+        // Queued uploads may still target the previous objects, so they are flushed before those are destroyed
+        m_staging->waitIdle();
+        waitIdle();
+        const std::array queue_families{
+            m_gpu.getGraphicsFamilyIndex(),
+            m_gpu.getComputeFamilyIndex(),
+            m_gpu.getTransferFamilyIndex()
+        };
+        m_culling->setObjects(m_scene.getObjectData(), *m_staging, queue_families);
+        m_render_graph_dirty = true;
+    }
+
+    void Engine::updateFrameUniforms()
+    {
+        // Slowly spin the scene, correcting for each render target's aspect ratio so the object grid stays square
+        const float seconds{ isHeadless()
+            ? static_cast<float>(static_cast<double>(m_frame_number) * HEADLESS_FRAME_STEP)
+            : std::chrono::duration<float>(std::chrono::steady_clock::now() - m_start_time).count() };
+        m_uniform_ring->beginFrame(m_current_frame);
+        m_target_uniforms.clear();
+        float widest_aspect{ 0.0f };
+        glm::mat4 culling_view{ 1.0f };
+        for (std::size_t i = 0; i < m_render_targets.size(); ++i) {
+            const auto& extent{ getTargetExtent(i) };
+            const float aspect{ static_cast<float>(extent.width) / static_cast<float>(std::max(extent.height, 1u)) };
+            const cmd::FrameUniforms frame_uniforms{
+                .view_projection = glm::rotate(glm::scale(glm::mat4{ 1.0f }, glm::vec3{ 1.0f / aspect, 1.0f, 1.0f }),
+                                               seconds * SCENE_ROTATION_SPEED,
+                                               glm::vec3{ 0.0f, 0.0f, 1.0f }),
+                .time = glm::vec4{ seconds, 0.0f, 0.0f, 0.0f }
+            };
+            m_target_uniforms.push_back(m_uniform_ring->push(frame_uniforms));
+
+            // Views differ only in their horizontal scale, so the widest sees every object the others do
+            if (aspect > widest_aspect) {
+                widest_aspect = aspect;
+                culling_view = frame_uniforms.view_projection;
+            }
+        }
+
+        m_frame_bindings = {
+            .descriptor_heap = &*m_descriptor_heap,
+            .uniform_ring = &*m_uniform_ring,
+            .frame_uniforms = m_target_uniforms.front()
+        };
+        if (m_culling)
+            m_culling->setFrustum(cull::extractFrustum(culling_view));
+
+        // Drawing directly records only the visible objects, so commands recorded for a different set are stale
+        if (!m_gpu_driven) {
+            const auto cull_timer{ m_profiler.scope(prof::Phase::Cull) };
+            m_visible_draws = m_scene_culler->cull(m_scene, { .frustum = cull::extractFrustum(culling_view) });
+            if (m_scene_culler->hasChanged())
+                m_command_cache->invalidate();
+        }
+    }
+
+    void Engine::buildRenderGraph()
+    {
+        // Draw the offscreen target, or every window which acquired an image this frame
+        m_drawn_windows.clear();
+        for (std::uint32_t i = 0; i < m_windows.size(); ++i) {
+            if (m_windows[i].image_index)
+                m_drawn_windows.push_back(i);
+        }
+
+        // The render targets are bound each frame, arriving undefined from acquisition, or from the timeline wait
+        // for an offscreen target, and leaving ready for presentation or readback
+        graph::RenderGraph render_graph;
+        std::vector<graph::ImageHandle> render_targets;
+        for (std::size_t i = 0; i < (isHeadless() ? 1 : m_drawn_windows.size()); ++i) {
+            render_targets.push_back(render_graph.importImage(
+                i == 0 ? std::string{ "render_target" } : std::format("render_target_{}", i),
+                isHeadless() ? graph::ResourceState{ }
+                             : graph::ResourceState{ vk::PipelineStageFlagBits2::eColorAttachmentOutput },
+                isHeadless() ? graph::ResourceState{ vk::PipelineStageFlagBits2::eAllTransfer,
+                                                     vk::AccessFlagBits2::eTransferRead,
+                                                     vk::ImageLayout::eTransferSrcOptimal }
+                             : graph::ResourceState{ vk::PipelineStageFlagBits2::eNone,
+                                                     vk::AccessFlagBits2::eNone,
+                                                     vk::ImageLayout::ePresentSrcKHR }));
+        }
+
+        // Each render target is drawn by its own pass, those after the first with their own view
+        std::vector<graph::BufferUse> draw_buffers;
+        vk::RenderingFlags draw_flags{ };
+        std::function<void(const vk::CommandBuffer&, std::size_t)> record_draws;
+        graph::RenderGraph compute_graph;
+        if (m_gpu_driven) {
+            // Reset the draw count, cull the objects into draw commands, then draw the survivors indirectly. The
+            // draw commands and count are bound to the frame slot's buffers each frame.
+            const auto objects{ render_graph.importBuffer("objects", m_culling->getObjectBuffer()) };
+            m_draw_buffers = { render_graph.importBuffer("draw_commands"), render_graph.importBuffer("draw_count") };
+            if (usesAsyncCompute()) {
+                // Cull on the compute queue, which hands the draw commands over to the graphics queue
+                const auto compute_objects{ compute_graph.importBuffer("objects", m_culling->getObjectBuffer()) };
+                m_compute_draw_buffers = {
+                    compute_graph.importBuffer("draw_commands"),
+                    compute_graph.importBuffer("draw_count")
+                };
+                addCullingPasses(compute_graph, compute_objects, m_compute_draw_buffers);
+                compute_graph.addPass({
+                    .name = "release_draws",
+                    .buffers = {
+                        { m_compute_draw_buffers.draws, graph::Access::StorageRead },
+                        { m_compute_draw_buffers.draw_count, graph::Access::StorageRead }
+                    },
+                    .side_effects = true,
+                    .record = [this](const vk::CommandBuffer& command_buffer) {
+                        m_culling->recordRelease(command_buffer,
+                                                 m_current_frame,
+                                                 m_scheduler->getFamilyIndex(sched::QueueType::Compute),
+                                                 m_scheduler->getFamilyIndex(sched::QueueType::Graphics));
+                    }
+                });
+                compute_graph.compile(m_device, *m_allocator);
+
+                render_graph.addPass({
+                    .name = "acquire_draws",
+                    .buffers = {
+                        { m_draw_buffers.draws, graph::Access::IndirectRead },
+                        { m_draw_buffers.draw_count, graph::Access::IndirectRead }
+                    },
+                    .side_effects = true,
+                    .record = [this](const vk::CommandBuffer& command_buffer) {
+                        m_culling->recordAcquire(command_buffer,
+                                                 m_current_frame,
+                                                 m_scheduler->getFamilyIndex(sched::QueueType::Compute),
+                                                 m_scheduler->getFamilyIndex(sched::QueueType::Graphics));
+                    }
+                });
+            } else {
+                addCullingPasses(render_graph, objects, m_draw_buffers);
+            }
+            draw_buffers = {
+                { objects, graph::Access::VertexRead },
+                { m_draw_buffers.draws, graph::Access::IndirectRead },
+                { m_draw_buffers.draw_count, graph::Access::IndirectRead }
+            };
+            record_draws = [this](const vk::CommandBuffer& command_buffer, const std::size_t render_target) {
+                cmd::recordIndirectDraws(command_buffer,
+                                         m_indirect_pipeline.get(),
+                                         m_mesh,
+                                         getTargetExtent(render_target),
+                                         *m_culling,
+                                         m_current_frame);
+            };
+        } else if (usesParallelRecording()) {
+            // The draws are recorded into secondary command buffers on worker threads before the graph executes
+            draw_flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+            record_draws = [this](const vk::CommandBuffer& command_buffer, std::size_t) {
+                command_buffer.executeCommands(m_secondary_command_buffers);
+            };
+        } else {
+            record_draws = [this](const vk::CommandBuffer& command_buffer, const std::size_t render_target) {
+                cmd::recordDraws(command_buffer,
+                                 m_graphics_pipeline.get(),
+                                 *m_descriptor_heap,
+                                 m_mesh,
+                                 getTargetExtent(render_target),
+                                 m_scene,
+                                 m_visible_draws);
+            };
+        }
+        for (std::size_t i = 0; i < render_targets.size(); ++i) {
+            render_graph.addPass({
+                .name = i == 0 ? std::string{ "draw" } : std::format("draw_{}", i),
+                .color_attachments = { { render_targets[i], vk::ClearColorValue{ 0.0f, 0.0f, 0.0f, 1.0f } } },
+                .buffers = draw_buffers,
+                .rendering_flags = draw_flags,
+                .record = [this, i, record_draws](const vk::CommandBuffer& command_buffer) {
+                    if (i > 0) {
+                        cmd::bindFrameResources(command_buffer,
+                                                { &*m_descriptor_heap, &*m_uniform_ring, m_target_uniforms[i] },
+                                                desc::GRAPHICS_BIND_POINTS);
+                    }
+                    record_draws(command_buffer, i);
+                }
+            });
+        }
+
+        // Copy the first render target into the capture's readback ring, before it is presented
+        if (m_capture) {
+            render_graph.addPass({
+                .name = "capture",
+                .images = { { render_targets.front(), graph::Access::TransferRead } },
+                .side_effects = true,
+                .record = [this](const vk::CommandBuffer& command_buffer) {
+                    m_capture->recordCopy(command_buffer,
+                                          m_render_graph.getImage(m_render_targets.front()),
+                                          getTargetExtent(0),
+                                          m_frame_number);
+                }
+            });
+        }
+        render_graph.compile(m_device, *m_allocator);
+
+        // Frames in flight may still use the previous graph's transient images, so it is retired rather than destroyed
+        const auto retired_after{ m_scheduler->getSubmittedValue(sched::QueueType::Graphics) };
+        m_retired_render_graphs.push_back({ std::exchange(m_render_graph, std::move(render_graph)), retired_after });
+        m_retired_render_graphs.push_back({ std::exchange(m_compute_graph, std::move(compute_graph)), retired_after });
+        m_render_targets = std::move(render_targets);
+        m_render_graph_dirty = false;
+
+        // Commands recorded against the previous graph reference its passes and resources
+        m_command_cache->invalidate();
+    }
+
+    void Engine::addCullingPasses(graph::RenderGraph& render_graph,
+                                  const graph::BufferHandle objects,
+                                  const DrawBufferHandles& draw_buffers)
+    {
+        render_graph.addPass({
+            .name = "reset_draw_count",
+            .buffers = { { draw_buffers.draw_count, graph::Access::TransferWrite } },
+            .record = [this](const vk::CommandBuffer& command_buffer) {
+                m_culling->recordReset(command_buffer, m_current_frame);
+            }
+        });
+        render_graph.addPass({
+            .name = "cull",
+            .buffers = {
+                { objects, graph::Access::StorageRead },
+                { draw_buffers.draws, graph::Access::StorageWrite },
+                { draw_buffers.draw_count, graph::Access::StorageReadWrite }
+            },
+            .record = [this](const vk::CommandBuffer& command_buffer) {
+                m_culling->recordDispatch(command_buffer, m_mesh.index_count, m_current_frame);
+            }
+        });
+    }
+
+    std::uint64_t Engine::submitCompute(const std::uint64_t upload_complete)
+    {
+        const auto& command_buffer{ m_compute_command_buffers[m_current_frame] };
+        {
+            const auto record_timer{ m_profiler.scope(prof::Phase::Record) };
+            command_buffer->reset();
+            m_compute_graph.bindBuffer(m_compute_draw_buffers.draws, m_culling->getDrawBuffer(m_current_frame));
+            m_compute_graph.bindBuffer(m_compute_draw_buffers.draw_count, m_culling->getCountBuffer(m_current_frame));
+            cmd::recordComputeFrame(command_buffer.get(), m_frame_bindings, m_compute_graph);
+        }
 
-        // Generate the queue handles
-        m_graphics_queue = m_device->getQueue(m_gpu.getGraphicsFamilyIndex(), 0);
-        m_present_queue = m_device->getQueue(m_gpu.getPresentFamilyIndex(), 0);
-
-        // Create the graphics pipeline object
-        const auto dynamic_rendering_info = vk::PipelineRenderingCreateInfo()
-            .setColorAttachmentFormats(color_format);
-        m_pipeline_layout = vk::SharedPipelineLayout{ pipe::createPipelineLayout(m_device), m_device };
-        m_graphics_pipeline = vk::SharedPipeline{
-            pipe::createGraphicsPipeline(m_device,
-                                         m_pipeline_layout,
-                                         dynamic_rendering_info),
-            m_device
+        // The slot's previous graphics submission, which read its draw commands, was waited on before recording,
+        // so only the objects' upload is waited on
+        const std::array command_buffers{ command_buffer.get() };
+        const std::array queue_waits{
+            sched::QueueWait{ sched::QueueType::Transfer, upload_complete, vk::PipelineStageFlagBits2::eComputeShader }
         };
+        const auto submit_timer{ m_profiler.scope(prof::Phase::Submit) };
+        return m_scheduler->submit(sched::QueueType::Compute, command_buffers, queue_waits);
+    }
+
+    pipe::PipelineHandle Engine::requestPipeline(pipe::GraphicsPipelineDesc desc)
+    {
+        desc.color_format = m_color_format;
+        return m_pipeline_registry->request(desc);
+    }
+
+    void Engine::initDevice(const std::span<const char* const> required_device_extensions,
+                            const vk::SurfaceKHR& surface)
+    {
+        // Select the candidate GPU, from the snapshot of an earlier run if the devices and drivers are unchanged
+        auto stage_begin{ std::chrono::steady_clock::now() };
+        const auto candidate_devices{ m_vk_instance->enumeratePhysicalDevices() };
+        auto [ gpu, from_snapshot, probed_devices ]{
+            init::selectSuitableGPU(candidate_devices, required_device_extensions, surface) };
+        m_gpu = std::move(gpu);
+        m_startup_timings.device_selection_ms = lapMilliseconds(stage_begin);
+        m_startup_timings.device_snapshot_hit = from_snapshot;
+        m_startup_timings.probed_devices = probed_devices;
+
+        // Create the logical device
+        m_device = vk::SharedDevice{ m_gpu.createLogicalDevice(required_device_extensions) };
+
+        // Load the device's entry points, so device-level calls skip the loader's trampolines and extension functions
+        // the loader does not export, such as vkWaitForPresentKHR, can be called
+        vk::detail::defaultDispatchLoaderDynamic.init(m_device.get());
+
+        // Presents are only tagged and waited on if the device enabled presentId and presentWait, and the driver
+        // provided the entry point
+        m_present_wait = m_gpu.supportsPresentWait()
+                      && vk::detail::defaultDispatchLoaderDynamic.vkWaitForPresentKHR != nullptr;
+        m_allocator.emplace(m_device, m_gpu);
+
+        // Retrieve the queue handles, work is submitted through the scheduler and only presentation bypasses it
+        m_scheduler.emplace(m_device, m_gpu);
+        if (m_gpu.supportsPresentationQueues())
+            m_present_queue = m_device->getQueue(m_gpu.getPresentFamilyIndex(), 0);
+        m_startup_timings.device_creation_ms = lapMilliseconds(stage_begin);
+    }
+
+    void Engine::initRenderingResources(const vk::Format color_format, const std::uint32_t frames_in_flight)
+    {
+        auto stage_begin{ std::chrono::steady_clock::now() };
+
+        // Load the on-disk pipeline cache, so previously compiled pipelines skip driver compilation,
+        // and create the shader module cache shared by all pipeline variants
+        m_pipeline_cache.emplace(m_device, m_gpu);
+        m_shader_cache.emplace(m_device);
+
+        // Queue compilation of the default graphics pipeline, which continues while the remaining resources are created
+        m_color_format = color_format;
+        m_uniform_ring.emplace(m_device, *m_allocator, m_gpu, frames_in_flight);
+        const std::array additional_set_layouts{ m_uniform_ring->getSetLayout() };
+        m_descriptor_heap.emplace(m_device, m_gpu, frames_in_flight, desc::HeapCapacity{ }, additional_set_layouts);
+        m_pipeline_layout = m_descriptor_heap->getPipelineLayout();
+        m_pipeline_registry.emplace(m_device, m_pipeline_layout, *m_pipeline_cache, *m_shader_cache, m_thread_pool);
+        m_graphics_pipeline = requestPipeline({ .state = DEFAULT_PIPELINE });
 
         // Create the command pool
         m_command_pool = vk::SharedCommandPool{ m_device->createCommandPool({
                 vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
                 m_gpu.getGraphicsFamilyIndex()
             }), m_device };
+        dbg::setObjectName(m_device, m_command_pool.get(), "graphics command pool");
+
+        // Create the per-frame resource ring
+        m_frames = frame::createFrameResources(m_device, m_command_pool, frames_in_flight);
+        m_command_cache.emplace(m_device, m_command_pool, frames_in_flight);
+
+        // Create the per-frame command buffers culling is recorded into when it runs on the compute queue
+        m_compute_command_pool = vk::SharedCommandPool{ m_device->createCommandPool({
+                vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                m_gpu.getComputeFamilyIndex()
+            }), m_device };
+        dbg::setObjectName(m_device, m_compute_command_pool.get(), "compute command pool");
+        for (std::uint32_t i = 0; i < frames_in_flight; ++i) {
+            m_compute_command_buffers.emplace_back(cmd::allocateCommandBuffer(m_device, m_compute_command_pool),
+                                                   m_device,
+                                                   m_compute_command_pool);
+            dbg::setObjectName(m_device, m_compute_command_buffers.back().get(), "frame {} compute commands", i);
+        }
+
+        // Create the per-frame, per-worker command pools draws are recorded into in parallel
+        m_recorder.emplace(m_device, m_gpu.getGraphicsFamilyIndex(), frames_in_flight);
+
+        // Create the profiler, which reserves a pair of timestamp queries per frame slot
+        m_profiler = prof::Profiler{ m_device, m_gpu, frames_in_flight };
+
+        // Create the staging ring, with a spare submission so uploads for the next frame never wait on the
+        // oldest frame in flight, then upload the default mesh
+        m_staging.emplace(m_device, *m_allocator, *m_scheduler, frames_in_flight + 1);
+        const auto mesh_data{ mesh::createTriangleMesh(m_workload.triangle_count) };
+        m_mesh_radius = mesh::computeBoundingRadius(mesh_data);
+        m_mesh = uploadMesh(mesh_data);
+        m_scene = scene::Scene{ cull::createObjectGrid(m_workload.draw_count, m_mesh_radius) };
 
-        // Allocate the command buffer
-        const vk::CommandBuffer command_buffer{ m_device->allocateCommandBuffers(vk::CommandBufferAllocateInfo()
-            .setCommandPool( m_command_pool )
-            .setLevel( vk::CommandBufferLevel::ePrimary )
-            .setCommandBufferCount( 1 )
-        )[0] };
-        m_command_buffer = vk::SharedCommandBuffer{ command_buffer, m_device, m_command_pool };
+        // Create the culler, which splits large scenes across its own workers
+        m_scene_culler.emplace();
 
-        // Create synchronization primitives
-        m_image_available = vk::SharedSemaphore{ m_device->createSemaphore({}), m_device };
-        m_render_finished = vk::SharedSemaphore{ m_device->createSemaphore({}), m_device };
-        m_in_flight = vk::SharedFence{ m_device->createFence({vk::FenceCreateFlagBits::eSignaled}), m_device };
+        // Rendering resources are created last, completing startup
+        m_startup_timings.rendering_resources_ms = lapMilliseconds(stage_begin);
+        m_startup_timings.total_ms = std::chrono::duration<double, std::milli>{
+            std::chrono::steady_clock::now() - m_startup_begin }.count();
     }
 
-    void Engine::drawFrame(const vk::Extent2D& window_extent)
+    void Engine::initWindowTarget(WindowTarget& target, const std::uint32_t frames_in_flight)
     {
-        // Wait for the previous frame to finish
-        if (const auto result{ m_device->waitForFences(m_in_flight.get(), true, std::numeric_limits<uint64_t>::max()) };
-            result != vk::Result::eSuccess)
-                throw std::runtime_error("failure at \"inFlight\" fence condition");
-        m_device->resetFences(m_in_flight.get());
+        // The GPU was selected for the first window's surface, so every other window's is checked against it
+        if (!m_gpu.getDevice().getSurfaceSupportKHR(m_gpu.getPresentFamilyIndex(), target.surface.get())
+            || !m_gpu.meetsSwapChainRequirements(target.surface.get()))
+            throw std::runtime_error("selected GPU cannot present to the window's surface");
 
-        // Attempt to acquire the next swapchain image
-        const auto acquire_image_result{ m_device->acquireNextImageKHR(m_swapchain.get(),
-                                                                       std::numeric_limits<uint64_t>::max(),
-                                                                       m_image_available.get()) };
-        if (acquire_image_result.result != vk::Result::eSuccess)
-            throw std::runtime_error("failed to acquire swapchain image");
-        const auto image_index{ acquire_image_result.value };
+        // Every pipeline targets a single color format, so every window must share it
+        target.window_extent = util::toExtent2D(target.window.getFramebufferSize());
+        if (const auto color_format{ createSwapchainResources(target) }; m_color_format == vk::Format::eUndefined)
+            m_color_format = color_format;
+        else if (color_format != m_color_format)
+            throw std::runtime_error("window's swapchain color format differs from the engine's");
+        target.image_available = frame::createAcquireSemaphores(m_device, frames_in_flight);
+    }
 
-        // Record and submit draw command
-        cmd::recordDrawCommand(m_command_buffer,
-                               m_graphics_pipeline,
-                               m_image_views[image_index],
-                               m_images[image_index],
-                               window_extent);
-
-        const std::array wait_semaphores{ m_image_available.get() };
-        constexpr std::array wait_stages{ vk::PipelineStageFlags{ vk::PipelineStageFlagBits::eColorAttachmentOutput } };
-        const std::array command_buffers{ m_command_buffer.get() };
-        const std::array signal_semaphores{ m_render_finished.get() };
-        const auto submit_info = vk::SubmitInfo()
-            .setWaitSemaphores( wait_semaphores )
-            .setWaitDstStageMask( wait_stages )
-            .setCommandBuffers( command_buffers )
-            .setSignalSemaphores( signal_semaphores );
-        m_graphics_queue.submit(submit_info, m_in_flight);
-
-        // Present the image to the screen
-        const std::array swapchains{ m_swapchain.get() };
-        if (m_present_queue.presentKHR({ signal_semaphores, swapchains, image_index })
-            != vk::Result::eSuccess)
-            throw std::runtime_error("failed to present swapchain image");
+    vk::Format Engine::createSwapchainResources(WindowTarget& target, const vk::SwapchainKHR& old_swapchain)
+    {
+        const auto [ color_format, extent, present_mode, swapchain, images, image_views ]{
+            swap::createSwapchain(m_gpu,
+                                  m_device,
+                                  target.surface,
+                                  target.window_extent,
+                                  vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                                  m_present_config,
+                                  old_swapchain) };
+        target.swapchain = vk::SharedSwapchainKHR{ swapchain, m_device, target.surface };
+        target.extent = extent;
+        target.present_mode = present_mode;
+        m_extent = m_windows.front().extent;
+
+        // Present ids are scoped to a swapchain, so presents to an earlier swapchain are never waited on
+        target.first_present_id = target.present_id + 1;
+        target.pending_presents.clear();
+
+        // Convert the swapchain images and views to shared handles, and create the per-image present semaphores
+        target.images.reserve(images.size());
+        std::ranges::transform( images,
+                                std::back_inserter(target.images),
+                                [this](const vk::Image image ) {
+                                    return vk::SharedImage{ image, m_device, vk::SwapchainOwns::yes };
+                                } );
+
+        target.image_views.reserve(image_views.size());
+        std::ranges::transform( image_views,
+                                std::back_inserter(target.image_views),
+                                [this](const vk::ImageView image_view ) {
+                                    return vk::SharedImageView{ image_view, m_device };
+                                } );
+        target.render_finished = frame::createPresentSemaphores(m_device, target.images.size());
+        return color_format;
+    }
+
+    bool Engine::recreateSwapchain(WindowTarget& target)
+    {
+        // A minimized window has a zero-sized framebuffer, for which no swapchain can be created
+        const auto window_extent{ util::toExtent2D(target.window.getFramebufferSize()) };
+        if (window_extent.width == 0 || window_extent.height == 0)
+            return false;
+        target.window_extent = window_extent;
+
+        // Frames in flight may still reference the old swapchain's images, views and semaphores, so they are
+        // retired alongside it instead of waiting for the device to go idle
+        retireSwapchain(target, false);
+        if (const auto color_format{ createSwapchainResources(target, m_retired_swapchains.back().swapchain) };
+            color_format != m_color_format)
+            throw std::runtime_error("swapchain color format changed during recreation");
+        target.dirty = false;
+        m_render_graph_dirty = true;
+        return true;
+    }
+
+    void Engine::retireSwapchain(WindowTarget& target, const bool with_acquire_semaphores)
+    {
+        m_retired_swapchains.push_back({
+            std::move(target.swapchain),
+            std::exchange(target.images, {}),
+            std::exchange(target.image_views, {}),
+            std::exchange(target.render_finished, {}),
+            with_acquire_semaphores ? std::exchange(target.image_available, {}) : std::vector<vk::SharedSemaphore>{ },
+            m_scheduler->getSubmittedValue(sched::QueueType::Graphics)
+        });
+    }
+
+    void Engine::releaseRetiredResources()
+    {
+        // Retired resources were last used by graphics submissions up to the value recorded at retirement, and any
+        // compute work they were used by completed before the graphics work waiting on it
+        const auto completed{ m_scheduler->getCompletedValue(sched::QueueType::Graphics) };
+        while (!m_retired_swapchains.empty() && completed >= m_retired_swapchains.front().retired_after)
+            m_retired_swapchains.pop_front();
+        while (!m_retired_render_graphs.empty() && completed >= m_retired_render_graphs.front().retired_after)
+            m_retired_render_graphs.pop_front();
+
+        // Frames whose copies have completed are handed to the capture thread to be written out
+        if (m_capture)
+            m_capture->poll(completed);
+    }
+
+    void Engine::waitForFrameSlot(const frame::FrameResources& frame)
+    {
+        // Wait for the GPU to release this frame slot, the scheduler accounts for the time spent blocked
+        {
+            const auto wait_timer{ m_profiler.scope(prof::Phase::FrameWait) };
+            m_scheduler->wait(sched::QueueType::Graphics, frame.submitted_value);
+        }
+
+        // The slot's previous frame has completed, so its timestamps are available
+        m_profiler.collectTimestamps(m_current_frame);
+
+        releaseRetiredResources();
+    }
+
+    void Engine::buildPresentBatch()
+    {
+        auto& batch{ m_present_batch };
+        batch.acquire_waits.clear();
+        batch.present_signals.clear();
+        batch.present_semaphores.clear();
+        batch.swapchains.clear();
+        batch.image_indices.clear();
+        batch.present_ids.clear();
+        for (const auto window : m_drawn_windows) {
+            const auto& target{ m_windows[window] };
+            const auto image_index{ *target.image_index };
+            batch.acquire_waits.push_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore( target.image_available[m_current_frame].get() )
+                .setStageMask( vk::PipelineStageFlagBits2::eColorAttachmentOutput ));
+            batch.present_signals.push_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore( target.render_finished[image_index].get() )
+                .setStageMask( vk::PipelineStageFlagBits2::eAllCommands ));
+            batch.present_semaphores.push_back(target.render_finished[image_index].get());
+            batch.swapchains.push_back(target.swapchain.get());
+            batch.image_indices.push_back(image_index);
+            batch.present_ids.push_back(target.present_id + 1);
+        }
+        batch.results.assign(m_drawn_windows.size(), vk::Result::eSuccess);
+    }
+
+    void Engine::presentWindows(const std::chrono::steady_clock::time_point frame_start)
+    {
+        // Present every drawn window with one call. With present wait, each present is tagged with an id so later
+        // frames can wait for it to be displayed.
+        const auto present_timer{ m_profiler.scope(prof::Phase::Present) };
+        auto& batch{ m_present_batch };
+        const auto present_id_info = vk::PresentIdKHR().setPresentIds( batch.present_ids );
+        auto present_info = vk::PresentInfoKHR()
+            .setWaitSemaphores( batch.present_semaphores )
+            .setSwapchains( batch.swapchains )
+            .setImageIndices( batch.image_indices )
+            .setResults( batch.results );
+        if (m_present_wait) {
+            present_info.setPNext( &present_id_info );
+            for (const auto window : m_drawn_windows) {
+                auto& target{ m_windows[window] };
+                target.pending_presents.push_back({ ++target.present_id, frame_start });
+            }
+        }
+
+        // Each swapchain reports its own result, a suboptimal or out-of-date swapchain is recreated next frame
+        try {
+            static_cast<void>(m_present_queue.presentKHR(present_info));
+        } catch (const vk::OutOfDateKHRError&) {
+            // The per-swapchain results identify which windows are out of date
+        }
+        for (std::size_t i = 0; i < m_drawn_windows.size(); ++i) {
+            if (batch.results[i] != vk::Result::eSuccess)
+                m_windows[m_drawn_windows[i]].dirty = true;
+        }
+    }
+
+    void Engine::waitForQueuedPresents(WindowTarget& target)
+    {
+        // Wait until at most the configured number of presents, including this frame's, will be pending
+        const auto max_queued{ static_cast<std::uint64_t>(m_present_config.max_queued_presents) };
+        if (!m_present_wait || max_queued == 0 || target.present_id + 1 <= max_queued)
+            return;
+        const auto target_id{ target.present_id + 1 - max_queued };
+        if (target_id < target.first_present_id)
+            return;
+
+        {
+            const auto wait_timer{ m_profiler.scope(prof::Phase::PresentWait) };
+            try {
+                const auto result{ m_device->waitForPresentKHR(target.swapchain.get(),
+                                                               target_id,
+                                                               static_cast<std::uint64_t>(PRESENT_WAIT_TIMEOUT.count())) };
+                if (result == vk::Result::eTimeout)
+                    return;
+                if (result == vk::Result::eSuboptimalKHR)
+                    target.dirty = true;
+            } catch (const vk::OutOfDateKHRError&) {
+                target.dirty = true;
+                return;
+            }
+        }
+
+        // The awaited present has just reached the display, measuring the latency of the frame which produced it
+        const auto presented{ std::chrono::steady_clock::now() };
+        while (!target.pending_presents.empty() && target.pending_presents.front().present_id <= target_id) {
+            if (const auto& [ present_id, frame_start ]{ target.pending_presents.front() }; present_id == target_id)
+                m_profiler.record(prof::Phase::PresentLatency,
+                                  std::chrono::duration<double, std::milli>{ presented - frame_start }.count());
+            target.pending_presents.pop_front();
+        }
+    }
+
+    std::optional<std::uint32_t> Engine::acquireNextImage(WindowTarget& target)
+    {
+        // Attempt to acquire the next swapchain image, a suboptimal image is still rendered to and presented
+        const auto acquire_timer{ m_profiler.scope(prof::Phase::Acquire) };
+        try {
+            const auto acquire_image_result{ m_device->acquireNextImageKHR(target.swapchain.get(),
+                                                                           std::numeric_limits<uint64_t>::max(),
+                                                                           target.image_available[m_current_frame].get()) };
+            if (acquire_image_result.result == vk::Result::eSuboptimalKHR)
+                target.dirty = true;
+            else if (acquire_image_result.result != vk::Result::eSuccess)
+                throw std::runtime_error("failed to acquire swapchain image");
+            return acquire_image_result.value;
+        } catch (const vk::OutOfDateKHRError&) {
+            return std::nullopt;
+        }
     }
 }
@@ -1,5 +1,12 @@
 module;
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+
 #include "vkfw/vkfw.hpp"
 
 export module engine;
@@ -11,6 +18,27 @@ import vulkan_hpp;
 // Internal Dependencies
 import init;
 import gpu;
+import allocator;
+import capture;
+import mesh;
+import staging;
+import frame;
+import parallel_recorder;
+import profiler;
+import command;
+import culling;
+import debug_utils;
+import descriptor_heap;
+import pipeline;
+import pipeline_cache;
+import pipeline_registry;
+import queue_scheduler;
+import render_graph;
+import scene;
+import shader_cache;
+import swapchain;
+import thread_pool;
+import uniform_ring;
 import vulkan_utils;
 
 namespace eng {
@@ -18,34 +46,542 @@ namespace eng {
     public:
         /* Constructors */
 
-        explicit Engine(const vkfw::Window& window);
+        /**
+         * Creates the rendering engine and presents to the passed-in window
+         * @param window the window whose surface will be rendered to
+         * @param frames_in_flight the number of frames the CPU may record while the GPU is still rendering
+         * @param present_config the presentation policy, swapchain image count and present queue depth
+         */
+        explicit Engine(const vkfw::Window& window,
+                        std::uint32_t frames_in_flight = frame::DEFAULT_FRAMES_IN_FLIGHT,
+                        const swap::PresentConfig& present_config = { })
+            : Engine(std::span{ &window, 1 }, frames_in_flight, present_config)
+        {}
+
+        /**
+         * Creates the rendering engine and presents to several windows, which share the device, the pipelines and
+         * the allocator. Each frame draws every window in one submission, and presents them with one present call.
+         * @param windows the windows whose surfaces will be rendered to, the GPU is selected for the first
+         * @param frames_in_flight the number of frames the CPU may record while the GPU is still rendering
+         * @param present_config the presentation policy, swapchain image count and present queue depth
+         * @throws std::invalid_argument if no window is passed
+         * @throws std::runtime_error if the GPU cannot present to every window in the same format
+         */
+        explicit Engine(std::span<const vkfw::Window> windows,
+                        std::uint32_t frames_in_flight = frame::DEFAULT_FRAMES_IN_FLIGHT,
+                        const swap::PresentConfig& present_config = { });
+
+        /**
+         * Creates a headless rendering engine which renders into offscreen images rather than a swapchain,
+         * allowing the engine to run on machines with no display or window system (e.g., with a software ICD)
+         * @param extent the extent of the offscreen render targets
+         * @param frames_in_flight the number of frames the CPU may record while the GPU is still rendering
+         */
+        explicit Engine(const vk::Extent2D& extent,
+                        std::uint32_t frames_in_flight = frame::DEFAULT_FRAMES_IN_FLIGHT);
+
+        /* Destructor */
+
+        // Frames may still be in flight on destruction, so the device must be drained before the
+        // pipeline cache is persisted and the resources are released
+        ~Engine();
 
         /* Rendering Calls */
 
-        void drawFrame(const vk::Extent2D& window_extent);
+        // Draws and presents a frame to every window, recreating out-of-date swapchains first. Minimized windows are
+        // skipped, and no frame is drawn while every window is minimized.
+        void drawFrame();
+
+        // Blocks until all submitted frames and uploads have finished executing
+        void waitIdle()
+        { m_scheduler->waitIdle(); }
+
+        /* Capture Methods */
+
+        /**
+         * Starts copying every frame's render target to the capture's readback ring, to be written out on a
+         * background thread. Frames larger than the current extent are dropped, as are frames arriving while every
+         * readback buffer is busy unless configured to stall instead. Replaces any capture in progress.
+         * @param config the output and readback ring configuration
+         * @throws std::invalid_argument if the render targets do not have four 8-bit channels
+         */
+        void startCapture(const capture::CaptureConfig& config);
+
+        /**
+         * Stops capturing, blocking until the frames already rendered have been written out
+         * @return the final statistics of the capture, empty if not capturing
+         */
+        capture::CaptureStatistics stopCapture();
+
+        /* Window Methods */
+
+        /**
+         * Starts presenting to another window, drawn from the next frame onwards
+         * @param window the window, whose surface must support the engine's GPU and color format
+         * @return the index of the window
+         * @throws std::logic_error if the engine is headless
+         * @throws std::runtime_error if the GPU cannot present to the window in the engine's color format
+         */
+        std::uint32_t addWindow(const vkfw::Window& window);
+
+        /**
+         * Stops presenting to a window, retiring its swapchain once frames in flight have completed. The indices of
+         * later windows shift down by one.
+         * @param index the index of the window
+         * @throws std::invalid_argument if there is no such window
+         * @throws std::logic_error if it is the only window
+         */
+        void removeWindow(std::uint32_t index);
+
+        /* Pipeline Methods */
+
+        /**
+         * Requests a pipeline variant targeting the engine's render targets, compiling it asynchronously if new
+         * @param desc the pipeline description, its color format is replaced with that of the render targets
+         * @return a handle which resolves once the variant has been compiled
+         */
+        [[nodiscard]] pipe::PipelineHandle requestPipeline(pipe::GraphicsPipelineDesc desc);
+
+        /**
+         * Switches the pipeline used for drawing. The first frame drawn with the new pipeline blocks
+         * until its compilation has finished.
+         * @param pipeline a handle returned by requestPipeline
+         */
+        void setPipeline(const pipe::PipelineHandle& pipeline)
+        {
+            m_graphics_pipeline = pipeline;
+            m_command_cache->invalidate();
+        }
+
+        /* Mesh Methods */
+
+        /**
+         * Creates device-local buffers for a mesh and queues its upload through the staging ring. The upload is
+         * submitted with the next frame, which waits for it before reading the mesh.
+         * @param mesh_data the vertices and indices to upload
+         * @return the mesh, ready to be drawn from the next frame onwards
+         */
+        [[nodiscard]] mesh::Mesh uploadMesh(const mesh::MeshData& mesh_data);
+
+        /**
+         * Replaces the mesh drawn each frame, blocking until frames using the previous mesh have completed
+         * @param mesh a mesh returned by uploadMesh
+         */
+        void setMesh(mesh::Mesh mesh);
+
+        /* Mutators */
+
+        // Sets the per-frame workload, regenerating the drawn mesh if the triangle count has changed
+        void setWorkload(const cmd::DrawWorkload& workload);
+
+        /**
+         * Switches between culling the objects on the CPU and recording a draw call per visible object, and
+         * GPU-driven rendering, where the objects are culled in a compute pass and drawn with a single indirect draw.
+         * Switching on uploads a grid of objects, one per draw call of the workload, blocking until in-flight frames
+         * have completed.
+         * @param enabled true to render GPU-driven
+         * @throws std::runtime_error if the GPU does not support indirect count draws
+         */
+        void setGpuDriven(bool enabled);
+
+        // Enables or disables splitting large draw workloads across worker threads during recording
+        void setParallelRecording(bool enabled);
+
+        // Changes the presentation policy, recreating every swapchain before the next frame
+        void setPresentConfig(const swap::PresentConfig& present_config);
+
+        // Caps the rate at which frames start, a rate of zero removes the cap
+        void setFrameLimit(double frames_per_second);
+
+        /**
+         * Enables or disables command caching, where each frame slot and image keeps the command buffer it last
+         * recorded and resubmits it unchanged until the pipeline, the mesh, the render graph or the visible objects
+         * change, making a static frame's recording nearly free. Frames are recorded every frame regardless while
+         * culling runs on the graphics queue or frames are captured, as their commands change every frame, and while
+         * presenting to several windows, as the images acquired from each vary independently.
+         */
+        void setCommandCaching(bool enabled);
+
+        /**
+         * Enables or disables culling on the dedicated compute queue while GPU-driven, so the next frame's culling
+         * overlaps with the previous frame's rendering. Without a dedicated compute queue, culling always runs on
+         * the graphics queue.
+         */
+        void setAsyncCompute(bool enabled);
+
+        /* Accessors */
+
+        [[nodiscard]] bool isHeadless() const
+        { return m_windows.empty(); }
+
+        // Returns the extent of the offscreen targets, or of the first window's swapchain
+        [[nodiscard]] const vk::Extent2D& getExtent() const
+        { return m_extent; }
+
+        [[nodiscard]] std::uint32_t getWindowCount() const
+        { return static_cast<std::uint32_t>(m_windows.size()); }
+
+        [[nodiscard]] const vk::Extent2D& getWindowExtent(const std::uint32_t index) const
+        { return m_windows.at(index).extent; }
+
+        [[nodiscard]] const GPU& getGPU() const
+        { return m_gpu; }
+
+        [[nodiscard]] const cmd::DrawWorkload& getWorkload() const
+        { return m_workload; }
+
+        [[nodiscard]] bool isGpuDriven() const
+        { return m_gpu_driven; }
+
+        [[nodiscard]] bool isParallelRecording() const
+        { return m_parallel_recording; }
+
+        [[nodiscard]] const swap::PresentConfig& getPresentConfig() const
+        { return m_present_config; }
+
+        // Returns the present mode the policy resolved to for the first window, or FIFO if headless
+        [[nodiscard]] vk::PresentModeKHR getPresentMode() const
+        { return isHeadless() ? vk::PresentModeKHR::eFifo : m_windows.front().present_mode; }
+
+        [[nodiscard]] const swap::FrameLimiter& getFrameLimiter() const
+        { return m_frame_limiter; }
+
+        [[nodiscard]] bool isCommandCaching() const
+        { return m_command_caching; }
+
+        // Returns true if frames currently resubmit their cached command buffers while unchanged
+        [[nodiscard]] bool usesCommandCaching() const
+        {
+            return m_command_caching
+                && !m_capture
+                && m_windows.size() <= 1
+                && (!m_gpu_driven || usesAsyncCompute());
+        }
+
+        [[nodiscard]] const frame::CommandCacheStatistics& getCommandCacheStatistics() const
+        { return m_command_cache->getStatistics(); }
+
+        void resetCommandCacheStatistics()
+        { m_command_cache->resetStatistics(); }
+
+        [[nodiscard]] bool isAsyncCompute() const
+        { return m_async_compute; }
+
+        // Returns true if culling currently runs on a dedicated compute queue
+        [[nodiscard]] bool usesAsyncCompute() const
+        { return m_gpu_driven && m_async_compute && m_scheduler->isDedicated(sched::QueueType::Compute); }
+
+        [[nodiscard]] bool isCapturing() const
+        { return m_capture.has_value(); }
+
+        // Returns the statistics of the capture in progress, or empty statistics if not capturing
+        [[nodiscard]] capture::CaptureStatistics getCaptureStatistics() const
+        { return m_capture ? m_capture->getStatistics() : capture::CaptureStatistics{ }; }
+
+        [[nodiscard]] const sched::QueueScheduler& getScheduler() const
+        { return *m_scheduler; }
+
+        [[nodiscard]] sched::QueueScheduler& getScheduler()
+        { return *m_scheduler; }
+
+        [[nodiscard]] const prof::Profiler& getProfiler() const
+        { return m_profiler; }
+
+        [[nodiscard]] prof::Profiler& getProfiler()
+        { return m_profiler; }
+
+        [[nodiscard]] pipe::PipelineCacheStatistics getPipelineCacheStatistics() const
+        { return m_pipeline_cache->getStatistics(); }
+
+        [[nodiscard]] pipe::ShaderCacheStatistics getShaderCacheStatistics() const
+        { return m_shader_cache->getStatistics(); }
+
+        [[nodiscard]] const staging::StagingStatistics& getStagingStatistics() const
+        { return m_staging->getStatistics(); }
+
+        [[nodiscard]] const graph::GraphStatistics& getRenderGraphStatistics() const
+        { return m_render_graph.getStatistics(); }
+
+        [[nodiscard]] const desc::HeapStatistics& getDescriptorHeapStatistics() const
+        { return m_descriptor_heap->getStatistics(); }
+
+        [[nodiscard]] mem::MemoryStatistics getMemoryStatistics() const
+        { return m_allocator->getStatistics(); }
+
+        [[nodiscard]] mem::DeviceAllocator& getAllocator()
+        { return *m_allocator; }
+
+        [[nodiscard]] const init::StartupTimings& getStartupTimings() const
+        { return m_startup_timings; }
 
     private:
         /* Data Members */
 
+        // Declared first, so startup is timed from the creation of the instance
+        std::chrono::steady_clock::time_point   m_startup_begin{ std::chrono::steady_clock::now() };
+        init::StartupTimings                    m_startup_timings;
+
         GPU                     m_gpu;
         vk::SharedInstance      m_vk_instance;  // Stored for convenience, as Instance is owned by the Surface
-        vk::SharedSwapchainKHR  m_swapchain;    // Swapchain owns Device and Surface (stored internally)
+        dbg::DebugMessenger     m_debug_messenger;  // Empty unless built with debug utils
         vk::SharedDevice        m_device;
+        bool                    m_present_wait{ false };    // Presents are tagged with ids and waited on
+
+        /**
+         * A present tagged with an id, whose frame's latency is measured once a later frame waits for it. Only
+         * tracked with present wait.
+         */
+        struct PendingPresent
+        {
+            std::uint64_t                           present_id;
+            std::chrono::steady_clock::time_point   frame_start;
+        };
+
+        /**
+         * A window presented to, with its surface and swapchain. Every window is drawn by the frame's single command
+         * buffer, and presented by the frame's single present call.
+         */
+        struct WindowTarget
+        {
+            vkfw::Window                        window;
+            vk::SharedSurfaceKHR                surface;
+            vk::SharedSwapchainKHR              swapchain;      // Swapchain owns Device and Surface (stored internally)
+            vk::Extent2D                        window_extent;  // The framebuffer size the swapchain was created for
+            vk::Extent2D                        extent;         // The extent of the swapchain images
+            vk::PresentModeKHR                  present_mode{ vk::PresentModeKHR::eFifo };
+            std::vector<vk::SharedImage>        images;
+            std::vector<vk::SharedImageView>    image_views;
+            std::vector<vk::SharedSemaphore>    image_available;    // Indexed by frame slot
+            std::vector<vk::SharedSemaphore>    render_finished;    // Indexed by swapchain image
+            std::optional<std::uint32_t>        image_index;        // The image acquired by the current frame, if any
+            bool                                dirty{ false };     // Recreated before the next acquisition
+            bool                                minimized{ false }; // Skipped by frames until restored
+
+            std::deque<PendingPresent>  pending_presents;
+            std::uint64_t               present_id{ 0 };        // The id of the latest present
+            std::uint64_t               first_present_id{ 1 };  // The id of the current swapchain's first present
+        };
+        std::vector<WindowTarget>   m_windows;  // Empty when headless
 
-        std::vector<vk::SharedImage>        m_images;
+        swap::PresentConfig         m_present_config;
+        swap::FrameLimiter          m_frame_limiter;
+
+        /**
+         * A swapchain replaced by recreation or whose window was removed, together with the resources which
+         * referenced it. These are kept until every frame submitted before the replacement has completed.
+         */
+        struct RetiredSwapchain
+        {
+            vk::SharedSwapchainKHR              swapchain;
+            std::vector<vk::SharedImage>        images;
+            std::vector<vk::SharedImageView>    image_views;
+            std::vector<vk::SharedSemaphore>    present_semaphores;
+            std::vector<vk::SharedSemaphore>    acquire_semaphores; // Only retired with the window
+            std::uint64_t                       retired_after;  // The graphics timeline value of the last frame using it
+        };
+        std::deque<RetiredSwapchain> m_retired_swapchains;
+
+        std::optional<mem::DeviceAllocator> m_allocator;
+
+        vk::Extent2D                        m_extent;               // Of the offscreen images, or the first window
+        std::vector<mem::AllocatedImage>    m_image_allocations;    // Only populated for offscreen images
+        std::vector<vk::SharedImage>        m_images;               // Offscreen images, indexed by frame slot
         std::vector<vk::SharedImageView>    m_image_views;
 
         vk::SharedCommandPool   m_command_pool;
-        vk::SharedCommandBuffer m_command_buffer;
 
-        vk::Queue m_graphics_queue;
-        vk::Queue m_present_queue;
+        std::optional<sched::QueueScheduler>    m_scheduler;    // Submits to the graphics, compute and transfer queues
+        vk::Queue                               m_present_queue;    // Presents every window's image at once
+
+        std::optional<staging::StagingRing> m_staging;
+        mesh::Mesh                          m_mesh;
+
+        vk::Format                              m_color_format{ vk::Format::eUndefined };
+        std::optional<pipe::PipelineCache>      m_pipeline_cache;
+        std::optional<pipe::ShaderModuleCache>  m_shader_cache;
+        std::optional<ubo::UniformRing>         m_uniform_ring;
+        std::optional<desc::DescriptorHeap>     m_descriptor_heap;
+        vk::SharedPipelineLayout                m_pipeline_layout;  // The descriptor heap's layout, shared by every pipeline
+        std::optional<pipe::PipelineRegistry>   m_pipeline_registry;
+        pipe::PipelineHandle                    m_graphics_pipeline;
+        pipe::PipelineHandle                    m_indirect_pipeline;    // Requested once GPU-driven rendering is enabled
+
+        scene::Scene                        m_scene;        // One object per draw call, placed on a grid
+        std::optional<scene::SceneCuller>   m_scene_culler; // Culls the scene each frame unless GPU-driven
+        std::span<const std::uint32_t>      m_visible_draws;    // The objects drawn by the current frame unless GPU-driven
+        std::optional<cull::CullingPass>    m_culling;      // Created once GPU-driven rendering is enabled
+        float                               m_mesh_radius{ 0.0f };  // Bounding radius of the default mesh
+        bool                                m_gpu_driven{ false };
+        bool                                m_async_compute{ true };
+
+        vk::SharedCommandPool                   m_compute_command_pool;     // Of the compute family
+        std::vector<vk::SharedCommandBuffer>    m_compute_command_buffers;  // Indexed by frame slot
+
+        std::vector<frame::FrameResources>  m_frames;
+        std::optional<frame::CommandBufferCache>    m_command_cache;    // Used instead of the slots' buffers if caching
+        bool                                        m_command_caching{ false };
+        std::uint32_t                       m_current_frame{ 0 };
+        std::uint64_t                       m_frame_number{ 0 };    // Frames submitted since creation
+
+        std::optional<cmd::ParallelRecorder>    m_recorder;
+        bool                                    m_parallel_recording{ true };
+        std::span<const vk::CommandBuffer>      m_secondary_command_buffers;    // Recorded for the current frame
+
+        /**
+         * The passes of a frame, rebuilt when the drawing mode or the render target changes. A replaced graph is
+         * kept until every frame which executed it has completed.
+         */
+        struct RetiredRenderGraph
+        {
+            graph::RenderGraph  render_graph;
+            std::uint64_t       retired_after;  // The graphics timeline value of the last frame using it
+        };
+        graph::RenderGraph                  m_render_graph;
+        graph::RenderGraph                  m_compute_graph;    // Executed on the compute queue, empty unless async
+        std::vector<graph::ImageHandle>     m_render_targets;   // The offscreen target, or one per drawn window
+        std::vector<std::uint32_t>          m_drawn_windows;    // The windows drawn by the graph, by render target
+        std::vector<std::uint32_t>          m_target_uniforms;  // The dynamic offset of each render target's view
+        bool                                m_render_graph_dirty{ true };
+
+        /**
+         * The semaphores, swapchains and images of the windows drawn by the current frame, gathered into the arrays
+         * of its submission and present call. Reused every frame, so presenting to several windows never allocates.
+         */
+        struct PresentBatch
+        {
+            std::vector<vk::SemaphoreSubmitInfo>    acquire_waits;
+            std::vector<vk::SemaphoreSubmitInfo>    present_signals;
+            std::vector<vk::Semaphore>              present_semaphores;
+            std::vector<vk::SwapchainKHR>           swapchains;
+            std::vector<std::uint32_t>              image_indices;
+            std::vector<std::uint64_t>              present_ids;
+            std::vector<vk::Result>                 results;
+        };
+        PresentBatch                        m_present_batch;
+
+        // The handles of the culling pass's draw commands and count within each graph, rebound to the current
+        // frame slot's buffers every frame
+        struct DrawBufferHandles
+        {
+            graph::BufferHandle draws;
+            graph::BufferHandle draw_count;
+        };
+        DrawBufferHandles                   m_draw_buffers;
+        DrawBufferHandles                   m_compute_draw_buffers;
+        std::deque<RetiredRenderGraph>      m_retired_render_graphs;
+
+        std::optional<capture::FrameCapture>    m_capture;      // Empty unless capturing frames
+
+        cmd::FrameBindings                      m_frame_bindings;   // Updated at the start of each frame
+        std::chrono::steady_clock::time_point   m_start_time{ std::chrono::steady_clock::now() };
+
+        cmd::DrawWorkload   m_workload;
+        prof::Profiler      m_profiler;
+
+        util::ThreadPool    m_thread_pool;  // Declared last, so pending compiles finish before anything they reference is destroyed
+
+        /* Initialization Helper Methods */
+
+        /**
+         * Selects the GPU, creates the logical device and retrieves the queue handles
+         * @param required_device_extensions the device extensions the selected GPU must support
+         * @param surface the target surface, or a null handle for a headless device
+         */
+        void initDevice(std::span<const char* const> required_device_extensions, const vk::SurfaceKHR& surface);
+
+        /**
+         * Creates the pipeline, command pool and frame resources once the render targets exist
+         * @param color_format the color format of the render targets
+         * @param frames_in_flight the depth of the frames-in-flight ring
+         */
+        void initRenderingResources(vk::Format color_format, std::uint32_t frames_in_flight);
+
+        /**
+         * Creates the swapchain and the per-slot acquire semaphores of a window whose surface has been created. The
+         * first window's color format becomes the engine's, which every later window must share.
+         * @param target the window
+         * @param frames_in_flight the depth of the frames-in-flight ring
+         * @throws std::runtime_error if the GPU cannot present to the window in the engine's color format
+         */
+        void initWindowTarget(WindowTarget& target, std::uint32_t frames_in_flight);
+
+        /**
+         * Creates a window's swapchain for its current window extent, along with its image views and semaphores
+         * @param target the window, whose previous swapchain must have been retired
+         * @param old_swapchain the swapchain being replaced, or a null handle on first creation
+         * @return the color format of the swapchain images
+         */
+        vk::Format createSwapchainResources(WindowTarget& target, const vk::SwapchainKHR& old_swapchain = {});
+
+        /* Swapchain Recreation Methods */
+
+        /**
+         * Replaces a window's swapchain, retiring the old one rather than draining the frames in flight
+         * @param target the window
+         * @return false if the window is minimized, in which case the swapchain is left unchanged
+         */
+        bool recreateSwapchain(WindowTarget& target);
+
+        // Moves a window's swapchain and the resources referencing it to the retired queue
+        void retireSwapchain(WindowTarget& target, bool with_acquire_semaphores);
+
+        // Destroys retired swapchains which no frame in flight can still reference
+        void releaseRetiredResources();
+
+        /* Frame Helper Methods */
+
+        // Waits for the slot's previous frame on the graphics timeline, then releases the resources it retired
+        void waitForFrameSlot(const frame::FrameResources& frame);
+
+        /**
+         * Acquires a window's next swapchain image, signaling the window's semaphore for the current frame slot
+         * @param target the window
+         * @return the index of the image to draw into, or std::nullopt if the swapchain is out of date
+         */
+        [[nodiscard]] std::optional<std::uint32_t> acquireNextImage(WindowTarget& target);
+
+        // Gathers the acquire and present semaphores, swapchains and images of the windows drawn by the frame
+        void buildPresentBatch();
+
+        // Presents every window drawn by the frame with one present call, marking those out of date
+        void presentWindows(std::chrono::steady_clock::time_point frame_start);
+
+        // Blocks until few enough of a window's presents are pending to start the frame, measuring the latency of
+        // those displayed
+        void waitForQueuedPresents(WindowTarget& target);
+
+        // Returns the extent of one of the graph's render targets
+        [[nodiscard]] const vk::Extent2D& getTargetExtent(std::size_t render_target) const
+        { return isHeadless() ? m_extent : m_windows[m_drawn_windows[render_target]].extent; }
+
+        // Replaces the culling pass's objects with a grid of one object per draw call of the workload
+        void uploadObjects();
+
+        // Writes each render target's camera into the uniform ring, and culls the scene against the widest, on the
+        // CPU or by pointing the culling pass's frustum at it
+        void updateFrameUniforms();
+
+        // Declares and compiles the frame's passes for the current drawing mode and render targets, drawing the
+        // windows which acquired an image
+        void buildRenderGraph();
+
+        // Adds the passes resetting the draw count and culling the objects into draw commands
+        void addCullingPasses(graph::RenderGraph& render_graph,
+                              graph::BufferHandle objects,
+                              const DrawBufferHandles& draw_buffers);
 
-        vk::SharedPipelineLayout m_pipeline_layout;
-        vk::SharedPipeline       m_graphics_pipeline;
+        // Records and submits the frame's culling to the compute queue, returning the compute timeline value
+        [[nodiscard]] std::uint64_t submitCompute(std::uint64_t upload_complete);
 
-        vk::SharedSemaphore m_image_available;
-        vk::SharedSemaphore m_render_finished;
-        vk::SharedFence     m_in_flight;
+        // Returns true if this frame's draws are recorded on worker threads into secondary command buffers, which are
+        // one-time submit and so never recorded into cached commands, nor executed once per window
+        [[nodiscard]] bool usesParallelRecording() const
+        {
+            return !m_gpu_driven
+                && m_parallel_recording
+                && !usesCommandCaching()
+                && m_windows.size() <= 1
+                && m_recorder->isWorthwhile(m_workload.draw_count);
+        }
     };
 }
@@ -0,0 +1,90 @@
+module;
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+module frame;
+
+// Internal Dependencies
+import command;
+import debug_utils;
+
+namespace eng::frame {
+    std::vector<FrameResources> createFrameResources(const vk::SharedDevice& device,
+                                                     const vk::SharedCommandPool& command_pool,
+                                                     const std::uint32_t frame_count)
+    {
+        if (frame_count == 0)
+            throw std::invalid_argument("frames-in-flight ring must hold at least one frame");
+
+        std::vector<FrameResources> frames;
+        frames.reserve(frame_count);
+        for (std::uint32_t i = 0; i < frame_count; ++i) {
+            frames.push_back({
+                vk::SharedCommandBuffer{ cmd::allocateCommandBuffer(device, command_pool), device, command_pool }
+            });
+            dbg::setObjectName(device, frames.back().command_buffer.get(), "frame {} commands", i);
+        }
+        return frames;
+    }
+
+    std::vector<vk::SharedSemaphore> createAcquireSemaphores(const vk::SharedDevice& device,
+                                                             const std::uint32_t frame_count)
+    {
+        std::vector<vk::SharedSemaphore> semaphores;
+        semaphores.reserve(frame_count);
+        for (std::uint32_t i = 0; i < frame_count; ++i) {
+            semaphores.emplace_back(device->createSemaphore({}), device);
+            dbg::setObjectName(device, semaphores.back().get(), "frame {} image available", i);
+        }
+        return semaphores;
+    }
+
+    std::vector<vk::SharedSemaphore> createPresentSemaphores(const vk::SharedDevice& device,
+                                                             const std::size_t image_count)
+    {
+        std::vector<vk::SharedSemaphore> semaphores;
+        semaphores.reserve(image_count);
+        for (std::size_t i = 0; i < image_count; ++i) {
+            semaphores.emplace_back(device->createSemaphore({}), device);
+            dbg::setObjectName(device, semaphores.back().get(), "image {} render finished", i);
+        }
+        return semaphores;
+    }
+
+    CommandBufferCache::CommandBufferCache(vk::SharedDevice device,
+                                           vk::SharedCommandPool command_pool,
+                                           const std::uint32_t frame_count)
+        : m_device{ std::move(device) },
+          m_command_pool{ std::move(command_pool) },
+          m_command_buffers(frame_count)
+    {}
+
+    CommandBufferCache::Lookup CommandBufferCache::acquire(const std::uint32_t frame_slot, const std::uint32_t image_index)
+    {
+        // Swapchain recreation may add images, but never removes the buffers of earlier ones, which may be pending
+        auto& slot_buffers{ m_command_buffers.at(frame_slot) };
+        while (slot_buffers.size() <= image_index) {
+            slot_buffers.push_back({
+                vk::SharedCommandBuffer{ cmd::allocateCommandBuffer(m_device, m_command_pool), m_device, m_command_pool }
+            });
+            dbg::setObjectName(m_device,
+                               slot_buffers.back().command_buffer.get(),
+                               "frame {} cached commands (image {})",
+                               frame_slot,
+                               slot_buffers.size() - 1);
+        }
+
+        auto& [ command_buffer, version ]{ slot_buffers[image_index] };
+        if (version == m_version) {
+            ++m_statistics.replayed;
+            return { command_buffer.get(), false };
+        }
+
+        command_buffer->reset();
+        version = m_version;
+        ++m_statistics.recorded;
+        return { command_buffer.get(), true };
+    }
+}
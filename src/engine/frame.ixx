@@ -0,0 +1,135 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+export module frame;
+
+// External Dependencies
+import vulkan_hpp;
+
+namespace eng::frame {
+    /**
+     * The number of frames the CPU may record ahead of the GPU when no depth is specified
+     */
+    export constexpr std::uint32_t DEFAULT_FRAMES_IN_FLIGHT{ 2 };
+
+    /**
+     * Represents the resources owned by a single slot in the frames-in-flight ring. A slot may not be
+     * re-recorded until the graphics timeline has reached the value its last submission signals.
+     */
+    export struct FrameResources
+    {
+        vk::SharedCommandBuffer command_buffer;
+        std::uint64_t           submitted_value{ 0 };   // The graphics timeline value of the slot's last frame
+    };
+
+    export struct CommandCacheStatistics
+    {
+        std::uint64_t recorded{ 0 };    // Frames whose command buffer was recorded
+        std::uint64_t replayed{ 0 };    // Frames which resubmitted a command buffer recorded by an earlier frame
+    };
+
+    /**
+     * Keeps a primary command buffer per frame slot and swapchain image, so a frame whose commands are unchanged
+     * resubmits the buffer recorded by an earlier frame instead of recording it again. Every buffer is recorded
+     * against a version, and is re-recorded on use once invalidated. A buffer is only ever submitted by its own
+     * frame slot, so waiting for the slot guarantees that its previous submission has completed.
+     */
+    export class CommandBufferCache
+    {
+    public:
+        /**
+         * The command buffer of a frame
+         */
+        struct Lookup
+        {
+            vk::CommandBuffer command_buffer;
+            bool needs_recording{ true };   // The buffer has been reset, and must be recorded before submission
+        };
+
+        /* Constructors */
+
+        /**
+         * Creates an empty cache, command buffers are allocated on first use
+         * @param device the logical device
+         * @param command_pool the pool the command buffers are allocated from,
+         *                     must have been created with the eResetCommandBuffer flag
+         * @param frame_count the depth of the frames-in-flight ring
+         */
+        CommandBufferCache(vk::SharedDevice device, vk::SharedCommandPool command_pool, std::uint32_t frame_count);
+
+        /* Cache Methods */
+
+        /**
+         * Looks up the command buffer of a frame, resetting it if it was recorded before the last invalidation
+         * @param frame_slot the frame's slot in the ring, whose previous submission must have completed
+         * @param image_index the index of the image rendered to
+         * @return the command buffer, and whether it must be recorded
+         */
+        [[nodiscard]] Lookup acquire(std::uint32_t frame_slot, std::uint32_t image_index);
+
+        // Marks every recorded command buffer as stale, e.g., once the passes or the resources they use change
+        void invalidate()
+        { ++m_version; }
+
+        /* Accessors */
+
+        [[nodiscard]] const CommandCacheStatistics& getStatistics() const
+        { return m_statistics; }
+
+        void resetStatistics()
+        { m_statistics = { }; }
+
+    private:
+        /* Data Members */
+
+        struct CachedCommandBuffer
+        {
+            vk::SharedCommandBuffer command_buffer;
+            std::uint64_t           version{ 0 };   // The version recorded against, zero if never recorded
+        };
+
+        vk::SharedDevice                                m_device;
+        vk::SharedCommandPool                           m_command_pool;
+        std::vector<std::vector<CachedCommandBuffer>>   m_command_buffers;  // Indexed by frame slot, then by image
+        std::uint64_t                                   m_version{ 1 };
+        CommandCacheStatistics                          m_statistics;
+    };
+
+    /* Frame Resource Creation Methods */
+
+    /**
+     * Creates the resources for each slot in the frames-in-flight ring
+     * @param device the logical device which will own the resources
+     * @param command_pool the pool from which each slot's command buffer will be allocated,
+     *                     must have been created with the eResetCommandBuffer flag
+     * @param frame_count the depth of the ring
+     * @return a vector containing the resources for each frame slot, none of which has been submitted
+     * @throws std::invalid_argument if the frame count is zero
+     */
+    export [[nodiscard]] std::vector<FrameResources>
+    createFrameResources(const vk::SharedDevice& device,
+                         const vk::SharedCommandPool& command_pool,
+                         std::uint32_t frame_count);
+
+    /**
+     * Creates one image-available semaphore per frame slot, for a swapchain's acquisitions. A slot's semaphore is
+     * reused once the graphics timeline has passed the slot's previous frame, which waited on it.
+     * @param device the logical device which will own the semaphores
+     * @param frame_count the depth of the frames-in-flight ring
+     * @return a vector of semaphores, indexed by frame slot
+     */
+    export [[nodiscard]] std::vector<vk::SharedSemaphore>
+    createAcquireSemaphores(const vk::SharedDevice& device, std::uint32_t frame_count);
+
+    /**
+     * Creates one render-finished semaphore per swapchain image. These are indexed by image rather than by
+     * frame slot, since the presentation engine may still hold a semaphore after the slot's frame has completed.
+     * @param device the logical device which will own the semaphores
+     * @param image_count the number of images in the swapchain
+     * @return a vector of semaphores, indexed by swapchain image index
+     */
+    export [[nodiscard]] std::vector<vk::SharedSemaphore>
+    createPresentSemaphores(const vk::SharedDevice& device, std::size_t image_count);
+}
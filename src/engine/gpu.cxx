@@ -17,18 +17,58 @@ namespace eng {
         queues.push_back(addDeviceQueue(this->getGraphicsFamilyIndex(), graphics_priorities));
 
         // Handle case where Graphics and Present queue are different families
-        if (this->getPresentFamilyIndex() != this->getGraphicsFamilyIndex()) {
+        if (this->supportsPresentationQueues() && this->getPresentFamilyIndex() != this->getGraphicsFamilyIndex()) {
             constexpr std::array present_priorities{ 1.0f };
             queues.push_back(addDeviceQueue(this->getPresentFamilyIndex(), present_priorities));
         }
 
-        // Instantiate logical device
-        constexpr vk::PhysicalDeviceDynamicRenderingFeatures dynamic_rendering_enabled{ true };
+        // Instantiate the dedicated compute queue, used for compute work which overlaps with rasterization
+        if (this->hasDedicatedComputeQueue()) {
+            constexpr std::array compute_priorities{ 1.0f };
+            queues.push_back(addDeviceQueue(this->getComputeFamilyIndex(), compute_priorities));
+        }
+
+        // Instantiate the dedicated transfer queue, used for uploads which overlap with rendering
+        if (this->hasDedicatedTransferQueue()) {
+            constexpr std::array transfer_priorities{ 1.0f };
+            queues.push_back(addDeviceQueue(this->getTransferFamilyIndex(), transfer_priorities));
+        }
+
+        // Enable present wait alongside the required extensions where supported
+        std::vector<const char*> extensions(required_extensions.begin(), required_extensions.end());
+        auto present_wait_enabled = vk::PhysicalDevicePresentWaitFeaturesKHR().setPresentWait( true );
+        auto present_id_enabled = vk::PhysicalDevicePresentIdFeaturesKHR()
+            .setPresentId( true )
+            .setPNext( &present_wait_enabled );
+        if (m_present_wait)
+            extensions.insert(extensions.end(), PRESENT_WAIT_EXTENSIONS.begin(), PRESENT_WAIT_EXTENSIONS.end());
+
+        // Instantiate logical device, enabling indirect count draws where supported for GPU-driven rendering,
+        // and the descriptor indexing features the bindless descriptor heap is built on
+        vk::PhysicalDeviceSynchronization2Features synchronization2_enabled{ true };
+        if (m_present_wait)
+            synchronization2_enabled.setPNext( &present_id_enabled );
+        auto dynamic_rendering_enabled = vk::PhysicalDeviceDynamicRenderingFeatures()
+            .setDynamicRendering( true )
+            .setPNext( &synchronization2_enabled );
+        const auto vulkan12_enabled = vk::PhysicalDeviceVulkan12Features()
+            .setDrawIndirectCount( m_vulkan12_features.drawIndirectCount )
+            .setTimelineSemaphore( true )
+            .setDescriptorIndexing( true )
+            .setShaderSampledImageArrayNonUniformIndexing( true )
+            .setShaderStorageBufferArrayNonUniformIndexing( true )
+            .setDescriptorBindingSampledImageUpdateAfterBind( true )
+            .setDescriptorBindingStorageBufferUpdateAfterBind( true )
+            .setDescriptorBindingUpdateUnusedWhilePending( true )
+            .setDescriptorBindingPartiallyBound( true )
+            .setDescriptorBindingVariableDescriptorCount( true )
+            .setRuntimeDescriptorArray( true )
+            .setPNext( &dynamic_rendering_enabled );
         const auto device_info = vk::DeviceCreateInfo()
             .setQueueCreateInfos( queues )
-            .setPEnabledExtensionNames( required_extensions )
+            .setPEnabledExtensionNames( extensions )
             .setPEnabledFeatures( &this->getFeatures() )
-            .setPNext( &dynamic_rendering_enabled );
+            .setPNext( &vulkan12_enabled );
         return m_device.createDevice(device_info);
     }
 
@@ -52,26 +92,100 @@ namespace eng {
         return m_queue_family_indices.present.has_value();
     }
 
+    bool GPU::hasDedicatedComputeQueue() const
+    {
+        return m_queue_family_indices.compute.has_value();
+    }
+
+    bool GPU::hasDedicatedTransferQueue() const
+    {
+        return m_queue_family_indices.transfer.has_value();
+    }
+
+    bool GPU::supportsTimelineSemaphores() const
+    {
+        return m_vulkan12_features.timelineSemaphore;
+    }
+
+    bool GPU::supportsIndirectCount() const
+    {
+        return m_vulkan12_features.drawIndirectCount
+            && m_features.multiDrawIndirect
+            && m_features.drawIndirectFirstInstance;
+    }
+
+    bool GPU::supportsDescriptorIndexing() const
+    {
+        return m_vulkan12_features.descriptorIndexing
+            && m_vulkan12_features.shaderSampledImageArrayNonUniformIndexing
+            && m_vulkan12_features.shaderStorageBufferArrayNonUniformIndexing
+            && m_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind
+            && m_vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind
+            && m_vulkan12_features.descriptorBindingUpdateUnusedWhilePending
+            && m_vulkan12_features.descriptorBindingPartiallyBound
+            && m_vulkan12_features.descriptorBindingVariableDescriptorCount
+            && m_vulkan12_features.runtimeDescriptorArray;
+    }
+
     bool GPU::supportsRequiredExtensions(const std::span<const char* const> required_extensions) const
     {
         const auto supported_extensions{ m_device.enumerateDeviceExtensionProperties() };
         return util::getUnsupportedExtensions(required_extensions, supported_extensions).empty();
     }
 
+    bool GPU::queryPresentWaitSupport() const
+    {
+        // The features may only be queried once the extensions are known to be supported
+        if (!supportsRequiredExtensions(PRESENT_WAIT_EXTENSIONS))
+            return false;
+        const auto features{ m_device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                   vk::PhysicalDevicePresentIdFeaturesKHR,
+                                                   vk::PhysicalDevicePresentWaitFeaturesKHR>() };
+        return features.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId
+            && features.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+    }
+
     bool GPU::meetsSwapChainRequirements(const vk::SurfaceKHR& surface) const
     {
         return !m_device.getSurfaceFormatsKHR(surface).empty()
             && !m_device.getSurfacePresentModesKHR(surface).empty();
     }
 
+    std::uint32_t GPU::findMemoryType(const std::uint32_t type_filter, const vk::MemoryPropertyFlags properties) const
+    {
+        for (std::uint32_t i = 0; i < m_memory_properties.memoryTypeCount; ++i) {
+            if ((type_filter & (1u << i)) && (m_memory_properties.memoryTypes[i].propertyFlags & properties) == properties)
+                return i;
+        }
+        throw std::runtime_error("unable to locate a suitable memory type");
+    }
+
     void GPU::findQueueFamilies(const vk::SurfaceKHR& surface)
     {
+        // Every family is considered, as the dedicated compute and transfer families may follow the graphics family
+        auto& indices{ m_queue_family_indices };
         const auto queue_families{ m_device.getQueueFamilyProperties() };
-        for (int i = 0; i < queue_families.size() && !m_queue_family_indices.isFullyPopulated(); ++i) {
-            if (queue_families.at(i).queueFlags & vk::QueueFlagBits::eGraphics)
-                m_queue_family_indices.graphics = i;
-            if (m_device.getSurfaceSupportKHR(i, surface))
-                m_queue_family_indices.present = i;
+        for (std::uint32_t i = 0; i < queue_families.size(); ++i) {
+            const auto flags{ queue_families.at(i).queueFlags };
+            const bool graphics{ static_cast<bool>(flags & vk::QueueFlagBits::eGraphics) };
+            const bool compute{ static_cast<bool>(flags & vk::QueueFlagBits::eCompute) };
+
+            // Render with the first graphics family
+            if (graphics && !indices.graphics)
+                indices.graphics = i;
+
+            // Present from the graphics family if it can, so frames need no cross-family handoff, otherwise from the
+            // first family which can. Support is only queried if it could change the choice, and never when headless.
+            if (surface && (!indices.present || indices.graphics == i) && m_device.getSurfaceSupportKHR(i, surface))
+                indices.present = i;
+
+            // A compute family without graphics maps to the device's asynchronous compute engines
+            if (compute && !graphics && !indices.compute)
+                indices.compute = i;
+
+            // A family supporting transfers but neither graphics nor compute maps to the device's copy engines
+            if ((flags & vk::QueueFlagBits::eTransfer) && !graphics && !compute && !indices.transfer)
+                indices.transfer = i;
         }
     }
 
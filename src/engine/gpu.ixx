@@ -1,7 +1,9 @@
 module;
 
+#include <array>
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <vector>
 
 export module gpu;
@@ -10,6 +12,15 @@ export module gpu;
 import vulkan_hpp;
 
 namespace eng {
+    /**
+     * The extensions enabled alongside the required extensions when supported, letting the CPU wait for a given
+     * present to reach the display
+     */
+    export constexpr std::array PRESENT_WAIT_EXTENSIONS{
+        vk::KHRPresentIdExtensionName,
+        vk::KHRPresentWaitExtensionName
+    };
+
     /**
      * Represents the indices of Vulkan queue families that are needed for executing specific operations.
      * The indices are stored as optional values to allow verification of their assignment.
@@ -17,6 +28,8 @@ namespace eng {
     struct QueueFamilyIndices {
         std::optional<std::uint32_t> graphics{ std::nullopt };
         std::optional<std::uint32_t> present{ std::nullopt };
+        std::optional<std::uint32_t> compute{ std::nullopt };   // Only set for a compute family without graphics
+        std::optional<std::uint32_t> transfer{ std::nullopt };  // Only set for a transfer-only (DMA) family
 
         [[nodiscard]] bool isFullyPopulated() const
         { return graphics.has_value() && present.has_value(); }
@@ -30,19 +43,30 @@ namespace eng {
         // Default Constructor
         GPU() = default;
 
-        // Standard Constructor
+        // Standard Constructor, a null surface indicates a headless device with no presentation support
         explicit GPU(const vk::PhysicalDevice& device, const vk::SurfaceKHR& surface)
             : m_device{ device },
               m_properties{ device.getProperties() },
-              m_features{ device.getFeatures() }
+              m_features{ device.getFeatures() },
+              m_vulkan12_features{ device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                                       vk::PhysicalDeviceVulkan12Features>()
+                                         .get<vk::PhysicalDeviceVulkan12Features>() },
+              m_vulkan12_properties{ device.getProperties2<vk::PhysicalDeviceProperties2,
+                                                           vk::PhysicalDeviceVulkan12Properties>()
+                                           .get<vk::PhysicalDeviceVulkan12Properties>() },
+              m_memory_properties{ device.getMemoryProperties() }
         {
+            m_vulkan12_features.setPNext( nullptr );
+            m_vulkan12_properties.setPNext( nullptr );
             findQueueFamilies(surface);
+            m_present_wait = surface && queryPresentWaitSupport();
         }
 
         /* Device Creation Methods */
 
         /**
-         * Creates a logical device object corresponding to the passed-in GPU configured to the program needs
+         * Creates a logical device object corresponding to the passed-in GPU configured to the program needs,
+         * enabling present wait where supported
          * @param required_extensions the extensions required for the candidate device
          * @return a newly instantiated logical Device object configured for the program
          */
@@ -59,12 +83,29 @@ namespace eng {
         [[nodiscard]] const vk::PhysicalDeviceFeatures& getFeatures() const
         { return m_features; }
 
+        [[nodiscard]] const vk::PhysicalDeviceVulkan12Features& getVulkan12Features() const
+        { return m_vulkan12_features; }
+
+        [[nodiscard]] const vk::PhysicalDeviceVulkan12Properties& getVulkan12Properties() const
+        { return m_vulkan12_properties; }
+
+        [[nodiscard]] const vk::PhysicalDeviceMemoryProperties& getMemoryProperties() const
+        { return m_memory_properties; }
+
         [[nodiscard]] std::uint32_t getGraphicsFamilyIndex() const
         { return m_queue_family_indices.graphics.value(); }
 
         [[nodiscard]] std::uint32_t getPresentFamilyIndex() const
         { return m_queue_family_indices.present.value(); }
 
+        // Returns the dedicated compute family if the device has one, otherwise the graphics family
+        [[nodiscard]] std::uint32_t getComputeFamilyIndex() const
+        { return m_queue_family_indices.compute.value_or(getGraphicsFamilyIndex()); }
+
+        // Returns the dedicated transfer family if the device has one, otherwise the graphics family
+        [[nodiscard]] std::uint32_t getTransferFamilyIndex() const
+        { return m_queue_family_indices.transfer.value_or(getGraphicsFamilyIndex()); }
+
         /* Device Functionality Queries */
 
         [[nodiscard]] bool isCPU() const;
@@ -75,26 +116,62 @@ namespace eng {
 
         [[nodiscard]] bool supportsPresentationQueues() const;
 
+        [[nodiscard]] bool hasDedicatedComputeQueue() const;
+
+        [[nodiscard]] bool hasDedicatedTransferQueue() const;
+
+        // Returns true if semaphores can carry a monotonically increasing value, required for cross-queue scheduling
+        [[nodiscard]] bool supportsTimelineSemaphores() const;
+
+        // Returns true if draw commands and their count can be sourced from GPU-written buffers
+        [[nodiscard]] bool supportsIndirectCount() const;
+
+        // Returns true if a single update-after-bind descriptor set can hold every resource, indexed by shaders
+        [[nodiscard]] bool supportsDescriptorIndexing() const;
+
+        // Returns true if presents can be tagged with an id and waited on, always false for a headless device
+        [[nodiscard]] bool supportsPresentWait() const
+        { return m_present_wait; }
+
         [[nodiscard]] bool supportsRequiredExtensions(std::span<const char* const> required_extensions) const;
 
         [[nodiscard]] bool meetsSwapChainRequirements(const vk::SurfaceKHR& surface) const;
 
+        /* Memory Queries */
+
+        /**
+         * Locates a memory type permitted by a resource's memory requirements which has all the requested properties
+         * @param type_filter the memoryTypeBits field of the resource's memory requirements
+         * @param properties the property flags the memory type must support
+         * @return the index of the first matching memory type
+         * @throws std::runtime_error if no memory type satisfies the requirements
+         */
+        [[nodiscard]] std::uint32_t findMemoryType(std::uint32_t type_filter, vk::MemoryPropertyFlags properties) const;
+
     private:
         /* Data Members */
 
-        vk::PhysicalDevice              m_device;
-        vk::PhysicalDeviceProperties    m_properties;
-        vk::PhysicalDeviceFeatures      m_features;
-        QueueFamilyIndices              m_queue_family_indices;
+        vk::PhysicalDevice                  m_device;
+        vk::PhysicalDeviceProperties        m_properties;
+        vk::PhysicalDeviceFeatures          m_features;
+        vk::PhysicalDeviceVulkan12Features  m_vulkan12_features;
+        vk::PhysicalDeviceVulkan12Properties m_vulkan12_properties;
+        vk::PhysicalDeviceMemoryProperties  m_memory_properties;
+        QueueFamilyIndices                  m_queue_family_indices;
+        bool                                m_present_wait{ false };
 
         /* Helper Methods */
 
         /**
          * Stores the indices of the queue families for which we require support
-         * @param surface the target surface for swap chain presentation, used to query Present Queue support
+         * @param surface the target surface for swap chain presentation, used to query Present Queue support,
+         *                or a null handle if the device will run headless
          */
         void findQueueFamilies(const vk::SurfaceKHR& surface);
 
+        // Returns true if the present id and present wait extensions and features are supported
+        [[nodiscard]] bool queryPresentWaitSupport() const;
+
         [[nodiscard]] vk::DeviceQueueCreateInfo addDeviceQueue(uint32_t family_index,
                                                                std::span<const float> priorities,
                                                                vk::DeviceQueueCreateFlags flags = {}) const;
@@ -1,7 +1,20 @@
 module;
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <format>
+#include <future>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "vkfw/vkfw.hpp"
 
@@ -9,64 +22,178 @@ module init;
 
 // Internal Dependencies
 import container_utils;
+import debug_utils;
+import file_utils;
+import hash_utils;
 import vulkan_utils;
 
 namespace eng::init {
-    vk::Instance createVulkanInstance()
+    namespace {
+        constexpr std::uint32_t SNAPSHOT_MAGIC{ 0x50534744 };   // "DGSP"
+        constexpr std::uint32_t SNAPSHOT_VERSION{ 1 };
+
+        // The number of device configurations remembered, e.g., for headless and windowed runs
+        constexpr std::size_t MAX_SNAPSHOT_ENTRIES{ 8 };
+
+        struct SnapshotHeader
+        {
+            std::uint32_t magic{ SNAPSHOT_MAGIC };
+            std::uint32_t version{ SNAPSHOT_VERSION };
+            std::uint32_t entry_count{ 0 };
+            std::uint32_t reserved{ 0 };
+        };
+
+        struct SnapshotEntry
+        {
+            std::uint64_t configuration{ 0 };   // The hash of the devices, their drivers and the requirements
+            std::uint32_t selected_index{ 0 };  // The selected device's index in the enumeration order
+            std::uint32_t reserved{ 0 };
+        };
+
+        /**
+         * Hashes everything the selection depends on besides the surface, which is checked on every warm start.
+         * Each device contributes its identity and driver version, so a driver update or a change in the installed
+         * devices forces a full probe.
+         */
+        [[nodiscard]] std::uint64_t hashConfiguration(const std::span<const vk::PhysicalDevice> devices,
+                                                      const std::span<const char* const> required_extensions,
+                                                      const vk::SurfaceKHR& surface)
+        {
+            auto hash{ util::hashValue(static_cast<std::uint32_t>(static_cast<bool>(surface))) };
+            for (const std::string_view extension : required_extensions) {
+                hash = util::hashValue(extension.size(), hash);
+                hash = util::fnv1a(extension, hash);
+            }
+            for (const auto& device : devices) {
+                const auto properties{ device.getProperties() };
+                hash = util::hashValue(properties.vendorID, hash);
+                hash = util::hashValue(properties.deviceID, hash);
+                hash = util::hashValue(properties.driverVersion, hash);
+                hash = util::hashValue(properties.apiVersion, hash);
+                hash = util::fnv1a(std::as_bytes(std::span{ properties.pipelineCacheUUID.data(), vk::UuidSize }), hash);
+            }
+            return hash;
+        }
+
+        // Returns the snapshot's entries, or none if it is missing, malformed or from another version
+        [[nodiscard]] std::vector<SnapshotEntry> readSnapshot(const std::filesystem::path& path)
+        {
+            const auto blob{ util::readBinaryFile(path) };
+            SnapshotHeader header{ };
+            if (!blob || blob->size() < sizeof(header))
+                return { };
+            std::memcpy(&header, blob->data(), sizeof(header));
+            if (header.magic != SNAPSHOT_MAGIC
+                || header.version != SNAPSHOT_VERSION
+                || header.entry_count > MAX_SNAPSHOT_ENTRIES
+                || blob->size() != sizeof(header) + header.entry_count * sizeof(SnapshotEntry))
+                return { };
+
+            std::vector<SnapshotEntry> entries(header.entry_count);
+            std::memcpy(entries.data(), blob->data() + sizeof(header), entries.size() * sizeof(SnapshotEntry));
+            return entries;
+        }
+
+        void writeSnapshot(const std::filesystem::path& path, const std::span<const SnapshotEntry> entries)
+        {
+            const SnapshotHeader header{ .entry_count = static_cast<std::uint32_t>(entries.size()) };
+            std::vector<std::byte> blob(sizeof(header) + entries.size_bytes());
+            std::memcpy(blob.data(), &header, sizeof(header));
+            std::memcpy(blob.data() + sizeof(header), entries.data(), entries.size_bytes());
+            util::writeFileAtomically(path, blob);
+        }
+    }
+
+    vk::Instance createVulkanInstance(const bool headless)
     {
+        // Every call dispatches through the default dispatcher, so the global entry points are loaded first
+        vk::detail::defaultDispatchLoaderDynamic.init();
+
         constexpr auto app_info = vk::ApplicationInfo()
             .setPApplicationName( "Hello Triangle" )
             .setApplicationVersion( vk::makeApiVersion(0, 0, 1, 0) )
             .setApiVersion( vk::ApiVersion14 );
 
-        const auto enabled_extensions = enumerateEnabledInstanceExtensions();
+        const auto enabled_extensions = enumerateEnabledInstanceExtensions(headless);
 
         const auto instance_info = vk::InstanceCreateInfo()
             .setPApplicationInfo( &app_info )
             .setPEnabledExtensionNames( enabled_extensions );
 
-        return vk::createInstance( instance_info );
+        // Load the instance-level entry points, including those of the enabled extensions
+        const auto instance{ vk::createInstance( instance_info ) };
+        vk::detail::defaultDispatchLoaderDynamic.init(instance);
+        return instance;
     }
 
-    GPU selectSuitableGPU(const std::span<const vk::PhysicalDevice> candidate_devices,
-                          const std::span<const char* const> required_extensions,
-                          const vk::SurfaceKHR& surface)
+    GPUSelection selectSuitableGPU(const std::span<const vk::PhysicalDevice> candidate_devices,
+                                   const std::span<const char* const> required_extensions,
+                                   const vk::SurfaceKHR& surface,
+                                   const std::filesystem::path& snapshot_path)
     {
         if (candidate_devices.empty())
             throw std::runtime_error("unable to locate a Vulkan-compatible GPU");
 
-        // Filter any non-viable GPUs
-        std::vector<GPU> viable_gpus{ };
+        // On a warm start, probe only the device selected for the same devices, drivers and requirements
+        const auto configuration{ hashConfiguration(candidate_devices, required_extensions, surface) };
+        auto snapshot{ snapshot_path.empty() ? std::vector<SnapshotEntry>{ } : readSnapshot(snapshot_path) };
+        if (const auto entry{ std::ranges::find(snapshot, configuration, &SnapshotEntry::configuration) };
+            entry != snapshot.end() && entry->selected_index < candidate_devices.size()) {
+            GPU gpu{ candidate_devices[entry->selected_index], surface };
+            if (meetsMinimumRequirements(gpu, required_extensions, surface))
+                return { std::move(gpu), true, 1 };
+        }
+
+        // Probe every device in parallel, as each probe is a series of independent driver queries
+        const auto policy{ candidate_devices.size() > 1 ? std::launch::async : std::launch::deferred };
+        std::vector<std::future<std::optional<GPU>>> probes;
+        probes.reserve(candidate_devices.size());
         for (const auto& device : candidate_devices) {
-            GPU gpu{ device, surface };
-            const bool meets_minimum_requirements{
-                gpu.supportsGraphicsQueues()
-                && gpu.supportsPresentationQueues()
-                && gpu.supportsRequiredExtensions(required_extensions)
-                && gpu.meetsSwapChainRequirements(surface)
-            };
-            if (meets_minimum_requirements)
-                viable_gpus.push_back(gpu);
+            probes.push_back(std::async(policy, [&, device]() -> std::optional<GPU> {
+                GPU gpu{ device, surface };
+                if (!meetsMinimumRequirements(gpu, required_extensions, surface))
+                    return std::nullopt;
+                return gpu;
+            }));
+        }
+
+        // Filter any non-viable GPUs
+        std::vector<GPU> viable_gpus;
+        std::vector<std::uint32_t> viable_indices;
+        for (std::uint32_t i = 0; i < probes.size(); ++i) {
+            if (auto gpu{ probes[i].get() }) {
+                viable_gpus.push_back(std::move(*gpu));
+                viable_indices.push_back(i);
+            }
         }
         if (viable_gpus.empty())
             throw std::runtime_error("unable to locate a suitable GPU");
 
-        // Select the best GPU from the remaining candidates
-        if (viable_gpus.size() == 1)
-            return viable_gpus.front();
-
-        return selectBestGPU(viable_gpus);
+        // Select the best GPU from the remaining candidates, and remember it for the next run. A failure to persist
+        // the snapshot only costs the next run a full probe, so it is not fatal.
+        const auto best{ selectBestGPU(viable_gpus) };
+        if (!snapshot_path.empty()) {
+            std::erase_if(snapshot, [&](const SnapshotEntry& entry) { return entry.configuration == configuration; });
+            snapshot.insert(snapshot.begin(), { configuration, viable_indices[best] });
+            if (snapshot.size() > MAX_SNAPSHOT_ENTRIES)
+                snapshot.resize(MAX_SNAPSHOT_ENTRIES);
+            try {
+                writeSnapshot(snapshot_path, snapshot);
+            } catch (const std::exception&) {
+                // Fall through, the selection itself succeeded
+            }
+        }
+        return { std::move(viable_gpus[best]), false, static_cast<std::uint32_t>(candidate_devices.size()) };
     }
 
-    std::vector<const char*> enumerateEnabledInstanceExtensions()
+    std::vector<const char*> enumerateEnabledInstanceExtensions(const bool headless)
     {
-        // Query required instance extensions from external libraries
-        const auto glfw_extensions = vkfw::getRequiredInstanceExtensions();
+        // Query required instance extensions from external libraries, a headless instance needs no window system
+        const auto glfw_extensions = headless ? std::span<const char*>{ } : vkfw::getRequiredInstanceExtensions();
 
-        // Accumulate required extension names into a single list
-        constexpr std::array specified_extensions{ vk::EXTDebugUtilsExtensionName };
+        // Accumulate required extension names into a single list, debug utils are only requested if instrumented
         const auto enabled_extensions{
-            util::flattenToVector<const char*>(specified_extensions, glfw_extensions)
+            util::flattenToVector<const char*>(dbg::INSTANCE_EXTENSIONS, glfw_extensions)
         };
 
         // Ensure all required extensions are supported
@@ -82,32 +209,73 @@ namespace eng::init {
         return enabled_extensions;
     }
 
-    GPU selectBestGPU(const std::span<const GPU> candidate_gpus)
+    bool meetsMinimumRequirements(const GPU& gpu,
+                                  const std::span<const char* const> required_extensions,
+                                  const vk::SurfaceKHR& surface)
+    {
+        const bool meets_presentation_requirements{
+            !surface || (gpu.supportsPresentationQueues() && gpu.meetsSwapChainRequirements(surface))
+        };
+        return gpu.supportsGraphicsQueues()
+            && meets_presentation_requirements
+            && gpu.supportsDescriptorIndexing()
+            && gpu.supportsTimelineSemaphores()
+            && gpu.supportsRequiredExtensions(required_extensions);
+    }
+
+    std::int64_t scoreGPU(const GPU& gpu)
     {
-        std::vector<std::pair<int, GPU>> gpu_scores(candidate_gpus.size());
-        for (const auto& gpu : candidate_gpus) {
-            int gpu_score{ 0 };
+        // CPUs should only be used as a fallback when no other device is present,
+        // even if it scores the same as other devices
+        if (gpu.isCPU())
+            return -1;
+
+        std::int64_t gpu_score{ 0 };
 
-            // Discrete GPUs (i.e., video cards) perform better than integrated GPUs
-            if (gpu.isDiscreteGPU())
-                gpu_score += 500;
+        // Discrete GPUs (i.e., video cards) perform better than integrated GPUs
+        if (gpu.isDiscreteGPU())
+            gpu_score += 500;
 
-            // Performance is better when the Presentation and Graphics queue families are the same
-            if (gpu.getPresentFamilyIndex() == gpu.getGraphicsFamilyIndex())
-                gpu_score += 100;
+        // Performance is better when the Presentation and Graphics queue families are the same
+        if (gpu.supportsPresentationQueues() && gpu.getPresentFamilyIndex() == gpu.getGraphicsFamilyIndex())
+            gpu_score += 100;
 
-            // CPUs should only be used as a fallback when no other device is present,
-            // even if it scores the same as other devices
-            if (gpu.isCPU())
-                gpu_score = -1;
+        // Dedicated compute and transfer families let culling and uploads overlap with rendering
+        if (gpu.hasDedicatedComputeQueue())
+            gpu_score += 50;
+        if (gpu.hasDedicatedTransferQueue())
+            gpu_score += 50;
 
-            gpu_scores.emplace_back(gpu_score, gpu);
+        // GPU-driven rendering needs indirect count draws
+        if (gpu.supportsIndirectCount())
+            gpu_score += 50;
+
+        // The largest device-local heap bounds the resident working set, scored per 64 MiB up to 64 GiB. An
+        // integrated GPU's heap is shared with the system, so it never makes up for a discrete GPU on its own.
+        const auto& memory_properties{ gpu.getMemoryProperties() };
+        vk::DeviceSize device_local_bytes{ 0 };
+        for (std::uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i) {
+            if (const auto& heap{ memory_properties.memoryHeaps[i] }; heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+                device_local_bytes = std::max(device_local_bytes, heap.size);
         }
+        gpu_score += static_cast<std::int64_t>(std::min<vk::DeviceSize>(device_local_bytes >> 26, 1024)) / 4;
+
+        // Higher limits loosely track the capability of the hardware
+        const auto& limits{ gpu.getProperties().limits };
+        gpu_score += limits.maxImageDimension2D / 1024;
+        if (limits.timestampComputeAndGraphics)
+            gpu_score += 10;
+
+        return gpu_score;
+    }
+
+    std::size_t selectBestGPU(const std::span<const GPU> candidate_gpus)
+    {
+        std::vector<std::int64_t> gpu_scores;
+        gpu_scores.reserve(candidate_gpus.size());
+        std::ranges::transform(candidate_gpus, std::back_inserter(gpu_scores), scoreGPU);
 
-        // Sort the GPUs by their scores
-        std::ranges::sort(gpu_scores, [](const auto& lhs, const auto& rhs) {
-            return lhs.first > rhs.first;
-        });
-        return gpu_scores.front().second;
+        // The first of equally scored GPUs is selected, so the selection follows the enumeration order on a tie
+        return static_cast<std::size_t>(std::ranges::distance(gpu_scores.begin(), std::ranges::max_element(gpu_scores)));
     }
 }
@@ -1,5 +1,9 @@
 module;
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
 #include <vector>
 
 export module init;
@@ -11,46 +15,103 @@ import vulkan_hpp;
 import gpu;
 
 namespace eng::init {
+    /**
+     * The default location of the device selection snapshot, alongside the pipeline cache
+     */
+    export inline const std::filesystem::path DEFAULT_DEVICE_SNAPSHOT_PATH{ "cache/device_snapshot.bin" };
+
+    /**
+     * The selected GPU, and how it was selected
+     */
+    export struct GPUSelection
+    {
+        GPU gpu;
+        bool from_snapshot{ false };        // Selected by an earlier run, so no other device was probed
+        std::uint32_t probed_devices{ 0 };  // Devices whose capabilities were queried
+    };
+
+    /**
+     * The time spent in each stage of engine startup, in milliseconds
+     */
+    export struct StartupTimings
+    {
+        double instance_ms{ 0.0 };
+        double surface_ms{ 0.0 };               // Zero if headless
+        double device_selection_ms{ 0.0 };
+        double device_creation_ms{ 0.0 };       // The logical device, its allocator and its queues
+        double render_targets_ms{ 0.0 };        // The swapchain, or the offscreen targets if headless
+        double rendering_resources_ms{ 0.0 };   // Caches, pipelines, descriptors, frame resources and the default mesh
+        double total_ms{ 0.0 };
+        bool device_snapshot_hit{ false };
+        std::uint32_t probed_devices{ 0 };
+    };
+
     /* Vulkan Initialization Functions */
 
     /**
      * Validates if the target Vulkan implementation supports the application's needs and, if so, creates
-     * a Vulkan instance object
+     * a Vulkan instance object. Loads the global and instance-level entry points into the default dispatcher.
+     * @param headless if true, window system extensions are not requested and no windowing library is queried
      * @return a newly created Vulkan instance object configured for the program
      */
     export [[nodiscard]] vk::Instance
-    createVulkanInstance();
+    createVulkanInstance(bool headless = false);
 
     /**
-     * Selects the best available Physical Device in the system and returns a corresponding GPU object
+     * Selects the best available Physical Device in the system and returns a corresponding GPU object. If the
+     * snapshot holds the selection made for the same devices, drivers and requirements, only the previously
+     * selected device is probed. Otherwise every device is probed in parallel, and the selection is saved to the
+     * snapshot for the next run.
      * @param candidate_devices the list of Vulkan-compatible physical devices on the system
      * @param required_extensions the extensions required for the candidate device
-     * @param surface the target surface for swap chain rendering
+     * @param surface the target surface for swap chain rendering, or a null handle to skip presentation checks
+     * @param snapshot_path the path of the device selection snapshot, or an empty path to always probe every device
      * @return a newly instantiated GPU object corresponding to the best-suited Physical Device on the system
+     * @throws std::runtime_error if no device meets the engine's requirements
      */
-    export [[nodiscard]] GPU
+    export [[nodiscard]] GPUSelection
     selectSuitableGPU(std::span<const vk::PhysicalDevice> candidate_devices,
                       std::span<const char* const> required_extensions,
-                      const vk::SurfaceKHR& surface);
+                      const vk::SurfaceKHR& surface,
+                      const std::filesystem::path& snapshot_path = DEFAULT_DEVICE_SNAPSHOT_PATH);
 
     /* Helper Functions */
 
     /**
      * Accumulates all required instance extension names and validates they are supported before returning the list
      * of extension names to be used in an InstanceCreateInfo struct
+     * @param headless if true, the extensions required by the windowing library are omitted
      * @return a std::vector containing a list of enabled extension names
      * @throws std::runtime_error if any required extensions are not supported by the target vulkan implementation
      */
     [[nodiscard]] std::vector<const char*>
-    enumerateEnabledInstanceExtensions();
+    enumerateEnabledInstanceExtensions(bool headless);
+
+    /**
+     * Checks a GPU against the minimum engine requirements
+     * @param gpu the probed GPU
+     * @param required_extensions the extensions required for the candidate device
+     * @param surface the target surface, or a null handle to skip presentation checks
+     * @return true if the engine can run on the GPU
+     */
+    [[nodiscard]] bool
+    meetsMinimumRequirements(const GPU& gpu,
+                             std::span<const char* const> required_extensions,
+                             const vk::SurfaceKHR& surface);
+
+    /**
+     * Scores a GPU which meets the minimum engine requirements on its device type, memory, limits and queue topology
+     * @param gpu the probed GPU
+     * @return the score, higher is better, negative only for CPU implementations
+     */
+    [[nodiscard]] std::int64_t
+    scoreGPU(const GPU& gpu);
 
     /**
      * Selects the best GPU from a list of GPUs which meet the minimum engine requirements
-     * @param candidate_gpus the list of viable GPU candidates
-     * @return the best GPU from the candidates
+     * @param candidate_gpus the list of viable GPU candidates, must not be empty
+     * @return the index of the best GPU, the first enumerated on a tie
      */
-    [[nodiscard]] GPU
+    [[nodiscard]] std::size_t
     selectBestGPU(std::span<const GPU> candidate_gpus);
 }
-
-
@@ -0,0 +1,72 @@
+module;
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+module mesh;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::mesh {
+    MeshData createTriangleMesh(const std::uint32_t triangle_count)
+    {
+        MeshData mesh{
+            {
+                Vertex{ { 0.0f, -0.5f }, { 1.0f, 0.0f, 0.0f } },
+                Vertex{ { 0.5f, 0.5f }, { 0.0f, 1.0f, 0.0f } },
+                Vertex{ { -0.5f, 0.5f }, { 0.0f, 0.0f, 1.0f } },
+            },
+            {}
+        };
+
+        mesh.indices.resize(static_cast<std::size_t>(triangle_count) * 3);
+        for (std::size_t i = 0; i < mesh.indices.size(); ++i)
+            mesh.indices[i] = static_cast<std::uint32_t>(i % 3);
+        return mesh;
+    }
+
+    float computeBoundingRadius(const MeshData& mesh_data)
+    {
+        float radius{ 0.0f };
+        for (const auto& vertex : mesh_data.vertices)
+            radius = std::max(radius, glm::length(vertex.position));
+        return radius;
+    }
+
+    Mesh createMesh(mem::DeviceAllocator& allocator,
+                    const std::size_t vertex_count,
+                    const std::size_t index_count,
+                    const std::span<const std::uint32_t> queue_families)
+    {
+        // Buffers written on a dedicated transfer queue and read on the graphics queue are shared concurrently,
+        // which avoids a queue family ownership transfer on every upload
+        std::vector unique_families(queue_families.begin(), queue_families.end());
+        std::ranges::sort(unique_families);
+        const auto [ first, last ]{ std::ranges::unique(unique_families) };
+        unique_families.erase(first, last);
+        const bool concurrent{ unique_families.size() > 1 };
+
+        const auto create_buffer = [&](const vk::DeviceSize size, const vk::BufferUsageFlags usage) {
+            auto create_info = vk::BufferCreateInfo()
+                .setSize( size )
+                .setUsage( usage | vk::BufferUsageFlagBits::eTransferDst )
+                .setSharingMode( concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive );
+            if (concurrent)
+                create_info.setQueueFamilyIndices( unique_families );
+            return allocator.createBuffer(create_info, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        };
+
+        Mesh mesh{
+            create_buffer(vertex_count * sizeof(Vertex), vk::BufferUsageFlagBits::eVertexBuffer),
+            create_buffer(index_count * sizeof(std::uint32_t), vk::BufferUsageFlagBits::eIndexBuffer),
+            static_cast<std::uint32_t>(index_count)
+        };
+        dbg::setObjectName(allocator.getDevice(), mesh.vertex_buffer.get().get(), "mesh vertices ({})", vertex_count);
+        dbg::setObjectName(allocator.getDevice(), mesh.index_buffer.get().get(), "mesh indices ({})", index_count);
+        return mesh;
+    }
+}
@@ -0,0 +1,147 @@
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+export module mesh;
+
+// External Dependencies
+import glm;
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+
+namespace eng::mesh {
+    /* Vertex Layout */
+
+    /**
+     * The vertex attribute format corresponding to a C++ attribute type, eUndefined for unsupported types
+     */
+    export template <typename T>
+    constexpr vk::Format VERTEX_FORMAT{ vk::Format::eUndefined };
+
+    template <> constexpr vk::Format VERTEX_FORMAT<float>{ vk::Format::eR32Sfloat };
+    template <> constexpr vk::Format VERTEX_FORMAT<glm::vec2>{ vk::Format::eR32G32Sfloat };
+    template <> constexpr vk::Format VERTEX_FORMAT<glm::vec3>{ vk::Format::eR32G32B32Sfloat };
+    template <> constexpr vk::Format VERTEX_FORMAT<glm::vec4>{ vk::Format::eR32G32B32A32Sfloat };
+    template <> constexpr vk::Format VERTEX_FORMAT<std::uint32_t>{ vk::Format::eR32Uint };
+
+    /**
+     * A vertex type which lists its attributes, in shader location order, as a tuple of member pointers
+     * named ATTRIBUTES
+     */
+    export template <typename V>
+    concept VertexType = std::is_trivially_copyable_v<V> && std::is_default_constructible_v<V> && requires {
+        std::tuple_size<std::remove_cvref_t<decltype(V::ATTRIBUTES)>>::value;
+    };
+
+    /**
+     * The vertex input state of a graphics pipeline
+     */
+    export struct VertexInputDesc
+    {
+        std::vector<vk::VertexInputBindingDescription> bindings;
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+
+        [[nodiscard]] bool operator==(const VertexInputDesc&) const = default;
+    };
+
+    /**
+     * Generates the vertex input state for a vertex type, with every attribute read from a single binding
+     * @tparam V the vertex type
+     * @param binding the binding index the vertex buffer will be bound to
+     * @param first_location the shader location of the first attribute
+     * @param input_rate whether the binding advances per vertex or per instance
+     * @return the binding and attribute descriptions for the vertex type
+     */
+    export template <VertexType V>
+    [[nodiscard]] VertexInputDesc describeVertexInput(const std::uint32_t binding = 0,
+                                                      const std::uint32_t first_location = 0,
+                                                      const vk::VertexInputRate input_rate = vk::VertexInputRate::eVertex)
+    {
+        VertexInputDesc desc{ { vk::VertexInputBindingDescription{ binding, sizeof(V), input_rate } }, {} };
+
+        // Attribute offsets are measured on an instance, as offsetof cannot be applied to a member pointer
+        const V vertex{ };
+        const auto* base{ reinterpret_cast<const std::byte*>(&vertex) };
+        std::apply([&](const auto... members) {
+            std::uint32_t location{ first_location };
+            ([&] {
+                using Attribute = std::remove_cvref_t<decltype(vertex.*members)>;
+                static_assert(VERTEX_FORMAT<Attribute> != vk::Format::eUndefined, "unsupported vertex attribute type");
+                const auto offset{ reinterpret_cast<const std::byte*>(&(vertex.*members)) - base };
+                desc.attributes.emplace_back(location++, binding, VERTEX_FORMAT<Attribute>, static_cast<std::uint32_t>(offset));
+            }(), ...);
+        }, V::ATTRIBUTES);
+        return desc;
+    }
+
+    /**
+     * The engine's standard vertex, a 2D position with a per-vertex color
+     */
+    export struct Vertex
+    {
+        glm::vec2 position{ 0.0f };
+        glm::vec3 color{ 0.0f };
+
+        static constexpr std::tuple ATTRIBUTES{ &Vertex::position, &Vertex::color };
+    };
+
+    /* Meshes */
+
+    /**
+     * Host-side mesh data, ready to be uploaded
+     */
+    export struct MeshData
+    {
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    /**
+     * A mesh resident in device-local vertex and index buffers
+     */
+    export struct Mesh
+    {
+        mem::AllocatedBuffer vertex_buffer;
+        mem::AllocatedBuffer index_buffer;
+        std::uint32_t index_count{ 0 };
+
+        [[nodiscard]] bool isValid() const
+        { return index_count > 0; }
+    };
+
+    /**
+     * Generates a mesh drawing the same triangle the given number of times, sharing its three vertices
+     * @param triangle_count the number of triangles
+     * @return the mesh data
+     */
+    export [[nodiscard]] MeshData createTriangleMesh(std::uint32_t triangle_count);
+
+    /**
+     * Computes the radius of the smallest origin-centered sphere enclosing the mesh's vertices
+     * @param mesh_data the mesh data
+     * @return the bounding radius in model space
+     */
+    export [[nodiscard]] float computeBoundingRadius(const MeshData& mesh_data);
+
+    /**
+     * Creates the device-local buffers for a mesh, their contents are undefined until uploaded
+     * @param allocator the allocator the buffers are sub-allocated from
+     * @param vertex_count the number of vertices
+     * @param index_count the number of indices
+     * @param queue_families the queue families which will access the buffers, the buffers are shared
+     *                       concurrently if more than one distinct family is passed
+     * @return the mesh, with its index count set
+     */
+    export [[nodiscard]] Mesh createMesh(mem::DeviceAllocator& allocator,
+                                         std::size_t vertex_count,
+                                         std::size_t index_count,
+                                         std::span<const std::uint32_t> queue_families);
+}
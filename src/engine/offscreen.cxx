@@ -0,0 +1,59 @@
+module;
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+module offscreen;
+
+// Internal Dependencies
+import debug_utils;
+import swapchain;
+
+namespace eng::offscreen {
+    OffscreenComponents createOffscreenTargets(mem::DeviceAllocator& allocator,
+                                               const vk::Device& device,
+                                               const vk::Extent2D& extent,
+                                               const std::uint32_t image_count,
+                                               const vk::ImageUsageFlags usage,
+                                               const vk::Format color_format)
+    {
+        const auto create_info = vk::ImageCreateInfo()
+            .setImageType( vk::ImageType::e2D )
+            .setFormat( color_format )
+            .setExtent( vk::Extent3D{ extent, 1 } )
+            .setMipLevels( 1 )
+            .setArrayLayers( 1 )
+            .setSamples( vk::SampleCountFlagBits::e1 )
+            .setTiling( vk::ImageTiling::eOptimal )
+            .setUsage( usage )
+            .setSharingMode( vk::SharingMode::eExclusive )
+            .setInitialLayout( vk::ImageLayout::eUndefined );
+
+        // The images are sub-allocated from shared blocks, rather than taking one device allocation each
+        std::vector<mem::AllocatedImage> images;
+        images.reserve(image_count);
+        for (std::uint32_t i = 0; i < image_count; ++i)
+            images.push_back(allocator.createImage(create_info, vk::MemoryPropertyFlagBits::eDeviceLocal));
+
+        std::vector<vk::Image> image_handles;
+        image_handles.reserve(image_count);
+        std::ranges::transform( images,
+                                std::back_inserter(image_handles),
+                                [](const mem::AllocatedImage& image ) { return image.get().get(); } );
+
+        auto image_views{ swap::createImageViews(image_handles, color_format, device) };
+        for (std::size_t i = 0; i < image_count; ++i) {
+            dbg::setObjectName(device, image_handles[i], "offscreen target {}", i);
+            dbg::setObjectName(device, image_views[i], "offscreen target {} view", i);
+        }
+
+        return {
+            color_format,
+            extent,
+            std::move(images),
+            std::move(image_views)
+        };
+    }
+}
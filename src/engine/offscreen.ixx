@@ -0,0 +1,48 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+export module offscreen;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+
+namespace eng::offscreen {
+    /**
+     * The color format used for offscreen render targets, chosen for its mandatory color attachment
+     * and transfer support across implementations, including software ICDs
+     */
+    export constexpr vk::Format DEFAULT_COLOR_FORMAT{ vk::Format::eR8G8B8A8Unorm };
+
+    export struct OffscreenComponents
+    {
+        vk::Format color_format;
+        vk::Extent2D extent;
+        std::vector<mem::AllocatedImage> images;
+        std::vector<vk::ImageView> image_views;
+    };
+
+    /* Offscreen Target Creation Methods */
+
+    /**
+     * Creates a set of device-local color images to be rendered to in place of a swapchain
+     * @param allocator the allocator the images' memory is sub-allocated from
+     * @param device the logical device which will own the image views
+     * @param extent the extent of each image
+     * @param image_count the number of images to create
+     * @param usage the usage flags for the images
+     * @param color_format the color format for the images
+     * @return an OffscreenComponents struct containing the images, which own their memory, and their views
+     */
+    export [[nodiscard]] OffscreenComponents
+    createOffscreenTargets(mem::DeviceAllocator& allocator,
+                           const vk::Device& device,
+                           const vk::Extent2D& extent,
+                           std::uint32_t image_count,
+                           vk::ImageUsageFlags usage,
+                           vk::Format color_format = DEFAULT_COLOR_FORMAT);
+}
@@ -0,0 +1,93 @@
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+module parallel_recorder;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::cmd {
+    ParallelRecorder::ParallelRecorder(const vk::SharedDevice& device,
+                                       const std::uint32_t queue_family,
+                                       const std::uint32_t frame_count,
+                                       const std::uint32_t worker_count)
+        : m_device{ device },
+          m_worker_count{ std::max(worker_count, 1u) },
+          m_workers{ m_worker_count }
+    {
+        // Transient pools, since every secondary buffer is re-recorded each time its frame slot comes around
+        const auto pool_info = vk::CommandPoolCreateInfo()
+            .setFlags( vk::CommandPoolCreateFlagBits::eTransient )
+            .setQueueFamilyIndex( queue_family );
+
+        m_frames.resize(frame_count);
+        for (std::uint32_t frame = 0; frame < frame_count; ++frame) {
+            auto& workers{ m_frames[frame] };
+            workers.reserve(m_worker_count);
+            for (std::uint32_t i = 0; i < m_worker_count; ++i) {
+                vk::SharedCommandPool command_pool{ m_device->createCommandPool(pool_info), m_device };
+                const auto command_buffer{
+                    allocateCommandBuffer(m_device, command_pool, vk::CommandBufferLevel::eSecondary)
+                };
+                dbg::setObjectName(m_device, command_pool.get(), "frame {} worker {} pool", frame, i);
+                dbg::setObjectName(m_device, command_buffer, "frame {} worker {} draws", frame, i);
+                workers.push_back({ std::move(command_pool), command_buffer });
+            }
+        }
+        m_recorded.reserve(m_worker_count);
+    }
+
+    std::span<const vk::CommandBuffer> ParallelRecorder::recordDraws(const std::uint32_t frame_index,
+                                                                     const vk::Format color_format,
+                                                                     const vk::Pipeline& graphics_pipeline,
+                                                                     const FrameBindings& bindings,
+                                                                     const mesh::Mesh& mesh,
+                                                                     const vk::Extent2D& image_extent,
+                                                                     const scene::Scene& scene,
+                                                                     const std::span<const std::uint32_t> draws)
+    {
+        const auto draw_count{ static_cast<std::uint32_t>(draws.size()) };
+
+        // Split the draws into contiguous ranges, one per worker, keeping enough draws in each to be worthwhile
+        const auto chunk_count{ std::clamp(draw_count / MIN_DRAWS_PER_WORKER, 1u, m_worker_count) };
+        const auto draws_per_chunk{ draw_count / chunk_count };
+        const auto remainder{ draw_count % chunk_count };
+
+        auto& workers{ m_frames.at(frame_index) };
+        std::vector<std::future<void>> recordings;
+        recordings.reserve(chunk_count);
+        std::uint32_t first_draw{ 0 };
+        for (std::uint32_t i = 0; i < chunk_count; ++i) {
+            const auto chunk_draws{ draws.subspan(first_draw, draws_per_chunk + (i < remainder ? 1 : 0)) };
+            first_draw += static_cast<std::uint32_t>(chunk_draws.size());
+            recordings.push_back(m_workers.submit([&, worker = &workers[i], chunk_draws] {
+                m_device->resetCommandPool(worker->command_pool.get());
+                recordSecondaryDraws(worker->command_buffer,
+                                     color_format,
+                                     graphics_pipeline,
+                                     bindings,
+                                     mesh,
+                                     image_extent,
+                                     scene,
+                                     chunk_draws);
+            }));
+        }
+
+        // Wait for every worker before rethrowing, so no worker is still recording when the caller unwinds
+        for (auto& recording : recordings)
+            recording.wait();
+        for (auto& recording : recordings)
+            recording.get();
+
+        m_recorded.clear();
+        for (std::uint32_t i = 0; i < chunk_count; ++i)
+            m_recorded.push_back(workers[i].command_buffer);
+        return m_recorded;
+    }
+}
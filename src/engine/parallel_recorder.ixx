@@ -0,0 +1,98 @@
+module;
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+export module parallel_recorder;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import command;
+import mesh;
+import scene;
+import thread_pool;
+
+namespace eng::cmd {
+    /**
+     * The fewest draws given to each worker, below this the cost of waking a worker outweighs the recording it saves
+     */
+    export constexpr std::uint32_t MIN_DRAWS_PER_WORKER{ 64 };
+
+    /**
+     * Splits a frame's draws across worker threads, each recording into a secondary command buffer allocated
+     * from a command pool owned by that worker and frame slot. Pools are never shared between threads, so
+     * recording needs no locking, and each pool is reset as a whole once its frame slot is reused.
+     */
+    export class ParallelRecorder
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the per-worker, per-frame command pools and their secondary command buffers
+         * @param device the logical device which will own the pools
+         * @param queue_family the family of the queue the primary command buffers are submitted to
+         * @param frame_count the depth of the frames-in-flight ring
+         * @param worker_count the number of worker threads recording in parallel
+         */
+        ParallelRecorder(const vk::SharedDevice& device,
+                         std::uint32_t queue_family,
+                         std::uint32_t frame_count,
+                         std::uint32_t worker_count = static_cast<std::uint32_t>(util::ThreadPool::getDefaultThreadCount()));
+
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+        /* Recording Methods */
+
+        /**
+         * Records the draws across the workers, blocking until every worker has finished. The frame slot's
+         * previous submission must have completed.
+         * @param frame_index the frame slot being recorded
+         * @param color_format the color format of the render target
+         * @param graphics_pipeline the pipeline used for the draws
+         * @param bindings the frame's descriptor sets, bound in each secondary command buffer
+         * @param mesh the mesh drawn by each draw call
+         * @param image_extent the extent of the render target
+         * @param scene the scene whose objects are drawn
+         * @param draws the indices of the objects to draw, one draw call each
+         * @return the secondary command buffers in draw order, valid until the frame slot is next recorded
+         */
+        [[nodiscard]] std::span<const vk::CommandBuffer> recordDraws(std::uint32_t frame_index,
+                                                                     vk::Format color_format,
+                                                                     const vk::Pipeline& graphics_pipeline,
+                                                                     const FrameBindings& bindings,
+                                                                     const mesh::Mesh& mesh,
+                                                                     const vk::Extent2D& image_extent,
+                                                                     const scene::Scene& scene,
+                                                                     std::span<const std::uint32_t> draws);
+
+        /* Accessors */
+
+        [[nodiscard]] std::uint32_t getWorkerCount() const
+        { return m_worker_count; }
+
+        // Returns true if the draw count is large enough to be worth splitting across the workers
+        [[nodiscard]] bool isWorthwhile(const std::uint32_t draw_count) const
+        { return m_worker_count > 1 && draw_count >= 2 * MIN_DRAWS_PER_WORKER; }
+
+    private:
+        /* Data Members */
+
+        struct WorkerResources
+        {
+            vk::SharedCommandPool   command_pool;
+            vk::CommandBuffer       command_buffer;     // Freed with the pool
+        };
+
+        vk::SharedDevice                            m_device;
+        std::uint32_t                               m_worker_count;
+        std::vector<std::vector<WorkerResources>>   m_frames;       // Indexed by frame slot, then by worker
+        std::vector<vk::CommandBuffer>              m_recorded;
+
+        util::ThreadPool    m_workers;  // Declared last, so the workers are joined before the pools are destroyed
+    };
+}
@@ -1,32 +1,81 @@
 module;
 
 #include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 
 module pipeline;
 
 // Internal Dependencies
 import file_utils;
+import hash_utils;
 
 namespace eng::pipe {
-    vk::PipelineLayout createPipelineLayout(const vk::Device& device)
+    void validatePipelineDesc(const GraphicsPipelineDesc& desc)
     {
-        return device.createPipelineLayout(vk::PipelineLayoutCreateInfo());
+        if (const auto error{ desc.state.validationError() }; !error.empty())
+            throw std::invalid_argument(std::string{ error });
+        if (desc.state.depth.test && desc.depth_format == vk::Format::eUndefined)
+            throw std::invalid_argument("the depth test requires a depth attachment format");
+    }
+
+    std::uint64_t hashPipelineDesc(const GraphicsPipelineDesc& desc)
+    {
+        auto hash{ desc.state.key };
+        hash = util::hashValue(desc.color_format, hash);
+        hash = util::hashValue(desc.depth_format, hash);
+        hash = util::hashValue(desc.vertex_input.bindings.size(), hash);
+        for (const auto& binding : desc.vertex_input.bindings) {
+            hash = util::hashValue(binding.binding, hash);
+            hash = util::hashValue(binding.stride, hash);
+            hash = util::hashValue(binding.inputRate, hash);
+        }
+        hash = util::hashValue(desc.vertex_input.attributes.size(), hash);
+        for (const auto& attribute : desc.vertex_input.attributes) {
+            hash = util::hashValue(attribute.location, hash);
+            hash = util::hashValue(attribute.binding, hash);
+            hash = util::hashValue(attribute.format, hash);
+            hash = util::hashValue(attribute.offset, hash);
+        }
+        return hash;
+    }
+
+    vk::PipelineLayout createPipelineLayout(const vk::Device& device,
+                                            const std::span<const vk::DescriptorSetLayout> set_layouts,
+                                            const std::span<const vk::PushConstantRange> push_constant_ranges)
+    {
+        return device.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+            .setSetLayouts( set_layouts )
+            .setPushConstantRanges( push_constant_ranges )
+        );
     }
 
     vk::Pipeline createGraphicsPipeline(const vk::Device& device,
                                         const vk::PipelineLayout& layout,
-                                        const vk::PipelineRenderingCreateInfo& dynamic_rendering_info,
-                                        vk::PipelineCreateFlags flags)
+                                        const GraphicsPipelineDesc& desc,
+                                        vk::PipelineCreateFlags flags,
+                                        const vk::PipelineCache& pipeline_cache,
+                                        vk::PipelineCreationFeedback* creation_feedback,
+                                        ShaderModuleCache* shader_cache)
     {
+        validatePipelineDesc(desc);
+
+        // Acquire shared modules from the cache when one is provided, otherwise create single-use modules
+        const auto acquire_module = [&device, shader_cache](const std::string_view file_path) {
+            return shader_cache ? shader_cache->acquire(file_path) : createShaderModule(device, file_path);
+        };
+
         // Configure active shader stages
-        const vk::ShaderModule vertex_shader_module{ createShaderModule(device, "shaders/vert.spv") };
+        const vk::ShaderModule vertex_shader_module{ acquire_module(desc.state.shaders.vertex_path) };
         const auto vertex_shader = vk::PipelineShaderStageCreateInfo()
             .setStage( vk::ShaderStageFlagBits::eVertex )
             .setModule( vertex_shader_module )
             .setPName( "main" );
 
-        const vk::ShaderModule fragment_shader_module{ createShaderModule(device, "shaders/frag.spv") };
+        const vk::ShaderModule fragment_shader_module{ acquire_module(desc.state.shaders.fragment_path) };
         const auto fragment_shader = vk::PipelineShaderStageCreateInfo()
             .setStage( vk::ShaderStageFlagBits::eFragment )
             .setModule( fragment_shader_module )
@@ -34,22 +83,30 @@ namespace eng::pipe {
 
         const std::array shader_stages{ vertex_shader, fragment_shader };
 
-        // Configure fixed-function stages
-        const auto vertex_input_state{ configureVertexInputState() };
-        const auto input_assembly_state{ configureInputAssemblyState() };
+        // Configure fixed-function stages, the declarative state producing everything but the vertex layout
+        const auto vertex_input_state{ configureVertexInputState(desc.vertex_input) };
+        const auto input_assembly_state{ desc.state.inputAssemblyState() };
         const auto tessellation_state{ configureTessellationState() };
         const auto viewport_state{ configureViewportState() };
-        const auto rasterization_state{ configureRasterizationState() };
+        const auto rasterization_state{ desc.state.rasterizationState() };
         const auto multisample_state{ configureMultisampleState() };
-        const auto depth_stencil_state{ configureDepthStencilState() };
-        const auto color_blend_state{ configureColorBlendState() };
+        const auto depth_stencil_state{ desc.state.depthStencilState() };
+        const auto color_blend_attachment_state{ desc.state.colorBlendAttachmentState() };
+        const auto color_blend_state{ configureColorBlendState(color_blend_attachment_state) };
+        const auto dynamic_state{ desc.state.dynamicState() };
 
-        // Designate dynamic pipeline state
-        constexpr std::array dynamic_state_values{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
-        const auto dynamic_state{ setAsDynamicState(dynamic_state_values) };
+        // Describe the dynamic rendering attachment formats
+        const auto dynamic_rendering_info = vk::PipelineRenderingCreateInfo()
+            .setColorAttachmentFormats( desc.color_format )
+            .setDepthAttachmentFormat( desc.depth_format );
+
+        // Request creation feedback if the caller wants it, chained ahead of the dynamic rendering info
+        const auto feedback_info = vk::PipelineCreationFeedbackCreateInfo()
+            .setPPipelineCreationFeedback( creation_feedback )
+            .setPNext( &dynamic_rendering_info );
 
         // Create the pipeline
-        const auto create_info = vk::GraphicsPipelineCreateInfo()
+        auto create_info = vk::GraphicsPipelineCreateInfo()
             .setFlags( flags )
             .setStages( shader_stages )
             .setPVertexInputState( &vertex_input_state )
@@ -63,33 +120,60 @@ namespace eng::pipe {
             .setPDynamicState( &dynamic_state )
             .setLayout( layout )
             .setPNext( &dynamic_rendering_info );  // Dynamic rendering info must be attached in the pNext chain
-        const auto pipeline = device.createGraphicsPipeline({}, create_info);
+        if (creation_feedback)
+            create_info.setPNext( &feedback_info );
+        const auto pipeline = device.createGraphicsPipeline(pipeline_cache, create_info);
         if (pipeline.result != vk::Result::eSuccess)
             throw std::runtime_error("failed to create graphics pipeline");
 
-        device.destroyShaderModule(vertex_shader_module);
-        device.destroyShaderModule(fragment_shader_module);
+        if (!shader_cache) {
+            device.destroyShaderModule(vertex_shader_module);
+            device.destroyShaderModule(fragment_shader_module);
+        }
         return pipeline.value;
     }
 
-    vk::ShaderModule createShaderModule(const vk::Device& device,
-                                        const std::string_view file_path,
-                                        const vk::ShaderModuleCreateFlags flags)
+    vk::Pipeline createComputePipeline(const vk::Device& device,
+                                       const vk::PipelineLayout& layout,
+                                       const std::string_view shader_path,
+                                       const vk::PipelineCache& pipeline_cache,
+                                       ShaderModuleCache* shader_cache)
     {
-        const util::BytecodeBuffer shader_code{ util::readSPVFile(file_path) };
-        return device.createShaderModule({ flags, shader_code });
+        const vk::ShaderModule shader_module{
+            shader_cache ? shader_cache->acquire(shader_path) : createShaderModule(device, shader_path)
+        };
+        const auto create_info = vk::ComputePipelineCreateInfo()
+            .setStage( vk::PipelineShaderStageCreateInfo()
+                .setStage( vk::ShaderStageFlagBits::eCompute )
+                .setModule( shader_module )
+                .setPName( "main" ) )
+            .setLayout( layout );
+        const auto pipeline = device.createComputePipeline(pipeline_cache, create_info);
+        if (pipeline.result != vk::Result::eSuccess)
+            throw std::runtime_error("failed to create compute pipeline");
+
+        if (!shader_cache)
+            device.destroyShaderModule(shader_module);
+        return pipeline.value;
     }
 
-    vk::PipelineVertexInputStateCreateInfo configureVertexInputState()
+    vk::ShaderModule createShaderModule(const vk::Device& device,
+                                        const std::string_view file_path,
+                                        const vk::ShaderModuleCreateFlags flags)
     {
-        return vk::PipelineVertexInputStateCreateInfo();
+        const util::SPIRVFile shader_file{ file_path };
+        const auto shader_code{ shader_file.code() };
+        return device.createShaderModule(vk::ShaderModuleCreateInfo()
+            .setFlags( flags )
+            .setCodeSize( shader_code.size_bytes() )
+            .setPCode( shader_code.data() ));
     }
 
-    vk::PipelineInputAssemblyStateCreateInfo configureInputAssemblyState()
+    vk::PipelineVertexInputStateCreateInfo configureVertexInputState(const mesh::VertexInputDesc& vertex_input)
     {
-        return vk::PipelineInputAssemblyStateCreateInfo()
-            .setTopology( vk::PrimitiveTopology::eTriangleList )
-            .setPrimitiveRestartEnable( false );
+        return vk::PipelineVertexInputStateCreateInfo()
+            .setVertexBindingDescriptions( vertex_input.bindings )
+            .setVertexAttributeDescriptions( vertex_input.attributes );
     }
 
     vk::PipelineTessellationStateCreateInfo configureTessellationState()
@@ -105,48 +189,16 @@ namespace eng::pipe {
             .setScissorCount( 1 );
     }
 
-    vk::PipelineRasterizationStateCreateInfo configureRasterizationState()
-    {
-        return vk::PipelineRasterizationStateCreateInfo()
-            .setDepthClampEnable( false )
-            .setRasterizerDiscardEnable( false )
-            .setPolygonMode( vk::PolygonMode::eFill )
-            .setCullMode( vk::CullModeFlagBits::eBack )
-            .setFrontFace( vk::FrontFace::eCounterClockwise )
-            .setDepthBiasEnable( false );
-    }
-
     vk::PipelineMultisampleStateCreateInfo configureMultisampleState()
     {
         return vk::PipelineMultisampleStateCreateInfo();
     }
 
-    vk::PipelineDepthStencilStateCreateInfo configureDepthStencilState()
-    {
-        return vk::PipelineDepthStencilStateCreateInfo();
-    }
-
-    vk::PipelineColorBlendStateCreateInfo configureColorBlendState()
+    vk::PipelineColorBlendStateCreateInfo configureColorBlendState(const vk::PipelineColorBlendAttachmentState& attachment_state)
     {
         // Since we are using dynamic rendering, there will only be one color attachment state
-        constexpr auto alpha_blending = vk::PipelineColorBlendAttachmentState()
-            .setBlendEnable( true )
-            .setSrcColorBlendFactor( vk::BlendFactor::eSrcAlpha )
-            .setDstColorBlendFactor( vk::BlendFactor::eOneMinusSrcAlpha )
-            .setColorBlendOp( vk::BlendOp::eAdd )
-            .setSrcAlphaBlendFactor( vk::BlendFactor::eOne )
-            .setDstAlphaBlendFactor( vk::BlendFactor::eZero )
-            .setAlphaBlendOp( vk::BlendOp::eAdd )
-            .setColorWriteMask( vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA );
-
         return vk::PipelineColorBlendStateCreateInfo()
             .setLogicOpEnable( false )
-            .setAttachments( alpha_blending );
-    }
-
-    vk::PipelineDynamicStateCreateInfo setAsDynamicState(std::span<const vk::DynamicState> state_values)
-    {
-        return vk::PipelineDynamicStateCreateInfo()
-            .setDynamicStates( state_values );
+            .setAttachments( attachment_state );
     }
 }
@@ -1,20 +1,376 @@
 module;
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 
 export module pipeline;
 
+// External Dependencies
 import vulkan_hpp;
 
+// Internal Dependencies
+import concepts;
+import hash_utils;
+import mesh;
+import shader_cache;
+
 namespace eng::pipe {
+    /**
+     * The SPIR-V files for each programmable stage of a graphics pipeline. The paths are views, so descriptions
+     * remain usable in constant expressions, and must outlive every use of the description. The pipeline registry
+     * compiles from its own copies, so a requested description's paths need only outlive the request.
+     */
+    export struct ShaderSet
+    {
+        std::string_view vertex_path{ "shaders/vert.spv" };
+        std::string_view fragment_path{ "shaders/frag.spv" };
+
+        [[nodiscard]] constexpr bool operator==(const ShaderSet&) const = default;
+    };
+
+    /**
+     * How the fragment shader's output is combined with the render target
+     */
+    export enum class BlendMode : std::uint8_t
+    {
+        Opaque,         // Replaces the render target
+        Alpha,          // Blends by the output's alpha
+        Premultiplied,  // Blends an output whose color is already multiplied by its alpha
+        Additive        // Adds the output, weighted by its alpha
+    };
+
+    export struct RasterizationState
+    {
+        vk::PolygonMode polygon_mode{ vk::PolygonMode::eFill };
+        vk::CullModeFlags cull_mode{ vk::CullModeFlagBits::eBack };
+        vk::FrontFace front_face{ vk::FrontFace::eCounterClockwise };
+        bool depth_clamp{ false };  // Requires the depthClamp feature
+
+        [[nodiscard]] constexpr bool operator==(const RasterizationState&) const = default;
+    };
+
+    export struct DepthState
+    {
+        bool test{ false };     // Requires a depth attachment
+        bool write{ false };    // Requires the test
+        vk::CompareOp compare_op{ vk::CompareOp::eLess };
+
+        [[nodiscard]] constexpr bool operator==(const DepthState&) const = default;
+    };
+
+    /**
+     * The largest number of dynamic states a description may hold
+     */
+    export constexpr std::size_t MAX_DYNAMIC_STATES{ 8 };
+
+    /**
+     * A fixed-capacity list of dynamic states, so descriptions holding one remain usable in constant expressions
+     */
+    export struct DynamicStates
+    {
+        std::array<vk::DynamicState, MAX_DYNAMIC_STATES> states{ };
+        std::uint32_t count{ 0 };
+
+        /* Constructors */
+
+        constexpr DynamicStates() = default;
+
+        // Throws in a constant expression, failing compilation, if there are more than MAX_DYNAMIC_STATES states
+        constexpr DynamicStates(const std::initializer_list<vk::DynamicState> values)
+        {
+            if (values.size() > MAX_DYNAMIC_STATES)
+                throw std::length_error("too many dynamic states");
+            for (const auto value : values)
+                states[count++] = value;
+        }
+
+        /* Accessors */
+
+        [[nodiscard]] constexpr std::span<const vk::DynamicState> get() const
+        { return { states.data(), count }; }
+
+        [[nodiscard]] constexpr bool contains(const vk::DynamicState state) const
+        { return std::ranges::find(get(), state) != get().end(); }
+
+        [[nodiscard]] constexpr bool operator==(const DynamicStates& other) const
+        { return std::ranges::equal(get(), other.get()); }
+    };
+
+    /**
+     * The declarative state of a graphics pipeline which is independent of its render targets and vertex layout:
+     * the shader set, topology, rasterization, depth, blending and dynamic states. Descriptions are usable in
+     * constant expressions, so a pipeline declared as a constant is checked for invalid combinations of states and
+     * hashed at compile time by validate.
+     */
+    export struct PipelineDesc
+    {
+        ShaderSet shaders{ };
+        vk::PrimitiveTopology topology{ vk::PrimitiveTopology::eTriangleList };
+        bool primitive_restart{ false };    // Only valid for strip and fan topologies
+        RasterizationState rasterization{ };
+        DepthState depth{ };
+        BlendMode blend{ BlendMode::Alpha };
+        DynamicStates dynamic_states{ vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+
+        [[nodiscard]] constexpr bool operator==(const PipelineDesc&) const = default;
+
+        /* Validation Methods */
+
+        /**
+         * Checks the combination of states
+         * @return a description of the first invalid combination, or an empty string if the states are valid
+         */
+        [[nodiscard]] constexpr std::string_view validationError() const
+        {
+            if (shaders.vertex_path.empty() || shaders.fragment_path.empty())
+                return "every shader stage requires a SPIR-V file";
+            if (topology == vk::PrimitiveTopology::ePatchList)
+                return "patch lists require tessellation shaders, which the shader set cannot hold";
+            if (primitive_restart && isListTopology(topology))
+                return "primitive restart is only valid for strip and fan topologies";
+            if (depth.write && !depth.test)
+                return "depth writes require the depth test";
+
+            // The viewport state holds no viewport or scissor, so both are always set while recording
+            if (!dynamic_states.contains(vk::DynamicState::eViewport) || !dynamic_states.contains(vk::DynamicState::eScissor))
+                return "the viewport and scissor must be dynamic states";
+            for (std::uint32_t i = 0; i < dynamic_states.count; ++i) {
+                if (std::ranges::find(dynamic_states.get().subspan(i + 1), dynamic_states.states[i])
+                    != dynamic_states.get().end())
+                    return "dynamic states must be unique";
+            }
+            return { };
+        }
+
+        /* Hashing Methods */
+
+        /**
+         * Computes a stable 64-bit hash of the description, which only depends on the values of its states
+         * @return the hash of every state of the description
+         */
+        [[nodiscard]] constexpr std::uint64_t hash() const
+        {
+            auto hash{ util::fnv1a(shaders.vertex_path) };
+            hash = util::fnv1a(std::string_view{ "\0", 1 }, hash);  // Separates the paths, so ("ab", "c") != ("a", "bc")
+            hash = util::fnv1a(shaders.fragment_path, hash);
+            hash = util::hashValue(topology, hash);
+            hash = util::hashValue(primitive_restart, hash);
+            hash = util::hashValue(rasterization.polygon_mode, hash);
+            hash = util::hashValue(static_cast<vk::CullModeFlags::MaskType>(rasterization.cull_mode), hash);
+            hash = util::hashValue(rasterization.front_face, hash);
+            hash = util::hashValue(rasterization.depth_clamp, hash);
+            hash = util::hashValue(depth.test, hash);
+            hash = util::hashValue(depth.write, hash);
+            hash = util::hashValue(depth.compare_op, hash);
+            hash = util::hashValue(blend, hash);
+            hash = util::hashValue(dynamic_states.count, hash);
+            for (const auto state : dynamic_states.get())
+                hash = util::hashValue(state, hash);
+            return hash;
+        }
+
+        /* Create Info Methods */
+
+        [[nodiscard]] constexpr vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState() const
+        {
+            return vk::PipelineInputAssemblyStateCreateInfo()
+                .setTopology( topology )
+                .setPrimitiveRestartEnable( primitive_restart );
+        }
+
+        [[nodiscard]] constexpr vk::PipelineRasterizationStateCreateInfo rasterizationState() const
+        {
+            return vk::PipelineRasterizationStateCreateInfo()
+                .setDepthClampEnable( rasterization.depth_clamp )
+                .setRasterizerDiscardEnable( false )
+                .setPolygonMode( rasterization.polygon_mode )
+                .setCullMode( rasterization.cull_mode )
+                .setFrontFace( rasterization.front_face )
+                .setDepthBiasEnable( false )
+                .setLineWidth( 1.0f );
+        }
+
+        [[nodiscard]] constexpr vk::PipelineDepthStencilStateCreateInfo depthStencilState() const
+        {
+            return vk::PipelineDepthStencilStateCreateInfo()
+                .setDepthTestEnable( depth.test )
+                .setDepthWriteEnable( depth.write )
+                .setDepthCompareOp( depth.compare_op );
+        }
+
+        [[nodiscard]] constexpr vk::PipelineColorBlendAttachmentState colorBlendAttachmentState() const
+        {
+            auto attachment_state = vk::PipelineColorBlendAttachmentState()
+                .setBlendEnable( blend != BlendMode::Opaque )
+                .setColorBlendOp( vk::BlendOp::eAdd )
+                .setAlphaBlendOp( vk::BlendOp::eAdd )
+                .setColorWriteMask( vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
+                                  | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA );
+            switch (blend) {
+                case BlendMode::Opaque:
+                    break;
+                case BlendMode::Alpha:
+                    attachment_state
+                        .setSrcColorBlendFactor( vk::BlendFactor::eSrcAlpha )
+                        .setDstColorBlendFactor( vk::BlendFactor::eOneMinusSrcAlpha )
+                        .setSrcAlphaBlendFactor( vk::BlendFactor::eOne )
+                        .setDstAlphaBlendFactor( vk::BlendFactor::eZero );
+                    break;
+                case BlendMode::Premultiplied:
+                    attachment_state
+                        .setSrcColorBlendFactor( vk::BlendFactor::eOne )
+                        .setDstColorBlendFactor( vk::BlendFactor::eOneMinusSrcAlpha )
+                        .setSrcAlphaBlendFactor( vk::BlendFactor::eOne )
+                        .setDstAlphaBlendFactor( vk::BlendFactor::eOneMinusSrcAlpha );
+                    break;
+                case BlendMode::Additive:
+                    attachment_state
+                        .setSrcColorBlendFactor( vk::BlendFactor::eSrcAlpha )
+                        .setDstColorBlendFactor( vk::BlendFactor::eOne )
+                        .setSrcAlphaBlendFactor( vk::BlendFactor::eOne )
+                        .setDstAlphaBlendFactor( vk::BlendFactor::eOne );
+                    break;
+            }
+            return attachment_state;
+        }
+
+        // The returned state references the description's dynamic states, so the description must outlive it
+        [[nodiscard]] constexpr vk::PipelineDynamicStateCreateInfo dynamicState() const
+        {
+            return vk::PipelineDynamicStateCreateInfo()
+                .setDynamicStateCount( dynamic_states.count )
+                .setPDynamicStates( dynamic_states.states.data() );
+        }
+
+    private:
+        /* Helper Methods */
+
+        [[nodiscard]] static constexpr bool isListTopology(const vk::PrimitiveTopology topology)
+        {
+            return topology == vk::PrimitiveTopology::ePointList
+                || topology == vk::PrimitiveTopology::eLineList
+                || topology == vk::PrimitiveTopology::eTriangleList
+                || topology == vk::PrimitiveTopology::eLineListWithAdjacency
+                || topology == vk::PrimitiveTopology::eTriangleListWithAdjacency;
+        }
+    };
+
+    static_assert(concepts::ConstantDescription<PipelineDesc>);
+
+    /**
+     * A description together with its hash, the key it is looked up by. A description returned by validate has its
+     * key computed at compile time. Modifying its states afterwards leaves the key stale.
+     */
+    export template <concepts::ConstantDescription Desc>
+    struct HashedDesc : Desc
+    {
+        std::uint64_t key{ this->hash() };
+
+        [[nodiscard]] constexpr bool operator==(const HashedDesc&) const = default;
+    };
+
+    // Not constexpr, so reaching it in a constant expression fails compilation with the error in the diagnostic
+    [[noreturn]] inline void invalidDescription(const std::string_view error)
+    { throw std::invalid_argument(std::string{ error }); }
+
+    /**
+     * Checks and hashes a description in a constant expression, so a constant declared with an invalid combination
+     * of states fails to compile, reporting the invalid combination
+     * @param desc the description
+     * @return the description, with its key
+     */
+    export template <concepts::ConstantDescription Desc>
+    [[nodiscard]] consteval HashedDesc<Desc> validate(const Desc& desc)
+    {
+        if (const auto error{ desc.validationError() }; !error.empty())
+            invalidDescription(error);
+        return HashedDesc<Desc>{ desc };
+    }
+
+    /**
+     * Describes everything which distinguishes one graphics pipeline variant from another: the declarative pipeline
+     * state, the render target formats and the vertex layout
+     */
+    export struct GraphicsPipelineDesc
+    {
+        HashedDesc<PipelineDesc> state{ validate(PipelineDesc{ }) };
+        vk::Format color_format{ vk::Format::eUndefined };
+        vk::Format depth_format{ vk::Format::eUndefined };  // Undefined if the render targets have no depth attachment
+        mesh::VertexInputDesc vertex_input{ mesh::describeVertexInput<mesh::Vertex>() };
+
+        [[nodiscard]] bool operator==(const GraphicsPipelineDesc&) const = default;
+    };
+
+    /**
+     * Checks a description at runtime, for descriptions which are not constants
+     * @param desc the pipeline description
+     * @throws std::invalid_argument if its states are an invalid combination, or it depth tests without a depth format
+     */
+    export void validatePipelineDesc(const GraphicsPipelineDesc& desc);
+
+    /**
+     * Computes a stable 64-bit hash of a pipeline description, used as the key for pipeline lookup. The pipeline
+     * state contributes its precomputed key, so only the formats and the vertex input are hashed here.
+     * @param desc the pipeline description
+     * @return the hash of every field of the description
+     */
+    export [[nodiscard]] std::uint64_t hashPipelineDesc(const GraphicsPipelineDesc& desc);
+
     /* Pipeline Creation Methods */
 
-    export [[nodiscard]] vk::PipelineLayout createPipelineLayout(const vk::Device& device);
+    /**
+     * Creates a pipeline layout
+     * @param device the logical device which will own the layout
+     * @param set_layouts the descriptor set layouts, in set order
+     * @param push_constant_ranges the push constant ranges
+     * @return the pipeline layout
+     */
+    export [[nodiscard]] vk::PipelineLayout createPipelineLayout(const vk::Device& device,
+                                                                 std::span<const vk::DescriptorSetLayout> set_layouts = {},
+                                                                 std::span<const vk::PushConstantRange> push_constant_ranges = {});
 
+    /**
+     * Creates the graphics pipeline
+     * @param device the logical device which will own the pipeline
+     * @param layout the pipeline layout
+     * @param desc the shader set and fixed-function state of the pipeline
+     * @param flags the pipeline creation flags
+     * @param pipeline_cache optional cache used to skip compilation of previously created pipelines
+     * @param creation_feedback optional output, receives the driver's whole-pipeline creation feedback
+     * @param shader_cache optional cache the shader modules are acquired from, if omitted, the modules are created
+     *                     for this pipeline alone and destroyed once it has been created
+     * @return a newly created graphics pipeline
+     */
     export [[nodiscard]] vk::Pipeline createGraphicsPipeline(const vk::Device& device,
                                                              const vk::PipelineLayout& layout,
-                                                             const vk::PipelineRenderingCreateInfo& dynamic_rendering_info,
-                                                             vk::PipelineCreateFlags flags = {});
+                                                             const GraphicsPipelineDesc& desc,
+                                                             vk::PipelineCreateFlags flags = {},
+                                                             const vk::PipelineCache& pipeline_cache = {},
+                                                             vk::PipelineCreationFeedback* creation_feedback = nullptr,
+                                                             ShaderModuleCache* shader_cache = nullptr);
+
+    /**
+     * Creates a compute pipeline
+     * @param device the logical device which will own the pipeline
+     * @param layout the pipeline layout
+     * @param shader_path the path of the compute shader's SPIR-V file
+     * @param pipeline_cache optional cache used to skip compilation of a previously created pipeline
+     * @param shader_cache optional cache the shader module is acquired from, if omitted, the module is created
+     *                     for this pipeline alone and destroyed once it has been created
+     * @return a newly created compute pipeline
+     */
+    export [[nodiscard]] vk::Pipeline createComputePipeline(const vk::Device& device,
+                                                            const vk::PipelineLayout& layout,
+                                                            std::string_view shader_path,
+                                                            const vk::PipelineCache& pipeline_cache = {},
+                                                            ShaderModuleCache* shader_cache = nullptr);
 
     /* Creation Helper Methods */
 
@@ -22,21 +378,14 @@ namespace eng::pipe {
                                                       std::string_view file_path,
                                                       vk::ShaderModuleCreateFlags flags = {});
 
-    [[nodiscard]] vk::PipelineVertexInputStateCreateInfo configureVertexInputState();
-
-    [[nodiscard]] vk::PipelineInputAssemblyStateCreateInfo configureInputAssemblyState();
+    // The returned state references the description's arrays, so the description must outlive it
+    [[nodiscard]] vk::PipelineVertexInputStateCreateInfo configureVertexInputState(const mesh::VertexInputDesc& vertex_input);
 
     [[nodiscard]] vk::PipelineTessellationStateCreateInfo configureTessellationState();
 
     [[nodiscard]] vk::PipelineViewportStateCreateInfo configureViewportState();
 
-    [[nodiscard]] vk::PipelineRasterizationStateCreateInfo configureRasterizationState();
-
     [[nodiscard]] vk::PipelineMultisampleStateCreateInfo configureMultisampleState();
 
-    [[nodiscard]] vk::PipelineDepthStencilStateCreateInfo configureDepthStencilState();
-
-    [[nodiscard]] vk::PipelineColorBlendStateCreateInfo configureColorBlendState();
-
-    [[nodiscard]] vk::PipelineDynamicStateCreateInfo setAsDynamicState(std::span<const vk::DynamicState> state_values);
+    [[nodiscard]] vk::PipelineColorBlendStateCreateInfo configureColorBlendState(const vk::PipelineColorBlendAttachmentState& attachment_state);
 }
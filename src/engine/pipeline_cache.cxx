@@ -0,0 +1,88 @@
+module;
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <utility>
+#include <vector>
+
+module pipeline_cache;
+
+// Internal Dependencies
+import debug_utils;
+import file_utils;
+
+namespace eng::pipe {
+    PipelineCache::PipelineCache(const vk::SharedDevice& device,
+                                 const GPU& gpu,
+                                 std::filesystem::path file_path)
+        : m_device{ device },
+          m_file_path{ std::move(file_path) }
+    {
+        // Seed the cache with the on-disk blob only if it was produced for this exact device
+        const auto blob{ util::readBinaryFile(m_file_path) };
+        auto create_info{ vk::PipelineCacheCreateInfo() };
+        if (blob && isCompatible(*blob, gpu.getProperties())) {
+            create_info.setInitialDataSize( blob->size() );
+            create_info.setPInitialData( blob->data() );
+            m_loaded_bytes = blob->size();
+        }
+
+        m_cache = vk::SharedPipelineCache{ device->createPipelineCache(create_info), device };
+        dbg::setObjectName(device, m_cache.get(), "pipeline cache");
+    }
+
+    void PipelineCache::save() const
+    {
+        const auto data{ m_device->getPipelineCacheData(m_cache.get()) };
+        util::writeFileAtomically(m_file_path, std::as_bytes(std::span{ data }));
+    }
+
+    void PipelineCache::recordCreation(const vk::PipelineCreationFeedback& feedback)
+    {
+        if (!(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid))
+            return;
+
+        if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit)
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+        else
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+        m_creation_ns.fetch_add(feedback.duration, std::memory_order_relaxed);
+    }
+
+    PipelineCacheStatistics PipelineCache::getStatistics() const
+    {
+        return {
+            m_hits.load(std::memory_order_relaxed),
+            m_misses.load(std::memory_order_relaxed),
+            static_cast<double>(m_creation_ns.load(std::memory_order_relaxed)) / 1'000'000.0,
+            m_loaded_bytes
+        };
+    }
+
+    bool PipelineCache::isCompatible(const std::span<const std::byte> blob,
+                                     const vk::PhysicalDeviceProperties& properties)
+    {
+        // Mirrors VkPipelineCacheHeaderVersionOne, which is tightly packed
+        struct {
+            std::uint32_t header_size;
+            std::uint32_t header_version;
+            std::uint32_t vendor_id;
+            std::uint32_t device_id;
+            std::uint8_t  uuid[vk::UuidSize];
+        } header{ };
+        static_assert(sizeof(header) == 16 + vk::UuidSize);
+
+        if (blob.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, blob.data(), sizeof(header));
+
+        return header.header_size >= sizeof(header)
+            && header.header_size <= blob.size()
+            && header.header_version == static_cast<std::uint32_t>(vk::PipelineCacheHeaderVersion::eOne)
+            && header.vendor_id == properties.vendorID
+            && header.device_id == properties.deviceID
+            && std::ranges::equal(header.uuid, properties.pipelineCacheUUID);
+    }
+}
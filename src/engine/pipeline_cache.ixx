@@ -0,0 +1,102 @@
+module;
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+export module pipeline_cache;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import gpu;
+
+namespace eng::pipe {
+    /**
+     * The default on-disk location of the pipeline cache, relative to the working directory
+     */
+    export inline const std::filesystem::path DEFAULT_CACHE_PATH{ "cache/pipeline_cache.bin" };
+
+    export struct PipelineCacheStatistics
+    {
+        std::uint32_t hits{ 0 };            // Pipelines created entirely from cached data
+        std::uint32_t misses{ 0 };          // Pipelines which required driver compilation
+        double creation_ms{ 0.0 };          // Total time spent creating pipelines, as reported by the driver
+        std::size_t loaded_bytes{ 0 };      // Size of the blob accepted at startup, zero if none was accepted
+    };
+
+    /**
+     * Owns a pipeline cache which is seeded from disk at startup and persisted on save, so subsequent runs on the
+     * same device and driver can skip shader compilation
+     */
+    export class PipelineCache
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the pipeline cache, seeding it with the on-disk blob if the blob was produced by the same device
+         * @param device the logical device which will own the cache
+         * @param gpu the GPU the pipelines will be created for, used to validate the blob's header
+         * @param file_path the path of the cache blob to load and save
+         */
+        PipelineCache(const vk::SharedDevice& device,
+                      const GPU& gpu,
+                      std::filesystem::path file_path = DEFAULT_CACHE_PATH);
+
+        // The statistics counters are shared with in-flight compilations, so the cache is pinned in place
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        /* Persistence Methods */
+
+        /**
+         * Writes the current contents of the cache, including any pipelines created this session, to disk.
+         * The write is atomic, so a crash mid-save never leaves a truncated blob behind.
+         * @throws std::runtime_error if the blob could not be written
+         */
+        void save() const;
+
+        /* Statistics Methods */
+
+        /**
+         * Records the driver's creation feedback for a pipeline created with this cache. May be called concurrently.
+         * @param feedback the whole-pipeline creation feedback returned by the driver
+         */
+        void recordCreation(const vk::PipelineCreationFeedback& feedback);
+
+        [[nodiscard]] PipelineCacheStatistics getStatistics() const;
+
+        /* Accessors */
+
+        [[nodiscard]] vk::PipelineCache get() const
+        { return m_cache.get(); }
+
+        [[nodiscard]] const std::filesystem::path& getPath() const
+        { return m_file_path; }
+
+    private:
+        /* Data Members */
+
+        vk::SharedDevice                m_device;
+        vk::SharedPipelineCache         m_cache;
+        std::filesystem::path           m_file_path;
+        std::size_t                     m_loaded_bytes{ 0 };
+        std::atomic<std::uint32_t>      m_hits{ 0 };
+        std::atomic<std::uint32_t>      m_misses{ 0 };
+        std::atomic<std::uint64_t>      m_creation_ns{ 0 };
+
+        /* Helper Methods */
+
+        /**
+         * Validates a cache blob's header against the target GPU, as the driver may otherwise silently ignore it
+         * @param blob the contents of the on-disk cache
+         * @param properties the properties of the target GPU
+         * @return true if the blob was created by the same vendor, device and pipeline cache UUID
+         */
+        [[nodiscard]] static bool isCompatible(std::span<const std::byte> blob,
+                                               const vk::PhysicalDeviceProperties& properties);
+    };
+}
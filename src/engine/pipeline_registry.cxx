@@ -0,0 +1,69 @@
+module;
+
+#include <format>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+module pipeline_registry;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::pipe {
+    PipelineHandle PipelineRegistry::request(const GraphicsPipelineDesc& desc)
+    {
+        // The state's part of the key was computed with the state, at compile time for constants, so a requested
+        // variant costs hashing its formats and vertex input, and one lookup
+        const auto key{ hashPipelineDesc(desc) };
+        const std::scoped_lock lock{ m_mutex };
+        if (const auto iter{ m_pipelines.find(key) }; iter != m_pipelines.end())
+            return iter->second;
+
+        // Invalid descriptions are rejected here rather than surfacing from the compile task
+        validatePipelineDesc(desc);
+
+        // Queue the compile, the task holds its own references so it may outlive this call. The caller's shader paths
+        // need only outlive this call, so the task owns copies and compiles a description viewing them.
+        auto compile = [device = m_device, layout = m_layout, &cache = m_cache, &shader_modules = m_shader_modules, desc,
+                        vertex_path = std::string{ desc.state.shaders.vertex_path },
+                        fragment_path = std::string{ desc.state.shaders.fragment_path }, key] {
+            auto owned_desc{ desc };
+            owned_desc.state.shaders = { .vertex_path = vertex_path, .fragment_path = fragment_path };
+            vk::PipelineCreationFeedback creation_feedback{ };
+            vk::SharedPipeline pipeline{
+                createGraphicsPipeline(device, layout, owned_desc, {}, cache.get(), &creation_feedback, &shader_modules),
+                device
+            };
+            dbg::setObjectName(device, pipeline.get(), "graphics pipeline {:#018x}", key);
+            cache.recordCreation(creation_feedback);
+            return pipeline;
+        };
+        PipelineHandle handle{ key, m_workers.submit(std::move(compile)).share() };
+        m_pipelines.emplace(key, handle);
+        return handle;
+    }
+
+    std::optional<PipelineHandle> PipelineRegistry::find(const std::uint64_t key) const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        if (const auto iter{ m_pipelines.find(key) }; iter != m_pipelines.end())
+            return iter->second;
+        return std::nullopt;
+    }
+
+    void PipelineRegistry::waitForPending() const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        for (const auto& [ key, handle ] : m_pipelines)
+            handle.wait();
+    }
+
+    std::size_t PipelineRegistry::size() const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        return m_pipelines.size();
+    }
+}
@@ -0,0 +1,141 @@
+module;
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+export module pipeline_registry;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import pipeline;
+import pipeline_cache;
+import shader_cache;
+import thread_pool;
+
+namespace eng::pipe {
+    /**
+     * A reference to a pipeline variant which may still be compiling on a worker thread
+     */
+    export class PipelineHandle
+    {
+    public:
+        /* Constructors */
+
+        PipelineHandle() = default;
+
+        PipelineHandle(const std::uint64_t key, std::shared_future<vk::SharedPipeline> pipeline)
+            : m_key{ key },
+              m_pipeline{ std::move(pipeline) }
+        {}
+
+        /* Accessors */
+
+        [[nodiscard]] std::uint64_t getKey() const
+        { return m_key; }
+
+        [[nodiscard]] bool isValid() const
+        { return m_pipeline.valid(); }
+
+        // Returns true once compilation has finished, whether or not it succeeded
+        [[nodiscard]] bool isReady() const
+        { return isValid() && m_pipeline.wait_for(std::chrono::seconds::zero()) == std::future_status::ready; }
+
+        // Blocks until compilation has finished, without rethrowing any compilation error
+        void wait() const
+        {
+            if (isValid())
+                m_pipeline.wait();
+        }
+
+        /**
+         * Retrieves the compiled pipeline, blocking until compilation has finished
+         * @return the compiled pipeline
+         * @throws std::runtime_error or vk::SystemError if the pipeline failed to compile
+         */
+        [[nodiscard]] const vk::SharedPipeline& get() const
+        { return m_pipeline.get(); }
+
+        [[nodiscard]] bool operator==(const PipelineHandle& other) const
+        { return m_key == other.m_key; }
+
+    private:
+        /* Data Members */
+
+        std::uint64_t                           m_key{ 0 };
+        std::shared_future<vk::SharedPipeline>  m_pipeline;
+    };
+
+    /**
+     * Deduplicates graphics pipeline variants by the hash of their description and compiles new variants
+     * asynchronously on a worker thread pool. All variants share one pipeline layout and one pipeline cache.
+     */
+    export class PipelineRegistry
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates an empty registry
+         * @param device the logical device which will own the pipelines
+         * @param layout the pipeline layout shared by all variants
+         * @param cache the pipeline cache used for compilation, must outlive the registry and any pending compiles
+         * @param shader_modules the cache shader modules are shared through, must outlive any pending compiles
+         * @param workers the thread pool compilations are submitted to, must outlive the registry
+         */
+        PipelineRegistry(vk::SharedDevice device,
+                         vk::SharedPipelineLayout layout,
+                         PipelineCache& cache,
+                         ShaderModuleCache& shader_modules,
+                         util::ThreadPool& workers)
+            : m_device{ std::move(device) },
+              m_layout{ std::move(layout) },
+              m_cache{ cache },
+              m_shader_modules{ shader_modules },
+              m_workers{ workers }
+        {}
+
+        PipelineRegistry(const PipelineRegistry&) = delete;
+        PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+        /* Lookup Methods */
+
+        /**
+         * Returns a handle to the pipeline matching the description's key, queueing a compile if the variant is new
+         * @param desc the pipeline description, which is only validated when first requested
+         * @return a handle which resolves once the variant has been compiled
+         * @throws std::invalid_argument if the variant is new and its description is invalid
+         */
+        [[nodiscard]] PipelineHandle request(const GraphicsPipelineDesc& desc);
+
+        /**
+         * Looks up a previously requested variant by its key
+         * @param key the hash of the variant's description, as returned by PipelineHandle::getKey
+         * @return the handle for the variant, or std::nullopt if it was never requested
+         */
+        [[nodiscard]] std::optional<PipelineHandle> find(std::uint64_t key) const;
+
+        // Blocks until every queued compile has finished
+        void waitForPending() const;
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        /* Data Members */
+
+        vk::SharedDevice            m_device;
+        vk::SharedPipelineLayout    m_layout;
+        PipelineCache&              m_cache;
+        ShaderModuleCache&          m_shader_modules;
+        util::ThreadPool&           m_workers;
+
+        mutable std::mutex                                  m_mutex;
+        std::unordered_map<std::uint64_t, PipelineHandle>   m_pipelines;
+    };
+}
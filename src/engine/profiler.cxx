@@ -0,0 +1,153 @@
+module;
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <numeric>
+#include <string>
+#include <vector>
+
+module profiler;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::prof {
+    void RollingSamples::push(const double sample)
+    {
+        if (m_capacity == 0)
+            return;
+
+        if (m_samples.size() < m_capacity)
+            m_samples.push_back(sample);
+        else
+            m_samples[m_next] = sample;
+        m_next = (m_next + 1) % m_capacity;
+    }
+
+    void RollingSamples::clear()
+    {
+        m_samples.clear();
+        m_next = 0;
+    }
+
+    PhaseSummary RollingSamples::summarize() const
+    {
+        if (m_samples.empty())
+            return { };
+
+        std::vector<double> sorted{ m_samples };
+        std::ranges::sort(sorted);
+
+        // Nearest-rank percentile, i.e., the smallest sample greater than or equal to p% of the samples
+        const auto percentile = [&sorted](const double p) {
+            const auto rank{ static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size()))) };
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        };
+
+        return {
+            sorted.size(),
+            std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size()),
+            percentile(50.0),
+            percentile(95.0),
+            percentile(99.0),
+            sorted.back()
+        };
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - m_start };
+        m_profiler.record(m_phase, elapsed.count());
+    }
+
+    Profiler::Profiler(const vk::SharedDevice& device,
+                       const GPU& gpu,
+                       const std::uint32_t frame_count,
+                       const std::size_t sample_window)
+        : m_device{ device },
+          m_timestamps_written(frame_count, false)
+    {
+        m_phases.fill(RollingSamples{ sample_window });
+
+        // Timestamps are only measured when the graphics queue is guaranteed to support them
+        const auto& limits{ gpu.getProperties().limits };
+        if (!limits.timestampComputeAndGraphics)
+            return;
+
+        m_timestamp_period = limits.timestampPeriod;
+        m_query_pool = vk::SharedQueryPool{ device->createQueryPool(vk::QueryPoolCreateInfo()
+            .setQueryType( vk::QueryType::eTimestamp )
+            .setQueryCount( frame_count * QUERIES_PER_FRAME )
+        ), device };
+        dbg::setObjectName(device, m_query_pool.get(), "frame timestamps");
+    }
+
+    void Profiler::record(const Phase phase, const double milliseconds)
+    {
+        m_phases[static_cast<std::size_t>(phase)].push(milliseconds);
+    }
+
+    void Profiler::reset()
+    {
+        for (auto& samples : m_phases)
+            samples.clear();
+    }
+
+    void Profiler::markTimestampsWritten(const std::uint32_t frame_slot)
+    {
+        if (supportsTimestamps())
+            m_timestamps_written[frame_slot] = true;
+    }
+
+    void Profiler::collectTimestamps(const std::uint32_t frame_slot)
+    {
+        if (!supportsTimestamps() || !m_timestamps_written[frame_slot])
+            return;
+
+        const auto query_results{ m_device->getQueryPoolResults<std::uint64_t>(
+            m_query_pool.get(),
+            getFirstQuery(frame_slot),
+            QUERIES_PER_FRAME,
+            QUERIES_PER_FRAME * sizeof(std::uint64_t),
+            sizeof(std::uint64_t),
+            vk::QueryResultFlagBits::e64
+        ) };
+        m_timestamps_written[frame_slot] = false;
+        const auto& timestamps{ query_results.value };
+        if (query_results.result != vk::Result::eSuccess || timestamps[1] < timestamps[0])
+            return;
+
+        const double elapsed_ns{ static_cast<double>(timestamps[1] - timestamps[0]) * m_timestamp_period };
+        record(Phase::GpuRender, elapsed_ns / 1'000'000.0);
+    }
+
+    std::string Profiler::exportJSON() const
+    {
+        std::string json{ "{\n  \"unit\": \"ms\",\n  \"phases\": {" };
+        for (std::size_t i = 0; i < m_phases.size(); ++i) {
+            const auto phase{ static_cast<Phase>(i) };
+            const auto [ count, mean, p50, p95, p99, max ]{ summarize(phase) };
+            json += std::format(
+                "{}\n    \"{}\": {{ \"samples\": {}, \"mean\": {:.4f}, \"p50\": {:.4f}, "
+                "\"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f} }}",
+                i == 0 ? "" : ",", getPhaseName(phase), count, mean, p50, p95, p99, max
+            );
+        }
+        json += "\n  }\n}\n";
+        return json;
+    }
+
+    std::string Profiler::exportCSV() const
+    {
+        std::string csv{ "phase,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n" };
+        for (std::size_t i = 0; i < m_phases.size(); ++i) {
+            const auto phase{ static_cast<Phase>(i) };
+            const auto [ count, mean, p50, p95, p99, max ]{ summarize(phase) };
+            csv += std::format("{},{},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f}\n",
+                               getPhaseName(phase), count, mean, p50, p95, p99, max);
+        }
+        return csv;
+    }
+}
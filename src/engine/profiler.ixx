@@ -0,0 +1,216 @@
+module;
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module profiler;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import gpu;
+
+namespace eng::prof {
+    /**
+     * The number of most recent samples retained per phase when computing percentiles
+     */
+    export constexpr std::size_t DEFAULT_SAMPLE_WINDOW{ 1024 };
+
+    /**
+     * The measured phases of a frame. CPU phases are timed with scoped timers around each step of drawFrame,
+     * while the GPU phase is measured with timestamp queries written into the frame's command buffer.
+     */
+    export enum class Phase : std::uint8_t
+    {
+        FrameWait,
+        Acquire,
+        Record,
+        Submit,
+        Present,
+        Frame,
+        GpuRender,
+        PresentWait,        // Waiting for earlier presents to reach the display before starting the frame
+        PresentLatency,     // From the start of a frame to its image reaching the display, with present wait
+        Cull,               // Culling the scene on the CPU, within recording
+        Count
+    };
+
+    /**
+     * Returns the name of a phase as it appears in exported reports
+     */
+    export [[nodiscard]] constexpr std::string_view getPhaseName(const Phase phase)
+    {
+        constexpr std::array<std::string_view, static_cast<std::size_t>(Phase::Count)> names{
+            "frame_wait", "acquire", "record", "submit", "present", "frame", "gpu_render", "present_wait", "present_latency",
+            "cull"
+        };
+        return names[static_cast<std::size_t>(phase)];
+    }
+
+    /**
+     * Summary statistics for a single phase over the sample window, in milliseconds
+     */
+    export struct PhaseSummary
+    {
+        std::size_t sample_count{ 0 };
+        double mean{ 0.0 };
+        double p50{ 0.0 };
+        double p95{ 0.0 };
+        double p99{ 0.0 };
+        double max{ 0.0 };
+    };
+
+    /**
+     * A fixed-capacity ring of samples which overwrites the oldest sample once full
+     */
+    export class RollingSamples
+    {
+    public:
+        /* Constructors */
+
+        explicit RollingSamples(const std::size_t capacity = DEFAULT_SAMPLE_WINDOW)
+            : m_capacity{ capacity }
+        { m_samples.reserve(capacity); }
+
+        /* Sample Methods */
+
+        void push(double sample);
+
+        void clear();
+
+        /**
+         * Computes the summary statistics for the retained samples, using the nearest-rank percentile method
+         * @return the summary of the current sample window, or an empty summary if no samples were recorded
+         */
+        [[nodiscard]] PhaseSummary summarize() const;
+
+    private:
+        /* Data Members */
+
+        std::size_t         m_capacity;
+        std::size_t         m_next{ 0 };
+        std::vector<double> m_samples;
+    };
+
+    export class Profiler;
+
+    /**
+     * Records the elapsed CPU time between its construction and destruction to a profiler phase
+     */
+    export class ScopedTimer
+    {
+    public:
+        /* Constructors */
+
+        ScopedTimer(Profiler& profiler, const Phase phase)
+            : m_profiler{ profiler },
+              m_phase{ phase },
+              m_start{ std::chrono::steady_clock::now() }
+        {}
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        /* Destructor */
+
+        ~ScopedTimer();
+
+    private:
+        /* Data Members */
+
+        Profiler&                               m_profiler;
+        Phase                                   m_phase;
+        std::chrono::steady_clock::time_point   m_start;
+    };
+
+    export class Profiler
+    {
+    public:
+        /* Constructors */
+
+        // Default Constructor, records CPU timings only
+        Profiler() = default;
+
+        /**
+         * Creates a profiler which also measures GPU execution time with timestamp queries, if the GPU supports them
+         * @param device the logical device which will own the query pool
+         * @param gpu the GPU the frames are executed on
+         * @param frame_count the depth of the frames-in-flight ring, one pair of queries is reserved per slot
+         * @param sample_window the number of most recent samples retained per phase
+         */
+        Profiler(const vk::SharedDevice& device,
+                 const GPU& gpu,
+                 std::uint32_t frame_count,
+                 std::size_t sample_window = DEFAULT_SAMPLE_WINDOW);
+
+        /* Recording Methods */
+
+        void record(Phase phase, double milliseconds);
+
+        // Discards all recorded samples, e.g., to exclude warm-up frames from a measurement
+        void reset();
+
+        [[nodiscard]] ScopedTimer scope(const Phase phase)
+        { return { *this, phase }; }
+
+        /**
+         * Marks that the slot's command buffer has written its timestamp queries, so they can be collected
+         * once the slot's frame has next completed
+         * @param frame_slot the index of the frame slot in the frames-in-flight ring
+         */
+        void markTimestampsWritten(std::uint32_t frame_slot);
+
+        /**
+         * Reads back the timestamp queries of a completed frame slot and records the GPU execution time.
+         * Must only be called once the slot's frame has completed.
+         * @param frame_slot the index of the frame slot in the frames-in-flight ring
+         */
+        void collectTimestamps(std::uint32_t frame_slot);
+
+        /* Accessors */
+
+        [[nodiscard]] bool supportsTimestamps() const
+        { return static_cast<bool>(m_query_pool); }
+
+        [[nodiscard]] vk::QueryPool getQueryPool() const
+        { return m_query_pool.get(); }
+
+        [[nodiscard]] static std::uint32_t getFirstQuery(const std::uint32_t frame_slot)
+        { return frame_slot * QUERIES_PER_FRAME; }
+
+        [[nodiscard]] PhaseSummary summarize(const Phase phase) const
+        { return m_phases[static_cast<std::size_t>(phase)].summarize(); }
+
+        /* Export Methods */
+
+        /**
+         * Exports the summary of every phase as a JSON object keyed by phase name
+         * @return a JSON document with per-phase sample counts, means and percentiles in milliseconds
+         */
+        [[nodiscard]] std::string exportJSON() const;
+
+        /**
+         * Exports the summary of every phase as CSV, with a header row and one row per phase
+         * @return a CSV document with per-phase sample counts, means and percentiles in milliseconds
+         */
+        [[nodiscard]] std::string exportCSV() const;
+
+    private:
+        /* Constants */
+
+        static constexpr std::uint32_t QUERIES_PER_FRAME{ 2 };
+
+        /* Data Members */
+
+        std::array<RollingSamples, static_cast<std::size_t>(Phase::Count)> m_phases;
+        vk::SharedDevice    m_device;
+        vk::SharedQueryPool m_query_pool;
+        double              m_timestamp_period{ 0.0 };  // Nanoseconds per timestamp tick
+        std::vector<bool>   m_timestamps_written;       // Indexed by frame slot
+    };
+}
@@ -0,0 +1,120 @@
+module;
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+module queue_scheduler;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::sched {
+    namespace {
+        constexpr std::array<const char*, QUEUE_TYPE_COUNT> QUEUE_NAMES{ "graphics", "compute", "transfer" };
+    }
+
+    QueueScheduler::QueueScheduler(vk::SharedDevice device, const GPU& gpu)
+        : m_device{ std::move(device) }
+    {
+        const std::array family_indices{
+            gpu.getGraphicsFamilyIndex(),
+            gpu.getComputeFamilyIndex(),
+            gpu.getTransferFamilyIndex()
+        };
+        for (std::size_t i = 0; i < QUEUE_TYPE_COUNT; ++i) {
+            auto timeline_info = vk::SemaphoreTypeCreateInfo()
+                .setSemaphoreType( vk::SemaphoreType::eTimeline )
+                .setInitialValue( 0 );
+            m_queues[i] = {
+                m_device->getQueue(family_indices[i], 0),
+                family_indices[i],
+                vk::SharedSemaphore{ m_device->createSemaphore(vk::SemaphoreCreateInfo().setPNext( &timeline_info )), m_device }
+            };
+            dbg::setObjectName(m_device, m_queues[i].timeline.get(), "{} timeline", QUEUE_NAMES[i]);
+        }
+
+        // Queues shared between logical queue types keep the name of the first, e.g., graphics
+        for (std::size_t i = QUEUE_TYPE_COUNT; i-- > 0;)
+            dbg::setObjectName(m_device, m_queues[i].queue, "{} queue", QUEUE_NAMES[i]);
+    }
+
+    std::uint64_t QueueScheduler::submit(const QueueType queue,
+                                         const std::span<const vk::CommandBuffer> command_buffers,
+                                         const std::span<const QueueWait> queue_waits,
+                                         const std::span<const vk::SemaphoreSubmitInfo> binary_waits,
+                                         const std::span<const vk::SemaphoreSubmitInfo> binary_signals)
+    {
+        auto& scheduled{ m_queues[index(queue)] };
+
+        m_wait_scratch.assign(binary_waits.begin(), binary_waits.end());
+        for (const auto& [ wait_queue, value, stages ] : queue_waits) {
+            if (value == 0)
+                continue;
+            m_wait_scratch.push_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore( getTimeline(wait_queue) )
+                .setValue( value )
+                .setStageMask( stages ));
+        }
+
+        // The timeline signal covers every command of the submission, and everything submitted before it
+        const auto value{ scheduled.submitted + 1 };
+        m_signal_scratch.assign(binary_signals.begin(), binary_signals.end());
+        m_signal_scratch.push_back(vk::SemaphoreSubmitInfo()
+            .setSemaphore( scheduled.timeline.get() )
+            .setValue( value )
+            .setStageMask( vk::PipelineStageFlagBits2::eAllCommands ));
+
+        m_command_buffer_scratch.clear();
+        for (const auto& command_buffer : command_buffers)
+            m_command_buffer_scratch.push_back(vk::CommandBufferSubmitInfo().setCommandBuffer( command_buffer ));
+
+        scheduled.queue.submit2(vk::SubmitInfo2()
+            .setWaitSemaphoreInfos( m_wait_scratch )
+            .setCommandBufferInfos( m_command_buffer_scratch )
+            .setSignalSemaphoreInfos( m_signal_scratch ));
+        scheduled.submitted = value;
+        return value;
+    }
+
+    std::chrono::nanoseconds QueueScheduler::wait(const QueueType queue,
+                                                  const std::uint64_t value,
+                                                  const std::chrono::nanoseconds timeout)
+    {
+        // Polling the counter is far cheaper than a wait which would return immediately
+        ++m_wait_statistics.waits;
+        if (getCompletedValue(queue) >= value)
+            return std::chrono::nanoseconds{ 0 };
+
+        const std::array semaphores{ getTimeline(queue) };
+        const std::array values{ value };
+        const auto start{ std::chrono::steady_clock::now() };
+        const auto result{ m_device->waitSemaphores(vk::SemaphoreWaitInfo()
+            .setSemaphores( semaphores )
+            .setValues( values ), static_cast<std::uint64_t>(timeout.count())) };
+        const auto blocked{ std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start) };
+
+        ++m_wait_statistics.blocking_waits;
+        m_wait_statistics.blocked += blocked;
+        if (result == vk::Result::eTimeout)
+            throw std::runtime_error("timed out waiting for queue timeline, the GPU may have hung");
+        if (result != vk::Result::eSuccess)
+            throw std::runtime_error("failed to wait for queue timeline");
+        return blocked;
+    }
+
+    void QueueScheduler::waitIdle()
+    {
+        for (std::size_t i = 0; i < QUEUE_TYPE_COUNT; ++i)
+            wait(static_cast<QueueType>(i), m_queues[i].submitted);
+    }
+
+    std::uint64_t QueueScheduler::getCompletedValue(const QueueType queue) const
+    {
+        return m_device->getSemaphoreCounterValue(getTimeline(queue));
+    }
+}
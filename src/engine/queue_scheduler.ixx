@@ -0,0 +1,158 @@
+module;
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+export module queue_scheduler;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import gpu;
+
+namespace eng::sched {
+    /**
+     * The logical queues work is scheduled on. Compute and transfer map to the graphics queue on devices without
+     * dedicated families for them, in which case their work is serialized with rendering.
+     */
+    export enum class QueueType : std::uint8_t
+    {
+        Graphics,
+        Compute,
+        Transfer
+    };
+
+    export constexpr std::size_t QUEUE_TYPE_COUNT{ 3 };
+
+    /**
+     * How long the CPU waits for a queue before the GPU is assumed to have hung, far beyond any frame's duration
+     */
+    export constexpr std::chrono::nanoseconds DEFAULT_WAIT_TIMEOUT{ std::chrono::seconds{ 5 } };
+
+    /**
+     * A dependency of a submission on the completion of earlier work on another queue
+     */
+    export struct QueueWait
+    {
+        QueueType queue{ QueueType::Graphics };
+        std::uint64_t value{ 0 };   // The timeline value to wait for, nothing is waited on if zero
+        vk::PipelineStageFlags2 stages{ vk::PipelineStageFlagBits2::eAllCommands };     // The stages which wait
+    };
+
+    export struct WaitStatistics
+    {
+        std::uint64_t waits{ 0 };               // Calls to wait
+        std::uint64_t blocking_waits{ 0 };      // Waits whose value had not been reached yet, which blocked the CPU
+        std::chrono::nanoseconds blocked{ 0 };  // Total time the CPU spent blocked
+    };
+
+    /**
+     * Submits work to the graphics, compute and transfer queues, ordering it across queues with one timeline
+     * semaphore per queue. Every submission signals its queue's timeline with the next value, so a single integer
+     * identifies the completion of the submission and of everything submitted to the queue before it.
+     */
+    export class QueueScheduler
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Retrieves the queues and creates their timeline semaphores
+         * @param device the logical device, created with the queues of the GPU's families
+         * @param gpu the GPU the device was created from
+         */
+        QueueScheduler(vk::SharedDevice device, const GPU& gpu);
+
+        QueueScheduler(const QueueScheduler&) = delete;
+        QueueScheduler& operator=(const QueueScheduler&) = delete;
+
+        /* Submission Methods */
+
+        /**
+         * Submits command buffers to a queue
+         * @param queue the queue to submit to
+         * @param command_buffers the command buffers, executed in order
+         * @param queue_waits the work on other queues the submission waits for
+         * @param binary_waits additional binary semaphores to wait on, e.g., swapchain image acquisition
+         * @param binary_signals additional binary semaphores to signal, e.g., for presentation
+         * @return the timeline value signaled once the submission completes
+         */
+        std::uint64_t submit(QueueType queue,
+                             std::span<const vk::CommandBuffer> command_buffers,
+                             std::span<const QueueWait> queue_waits = {},
+                             std::span<const vk::SemaphoreSubmitInfo> binary_waits = {},
+                             std::span<const vk::SemaphoreSubmitInfo> binary_signals = {});
+
+        /**
+         * Blocks until a queue's timeline reaches a value, returning immediately if it already has
+         * @param queue the queue whose timeline is waited on
+         * @param value the timeline value, as returned by submit
+         * @param timeout how long to wait before giving up
+         * @return the time the CPU spent blocked
+         * @throws std::runtime_error if the timeout elapses first, as the GPU has likely hung
+         */
+        std::chrono::nanoseconds wait(QueueType queue,
+                                      std::uint64_t value,
+                                      std::chrono::nanoseconds timeout = DEFAULT_WAIT_TIMEOUT);
+
+        // Blocks until every submission to every queue has completed
+        void waitIdle();
+
+        /* Accessors */
+
+        [[nodiscard]] vk::Queue getQueue(const QueueType queue) const
+        { return m_queues[index(queue)].queue; }
+
+        [[nodiscard]] std::uint32_t getFamilyIndex(const QueueType queue) const
+        { return m_queues[index(queue)].family_index; }
+
+        // Returns true if the queue runs on its own family, so its work can overlap with rendering
+        [[nodiscard]] bool isDedicated(const QueueType queue) const
+        { return queue == QueueType::Graphics || getFamilyIndex(queue) != getFamilyIndex(QueueType::Graphics); }
+
+        [[nodiscard]] vk::Semaphore getTimeline(const QueueType queue) const
+        { return m_queues[index(queue)].timeline.get(); }
+
+        // Returns the value the queue's latest submission will signal
+        [[nodiscard]] std::uint64_t getSubmittedValue(const QueueType queue) const
+        { return m_queues[index(queue)].submitted; }
+
+        // Returns the value the queue's timeline has reached, every submission up to it has completed
+        [[nodiscard]] std::uint64_t getCompletedValue(QueueType queue) const;
+
+        [[nodiscard]] const WaitStatistics& getWaitStatistics() const
+        { return m_wait_statistics; }
+
+        void resetWaitStatistics()
+        { m_wait_statistics = { }; }
+
+    private:
+        /* Data Members */
+
+        struct ScheduledQueue
+        {
+            vk::Queue           queue;
+            std::uint32_t       family_index{ 0 };
+            vk::SharedSemaphore timeline;
+            std::uint64_t       submitted{ 0 };
+        };
+
+        vk::SharedDevice                                m_device;
+        std::array<ScheduledQueue, QUEUE_TYPE_COUNT>    m_queues;
+        WaitStatistics                                  m_wait_statistics;
+
+        // Scratch space for submit, kept to avoid per-submission allocations
+        std::vector<vk::SemaphoreSubmitInfo>            m_wait_scratch;
+        std::vector<vk::SemaphoreSubmitInfo>            m_signal_scratch;
+        std::vector<vk::CommandBufferSubmitInfo>        m_command_buffer_scratch;
+
+        /* Helper Methods */
+
+        [[nodiscard]] static std::size_t index(const QueueType queue)
+        { return static_cast<std::size_t>(queue); }
+    };
+}
@@ -0,0 +1,685 @@
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+module render_graph;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::graph {
+    namespace {
+        /**
+         * The synchronization implied by an access
+         */
+        struct AccessInfo
+        {
+            vk::PipelineStageFlags2 stages;
+            vk::AccessFlags2 access;
+            vk::ImageLayout layout;
+            vk::ImageUsageFlags usage;
+            bool writes;
+        };
+
+        constexpr vk::AccessFlags2 WRITE_ACCESS{
+            vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+            | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite
+        };
+
+        constexpr vk::PipelineStageFlags2 FRAGMENT_TESTS{
+            vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests
+        };
+
+        [[nodiscard]] AccessInfo describeAccess(const Access access)
+        {
+            using Stage = vk::PipelineStageFlagBits2;
+            using Flag = vk::AccessFlagBits2;
+            using Layout = vk::ImageLayout;
+            using Usage = vk::ImageUsageFlagBits;
+            switch (access) {
+                case Access::ColorAttachment:
+                    return { Stage::eColorAttachmentOutput, Flag::eColorAttachmentRead | Flag::eColorAttachmentWrite,
+                             Layout::eColorAttachmentOptimal, Usage::eColorAttachment, true };
+                case Access::DepthAttachment:
+                    return { FRAGMENT_TESTS, Flag::eDepthStencilAttachmentRead | Flag::eDepthStencilAttachmentWrite,
+                             Layout::eDepthStencilAttachmentOptimal, Usage::eDepthStencilAttachment, true };
+                case Access::DepthRead:
+                    return { FRAGMENT_TESTS, Flag::eDepthStencilAttachmentRead,
+                             Layout::eDepthStencilReadOnlyOptimal, Usage::eDepthStencilAttachment, false };
+                case Access::SampledRead:
+                    return { Stage::eFragmentShader, Flag::eShaderSampledRead,
+                             Layout::eShaderReadOnlyOptimal, Usage::eSampled, false };
+                case Access::StorageRead:
+                    return { Stage::eComputeShader, Flag::eShaderStorageRead, Layout::eGeneral, Usage::eStorage, false };
+                case Access::StorageWrite:
+                    return { Stage::eComputeShader, Flag::eShaderStorageWrite, Layout::eGeneral, Usage::eStorage, true };
+                case Access::StorageReadWrite:
+                    return { Stage::eComputeShader, Flag::eShaderStorageRead | Flag::eShaderStorageWrite,
+                             Layout::eGeneral, Usage::eStorage, true };
+                case Access::TransferRead:
+                    return { Stage::eAllTransfer, Flag::eTransferRead,
+                             Layout::eTransferSrcOptimal, Usage::eTransferSrc, false };
+                case Access::TransferWrite:
+                    return { Stage::eAllTransfer, Flag::eTransferWrite,
+                             Layout::eTransferDstOptimal, Usage::eTransferDst, true };
+                case Access::IndirectRead:
+                    return { Stage::eDrawIndirect, Flag::eIndirectCommandRead, Layout::eUndefined, {}, false };
+                case Access::VertexRead:
+                    return { Stage::eVertexAttributeInput, Flag::eVertexAttributeRead, Layout::eUndefined, {}, false };
+                case Access::IndexRead:
+                    return { Stage::eIndexInput, Flag::eIndexRead, Layout::eUndefined, {}, false };
+            }
+            throw std::invalid_argument("unknown render graph access");
+        }
+
+        // Attachments which are cleared are only written, so their previous contents are not depended upon
+        [[nodiscard]] AccessInfo describeAttachmentAccess(const Access access, const bool clears)
+        {
+            auto info{ describeAccess(access) };
+            if (clears && access == Access::ColorAttachment)
+                info.access = vk::AccessFlagBits2::eColorAttachmentWrite;
+            return info;
+        }
+
+        [[nodiscard]] vk::ImageAspectFlags getAspect(const vk::Format format)
+        {
+            switch (format) {
+                case vk::Format::eD16Unorm:
+                case vk::Format::eD32Sfloat:
+                case vk::Format::eX8D24UnormPack32:
+                    return vk::ImageAspectFlagBits::eDepth;
+                case vk::Format::eD16UnormS8Uint:
+                case vk::Format::eD24UnormS8Uint:
+                case vk::Format::eD32SfloatS8Uint:
+                    return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+                default:
+                    return vk::ImageAspectFlagBits::eColor;
+            }
+        }
+
+        /**
+         * The hazards outstanding on a resource as the passes are walked in execution order
+         */
+        struct Tracker
+        {
+            vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+            vk::PipelineStageFlags2 write_stages{ };    // Stages of the last write, or of the last layout transition
+            vk::AccessFlags2 write_access{ };
+            vk::PipelineStageFlags2 read_stages{ };     // Stages which have read since the last write
+            vk::PipelineStageFlags2 visible_stages{ };  // Stages and accesses the last write has been made visible to
+            vk::AccessFlags2 visible_access{ };
+        };
+
+        /**
+         * Advances a resource's tracker past an access
+         * @return the source and destination of the barrier the access requires, if any
+         */
+        [[nodiscard]] std::optional<std::pair<ResourceState, ResourceState>>
+        applyAccess(Tracker& tracker, const AccessInfo& info, const bool is_image)
+        {
+            const ResourceState dst{ info.stages, info.access, is_image ? info.layout : vk::ImageLayout::eUndefined };
+
+            // Writes must wait for every earlier access, and a layout transition is itself a write
+            if (info.writes || (is_image && tracker.layout != info.layout)) {
+                const auto wait_stages{ tracker.write_stages | tracker.read_stages };
+                const bool transitions{ is_image && tracker.layout != info.layout };
+                const ResourceState src{ wait_stages, tracker.write_access, tracker.layout };
+
+                tracker = Tracker{
+                    .layout = dst.layout,
+                    .write_stages = info.stages,
+                    .write_access = info.access & WRITE_ACCESS,
+                    .read_stages = info.writes ? vk::PipelineStageFlags2{ } : info.stages,
+                    .visible_stages = info.writes ? vk::PipelineStageFlags2{ } : info.stages,
+                    .visible_access = info.writes ? vk::AccessFlags2{ } : info.access
+                };
+                if (!wait_stages && !transitions)
+                    return std::nullopt;
+                return std::pair{ src, dst };
+            }
+
+            // Reads only wait on the last write, and only if it has not already been made visible to them
+            tracker.read_stages |= info.stages;
+            if (!tracker.write_stages
+                || ((info.stages & ~tracker.visible_stages) == vk::PipelineStageFlags2{ }
+                    && (info.access & ~tracker.visible_access) == vk::AccessFlags2{ }))
+                return std::nullopt;
+
+            const ResourceState src{ tracker.write_stages, tracker.write_access, tracker.layout };
+            tracker.visible_stages |= info.stages;
+            tracker.visible_access |= info.access;
+            return std::pair{ src, dst };
+        }
+
+        /**
+         * Calls the visitor for every image a pass accesses, including its attachments
+         */
+        template <typename Visitor>
+        void forEachImageAccess(const PassDesc& pass, Visitor&& visitor)
+        {
+            for (const auto& [ image, clear ] : pass.color_attachments)
+                visitor(image, describeAttachmentAccess(Access::ColorAttachment, clear.has_value()), true);
+            if (pass.depth_attachment) {
+                const auto& [ image, clear, read_only ]{ *pass.depth_attachment };
+                visitor(image, describeAttachmentAccess(read_only ? Access::DepthRead : Access::DepthAttachment,
+                                                        clear.has_value()), true);
+            }
+            for (const auto& [ image, access ] : pass.images)
+                visitor(image, describeAccess(access), false);
+        }
+
+        [[nodiscard]] bool hasAttachments(const PassDesc& pass)
+        { return !pass.color_attachments.empty() || pass.depth_attachment.has_value(); }
+
+        // Returns true if both passes render to the same attachments, so they may share a rendering scope
+        [[nodiscard]] bool sharesAttachments(const PassDesc& lhs, const PassDesc& rhs)
+        {
+            const auto same_image = [](const ImageHandle a, const ImageHandle b) { return a.index == b.index; };
+            const bool same_colors{ std::ranges::equal(lhs.color_attachments, rhs.color_attachments, same_image,
+                                                       &ColorAttachment::image, &ColorAttachment::image) };
+            const bool same_depth{ lhs.depth_attachment.has_value() == rhs.depth_attachment.has_value()
+                && (!lhs.depth_attachment || (lhs.depth_attachment->image.index == rhs.depth_attachment->image.index
+                                              && lhs.depth_attachment->read_only == rhs.depth_attachment->read_only)) };
+            return same_colors && same_depth && lhs.rendering_flags == rhs.rendering_flags;
+        }
+
+        [[nodiscard]] bool clearsAttachments(const PassDesc& pass)
+        {
+            return std::ranges::any_of(pass.color_attachments, [](const auto& attachment) { return attachment.clear.has_value(); })
+                || (pass.depth_attachment && pass.depth_attachment->clear.has_value());
+        }
+    }
+
+    /* Declaration Methods */
+
+    ImageHandle RenderGraph::importImage(std::string name, const ResourceState& initial, const ResourceState& final)
+    {
+        m_images.push_back({ std::move(name), std::nullopt, initial, final, {}, vk::ImageAspectFlagBits::eColor, {}, {}, {} });
+        m_compiled = false;
+        return { static_cast<std::uint32_t>(m_images.size() - 1) };
+    }
+
+    BufferHandle RenderGraph::importBuffer(std::string name, const vk::Buffer buffer)
+    {
+        m_buffers.push_back({ std::move(name), buffer });
+        m_compiled = false;
+        return { static_cast<std::uint32_t>(m_buffers.size() - 1) };
+    }
+
+    ImageHandle RenderGraph::createImage(std::string name, const TransientImageDesc& desc)
+    {
+        m_images.push_back({ std::move(name), desc, {}, {}, {}, getAspect(desc.format), {}, {}, desc.extent });
+        m_compiled = false;
+        return { static_cast<std::uint32_t>(m_images.size() - 1) };
+    }
+
+    void RenderGraph::addPass(PassDesc pass)
+    {
+        m_passes.push_back(std::move(pass));
+        m_compiled = false;
+    }
+
+    /* Compilation Methods */
+
+    void RenderGraph::compile(const vk::SharedDevice& device, mem::DeviceAllocator& allocator)
+    {
+        // Validate every reference up front, so the helpers may index freely
+        for (const auto& pass : m_passes) {
+            forEachImageAccess(pass, [&](const ImageHandle image, const AccessInfo&, bool) {
+                if (image.index >= m_images.size())
+                    throw std::logic_error(std::format("pass \"{}\" references an undeclared image", pass.name));
+            });
+            for (const auto& [ buffer, access ] : pass.buffers) {
+                if (buffer.index >= m_buffers.size())
+                    throw std::logic_error(std::format("pass \"{}\" references an undeclared buffer", pass.name));
+            }
+        }
+
+        m_steps.clear();
+        m_final_barriers.clear();
+        m_transient_views.clear();
+        m_transient_images.clear();
+        m_transient_memory.clear();
+        m_statistics = GraphStatistics{ .pass_count = static_cast<std::uint32_t>(m_passes.size()) };
+
+        const auto live_passes{ cullPasses() };
+        m_statistics.culled_passes = static_cast<std::uint32_t>(std::ranges::count(live_passes, false));
+        deriveImageUsage(live_passes);
+        const auto alias_predecessors{ allocateTransientImages(device, allocator, live_passes) };
+        schedulePasses(live_passes, alias_predecessors);
+        m_compiled = true;
+    }
+
+    std::vector<bool> RenderGraph::cullPasses() const
+    {
+        // Walk backwards from the outputs, imported resources and passes with side effects, keeping every pass
+        // which writes a resource a kept pass reads
+        std::vector<bool> needed_images(m_images.size(), false);
+        std::vector<bool> needed_buffers(m_buffers.size(), false);
+        for (std::size_t i = 0; i < m_images.size(); ++i)
+            needed_images[i] = !m_images[i].transient.has_value();
+        needed_buffers.assign(m_buffers.size(), true);
+
+        std::vector<bool> live_passes(m_passes.size(), false);
+        for (std::size_t i = m_passes.size(); i-- > 0;) {
+            const auto& pass{ m_passes[i] };
+            bool contributes{ pass.side_effects };
+            forEachImageAccess(pass, [&](const ImageHandle image, const AccessInfo& info, bool) {
+                contributes |= info.writes && needed_images[image.index];
+            });
+            for (const auto& [ buffer, access ] : pass.buffers)
+                contributes |= describeAccess(access).writes && needed_buffers[buffer.index];
+            if (!contributes)
+                continue;
+
+            live_passes[i] = true;
+            forEachImageAccess(pass, [&](const ImageHandle image, const AccessInfo& info, bool) {
+                if (info.access & ~WRITE_ACCESS)
+                    needed_images[image.index] = true;
+            });
+        }
+        return live_passes;
+    }
+
+    void RenderGraph::deriveImageUsage(const std::vector<bool>& live_passes)
+    {
+        for (auto& image : m_images)
+            image.usage = vk::ImageUsageFlags{ };
+        for (std::size_t i = 0; i < m_passes.size(); ++i) {
+            if (!live_passes[i])
+                continue;
+            forEachImageAccess(m_passes[i], [this](const ImageHandle image, const AccessInfo& info, bool) {
+                m_images[image.index].usage |= info.usage;
+            });
+        }
+    }
+
+    std::vector<std::uint32_t> RenderGraph::allocateTransientImages(const vk::SharedDevice& device,
+                                                                    mem::DeviceAllocator& allocator,
+                                                                    const std::vector<bool>& live_passes)
+    {
+        std::vector<std::uint32_t> predecessors(m_images.size());
+        std::iota(predecessors.begin(), predecessors.end(), 0u);
+
+        // Measure the lifetime of each transient image as the range of live passes which access it
+        constexpr auto UNUSED{ std::numeric_limits<std::uint32_t>::max() };
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> lifetimes(m_images.size(), { UNUSED, 0 });
+        for (std::uint32_t i = 0; i < m_passes.size(); ++i) {
+            if (!live_passes[i])
+                continue;
+            forEachImageAccess(m_passes[i], [&](const ImageHandle image, const AccessInfo&, bool) {
+                auto& [ first, last ]{ lifetimes[image.index] };
+                first = std::min(first, i);
+                last = std::max(last, i);
+            });
+        }
+
+        std::vector<std::uint32_t> transients;
+        for (std::uint32_t i = 0; i < m_images.size(); ++i) {
+            if (m_images[i].transient && lifetimes[i].first != UNUSED)
+                transients.push_back(i);
+        }
+        std::ranges::sort(transients, {}, [&lifetimes](const std::uint32_t image) { return lifetimes[image].first; });
+
+        // Create the images first, as their memory requirements are needed to decide what may share memory
+        struct Slot
+        {
+            vk::MemoryRequirements requirements;
+            std::uint32_t last_use;
+            std::vector<std::uint32_t> occupants;
+        };
+        std::vector<Slot> slots;
+        std::vector<std::size_t> slot_assignments;     // Indexed like transients
+        for (const auto image_index : transients) {
+            auto& image{ m_images[image_index] };
+            const auto& desc{ *image.transient };
+            const vk::SharedImage handle{ device->createImage(vk::ImageCreateInfo()
+                .setImageType( vk::ImageType::e2D )
+                .setFormat( desc.format )
+                .setExtent( vk::Extent3D{ desc.extent, 1 } )
+                .setMipLevels( 1 )
+                .setArrayLayers( 1 )
+                .setSamples( vk::SampleCountFlagBits::e1 )
+                .setTiling( vk::ImageTiling::eOptimal )
+                .setUsage( image.usage )
+                .setSharingMode( vk::SharingMode::eExclusive )
+                .setInitialLayout( vk::ImageLayout::eUndefined )), device };
+            const auto requirements{ device->getImageMemoryRequirements(handle.get()) };
+            dbg::setObjectName(device, handle.get(), image.name.c_str());
+            m_transient_images.push_back(handle);
+            image.image = handle.get();
+            m_statistics.aliased_bytes += requirements.size;
+
+            // Greedily reuse the first slot whose occupants are all dead and whose memory types are compatible
+            const auto [ first_use, last_use ]{ lifetimes[image_index] };
+            const auto slot_index{ static_cast<std::size_t>(std::ranges::find_if(slots, [&](const Slot& candidate) {
+                return candidate.last_use < first_use
+                    && (candidate.requirements.memoryTypeBits & requirements.memoryTypeBits) != 0;
+            }) - slots.begin()) };
+            if (slot_index == slots.size()) {
+                slots.push_back({ requirements, last_use, { image_index } });
+            } else {
+                auto& slot{ slots[slot_index] };
+                slot.requirements.size = std::max(slot.requirements.size, requirements.size);
+                slot.requirements.alignment = std::max(slot.requirements.alignment, requirements.alignment);
+                slot.requirements.memoryTypeBits &= requirements.memoryTypeBits;
+                slot.last_use = last_use;
+                slot.occupants.push_back(image_index);
+            }
+            slot_assignments.push_back(slot_index);
+        }
+
+        // Back each slot with one allocation, its occupants taking turns in order of first use, wrapping around
+        // to the next frame's first occupant
+        m_transient_memory.reserve(slots.size());
+        for (const auto& [ requirements, last_use, occupants ] : slots) {
+            m_transient_memory.emplace_back(allocator, allocator.allocate(requirements,
+                                                                          vk::MemoryPropertyFlagBits::eDeviceLocal,
+                                                                          mem::ResourceKind::Optimal));
+            m_statistics.transient_bytes += requirements.size;
+            for (std::size_t i = 0; i < occupants.size(); ++i)
+                predecessors[occupants[i]] = occupants[(i + occupants.size() - 1) % occupants.size()];
+        }
+        m_statistics.aliased_bytes -= m_statistics.transient_bytes;
+        m_statistics.transient_images = static_cast<std::uint32_t>(transients.size());
+
+        for (std::size_t i = 0; i < transients.size(); ++i) {
+            auto& image{ m_images[transients[i]] };
+            const auto& memory{ m_transient_memory[slot_assignments[i]].allocation };
+            device->bindImageMemory(image.image, memory.memory, memory.offset);
+
+            m_transient_views.emplace_back(device->createImageView(vk::ImageViewCreateInfo()
+                .setImage( image.image )
+                .setViewType( vk::ImageViewType::e2D )
+                .setFormat( image.transient->format )
+                .setSubresourceRange( vk::ImageSubresourceRange{ image.aspect, 0, 1, 0, 1 } )), device);
+            image.image_view = m_transient_views.back().get();
+            dbg::setObjectName(device, image.image_view, "{} view", image.name);
+        }
+        return predecessors;
+    }
+
+    void RenderGraph::schedulePasses(const std::vector<bool>& live_passes,
+                                     const std::vector<std::uint32_t>& alias_predecessors)
+    {
+        const auto walk = [&](std::vector<Tracker>& image_trackers,
+                              std::vector<Tracker>& buffer_trackers,
+                              const bool record) {
+            for (std::uint32_t i = 0; i < m_passes.size(); ++i) {
+                if (!live_passes[i])
+                    continue;
+                const auto& pass{ m_passes[i] };
+
+                // A pass may join the open step if it needs no barriers and, if it renders, continues the
+                // open rendering scope without clearing its attachments
+                const bool renders{ hasAttachments(pass) };
+                const bool continues_scope{
+                    record && !m_steps.empty() && m_steps.back().renders == renders
+                    && (!renders || (sharesAttachments(m_passes[m_steps.back().passes.front()], pass)
+                                     && !clearsAttachments(pass)))
+                };
+
+                // Attachment accesses within a rendering scope are ordered by the rasterization order, so they only
+                // need barriers when the pass begins a new scope
+                const auto plan = [&](const bool in_scope) {
+                    Step step{ .renders = renders };
+                    auto next_images{ image_trackers };
+                    auto next_buffers{ buffer_trackers };
+                    forEachImageAccess(pass, [&](const ImageHandle image, const AccessInfo& info, const bool is_attachment) {
+                        if (in_scope && is_attachment)
+                            return;
+                        if (const auto barrier{ applyAccess(next_images[image.index], info, true) })
+                            step.image_barriers.push_back({ image.index, barrier->first, barrier->second });
+                    });
+                    for (const auto& [ buffer, access ] : pass.buffers) {
+                        if (const auto barrier{ applyAccess(next_buffers[buffer.index], describeAccess(access), false) })
+                            step.buffer_barriers.push_back({ buffer.index, barrier->first, barrier->second });
+                    }
+                    return std::tuple{ std::move(step), std::move(next_images), std::move(next_buffers) };
+                };
+
+                auto [ step, next_images, next_buffers ]{ plan(continues_scope) };
+                const bool merges{ continues_scope && step.image_barriers.empty() && step.buffer_barriers.empty() };
+                if (continues_scope && !merges)
+                    std::tie(step, next_images, next_buffers) = plan(false);
+                image_trackers = std::move(next_images);
+                buffer_trackers = std::move(next_buffers);
+                if (!record)
+                    continue;
+
+                if (merges) {
+                    m_steps.back().passes.push_back(i);
+                } else {
+                    step.passes.push_back(i);
+                    m_steps.push_back(std::move(step));
+                }
+            }
+        };
+
+        // Walk the frame once to find the state each resource is left in, which the next frame's first access
+        // to it, or to the transient image next occupying its memory, must wait on
+        std::vector<Tracker> image_trackers(m_images.size());
+        std::vector<Tracker> buffer_trackers(m_buffers.size());
+        walk(image_trackers, buffer_trackers, false);
+
+        std::vector<Tracker> initial_images(m_images.size());
+        for (std::size_t i = 0; i < m_images.size(); ++i) {
+            const auto& image{ m_images[i] };
+            if (image.transient) {
+                // Transient contents are discarded at first use, but the memory's previous occupant must be done
+                const auto& previous{ image_trackers[alias_predecessors[i]] };
+                initial_images[i] = Tracker{
+                    .layout = vk::ImageLayout::eUndefined,
+                    .write_stages = previous.write_stages | previous.read_stages,
+                    .write_access = previous.write_access
+                };
+            } else {
+                initial_images[i] = Tracker{
+                    .layout = image.initial.layout,
+                    .write_stages = image.initial.stages,
+                    .write_access = image.initial.access & WRITE_ACCESS
+                };
+            }
+        }
+        auto initial_buffers{ buffer_trackers };
+
+        // Walk the frame again from those states, grouping the passes and recording their barriers
+        walk(initial_images, initial_buffers, true);
+
+        // Leave imported images in their final state
+        for (std::uint32_t i = 0; i < m_images.size(); ++i) {
+            const auto& image{ m_images[i] };
+            if (image.transient)
+                continue;
+            const auto& tracker{ initial_images[i] };
+            const auto& final{ image.final };
+            if (tracker.layout != final.layout || tracker.write_access) {
+                m_final_barriers.push_back({
+                    i,
+                    { tracker.write_stages | tracker.read_stages, tracker.write_access, tracker.layout },
+                    final
+                });
+            }
+        }
+
+        // Decide which attachments are stored, transient attachments no later pass reads are discarded
+        for (std::size_t s = 0; s < m_steps.size(); ++s) {
+            auto& step{ m_steps[s] };
+            if (!step.renders)
+                continue;
+            ++m_statistics.rendering_scopes;
+
+            const auto is_read_later = [&](const ImageHandle handle) {
+                if (!m_images[handle.index].transient)
+                    return true;
+                for (std::size_t later = s + 1; later < m_steps.size(); ++later) {
+                    for (const auto pass : m_steps[later].passes) {
+                        bool reads{ false };
+                        forEachImageAccess(m_passes[pass], [&](const ImageHandle image, const AccessInfo& info, bool) {
+                            reads |= image.index == handle.index && (info.access & ~WRITE_ACCESS);
+                        });
+                        if (reads)
+                            return true;
+                    }
+                }
+                return false;
+            };
+            const auto& pass{ m_passes[step.passes.front()] };
+            for (const auto& attachment : pass.color_attachments)
+                step.color_store_ops.push_back(is_read_later(attachment.image) ? vk::AttachmentStoreOp::eStore
+                                                                               : vk::AttachmentStoreOp::eDontCare);
+            if (pass.depth_attachment)
+                step.depth_store_op = is_read_later(pass.depth_attachment->image) ? vk::AttachmentStoreOp::eStore
+                                                                                  : vk::AttachmentStoreOp::eDontCare;
+        }
+
+        for (const auto& step : m_steps)
+            m_statistics.barriers += static_cast<std::uint32_t>(step.image_barriers.size() + step.buffer_barriers.size());
+        m_statistics.barriers += static_cast<std::uint32_t>(m_final_barriers.size());
+    }
+
+    /* Execution Methods */
+
+    void RenderGraph::bindImage(const ImageHandle handle,
+                                const vk::Image image,
+                                const vk::ImageView image_view,
+                                const vk::Extent2D& extent)
+    {
+        auto& resource{ m_images.at(handle.index) };
+        if (resource.transient)
+            throw std::logic_error(std::format("cannot bind transient image \"{}\"", resource.name));
+        resource.image = image;
+        resource.image_view = image_view;
+        resource.extent = extent;
+    }
+
+    void RenderGraph::bindBuffer(const BufferHandle handle, const vk::Buffer buffer)
+    {
+        m_buffers.at(handle.index).buffer = buffer;
+    }
+
+    void RenderGraph::execute(const vk::CommandBuffer& command_buffer)
+    {
+        if (!m_compiled)
+            throw std::logic_error("render graph must be compiled before execution");
+
+        for (const auto& step : m_steps) {
+            recordBarriers(command_buffer, step.image_barriers, step.buffer_barriers);
+            if (step.renders)
+                beginRendering(command_buffer, step);
+            for (const auto pass : step.passes) {
+                if (m_passes[pass].record) {
+                    const dbg::ScopedLabel label{ command_buffer, m_passes[pass].name.c_str() };
+                    m_passes[pass].record(command_buffer);
+                }
+            }
+            if (step.renders)
+                command_buffer.endRendering();
+        }
+        recordBarriers(command_buffer, m_final_barriers, {});
+    }
+
+    vk::ImageView RenderGraph::getImageView(const ImageHandle handle) const
+    {
+        return m_images.at(handle.index).image_view;
+    }
+
+    vk::Image RenderGraph::getImage(const ImageHandle handle) const
+    {
+        return m_images.at(handle.index).image;
+    }
+
+    void RenderGraph::recordBarriers(const vk::CommandBuffer& command_buffer,
+                                     const std::span<const ImageBarrier> image_barriers,
+                                     const std::span<const BufferBarrier> buffer_barriers)
+    {
+        if (image_barriers.empty() && buffer_barriers.empty())
+            return;
+
+        m_image_barrier_scratch.clear();
+        for (const auto& [ index, src, dst ] : image_barriers) {
+            const auto& image{ m_images[index] };
+            m_image_barrier_scratch.push_back(vk::ImageMemoryBarrier2()
+                .setSrcStageMask( src.stages )
+                .setSrcAccessMask( src.access )
+                .setDstStageMask( dst.stages )
+                .setDstAccessMask( dst.access )
+                .setOldLayout( src.layout )
+                .setNewLayout( dst.layout )
+                .setImage( image.image )
+                .setSubresourceRange( vk::ImageSubresourceRange()
+                    .setAspectMask( image.aspect )
+                    .setBaseMipLevel( 0 )
+                    .setLevelCount( vk::RemainingMipLevels )
+                    .setBaseArrayLayer( 0 )
+                    .setLayerCount( vk::RemainingArrayLayers ) ));
+        }
+
+        m_buffer_barrier_scratch.clear();
+        for (const auto& [ index, src, dst ] : buffer_barriers) {
+            m_buffer_barrier_scratch.push_back(vk::BufferMemoryBarrier2()
+                .setSrcStageMask( src.stages )
+                .setSrcAccessMask( src.access )
+                .setDstStageMask( dst.stages )
+                .setDstAccessMask( dst.access )
+                .setBuffer( m_buffers[index].buffer )
+                .setOffset( 0 )
+                .setSize( vk::WholeSize ));
+        }
+
+        command_buffer.pipelineBarrier2(vk::DependencyInfo()
+            .setImageMemoryBarriers( m_image_barrier_scratch )
+            .setBufferMemoryBarriers( m_buffer_barrier_scratch ));
+    }
+
+    void RenderGraph::beginRendering(const vk::CommandBuffer& command_buffer, const Step& step)
+    {
+        const auto& pass{ m_passes[step.passes.front()] };
+
+        m_attachment_scratch.clear();
+        for (std::size_t i = 0; i < pass.color_attachments.size(); ++i) {
+            const auto& [ image, clear ]{ pass.color_attachments[i] };
+            m_attachment_scratch.push_back(vk::RenderingAttachmentInfo()
+                .setImageView( m_images[image.index].image_view )
+                .setImageLayout( vk::ImageLayout::eColorAttachmentOptimal )
+                .setLoadOp( clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad )
+                .setStoreOp( step.color_store_ops[i] )
+                .setClearValue( clear.value_or(vk::ClearColorValue{ }) ));
+        }
+
+        vk::RenderingAttachmentInfo depth_attachment;
+        if (pass.depth_attachment) {
+            const auto& [ image, clear, read_only ]{ *pass.depth_attachment };
+            depth_attachment
+                .setImageView( m_images[image.index].image_view )
+                .setImageLayout( read_only ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                                           : vk::ImageLayout::eDepthStencilAttachmentOptimal )
+                .setLoadOp( clear ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad )
+                .setStoreOp( step.depth_store_op )
+                .setClearValue( vk::ClearDepthStencilValue{ clear.value_or(1.0f), 0 } );
+        }
+
+        // The render area covers the first attachment
+        const auto& first_image{ pass.color_attachments.empty() ? pass.depth_attachment->image
+                                                                : pass.color_attachments.front().image };
+        auto rendering_info = vk::RenderingInfo()
+            .setFlags( pass.rendering_flags )
+            .setRenderArea( vk::Rect2D{ {0, 0}, m_images[first_image.index].extent } )
+            .setLayerCount( 1 )
+            .setColorAttachments( m_attachment_scratch );
+        if (pass.depth_attachment)
+            rendering_info.setPDepthAttachment( &depth_attachment );
+        command_buffer.beginRendering(rendering_info);
+    }
+}
@@ -0,0 +1,369 @@
+module;
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+export module render_graph;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+
+namespace eng::graph {
+    /**
+     * The ways a pass may access a resource, each implying the pipeline stages, access flags, image layout and
+     * usage flags of the access
+     */
+    export enum class Access : std::uint8_t
+    {
+        ColorAttachment,        // Written as a color attachment, and read first unless the pass clears it
+        DepthAttachment,        // Depth tested and written
+        DepthRead,              // Depth tested without writing, or sampled while bound read-only
+        SampledRead,            // Sampled in a fragment shader
+        StorageRead,            // Read as a storage image or buffer in a compute shader
+        StorageWrite,           // Written as a storage image or buffer in a compute shader
+        StorageReadWrite,       // Read and written, e.g., atomically, in a compute shader
+        TransferRead,           // Source of a copy or blit
+        TransferWrite,          // Destination of a copy, blit, fill or clear
+        IndirectRead,           // Indirect draw or dispatch parameters
+        VertexRead,             // Vertex or per-instance attributes
+        IndexRead               // Index buffer
+    };
+
+    /**
+     * The synchronization state a resource is in at a point in the frame
+     */
+    export struct ResourceState
+    {
+        vk::PipelineStageFlags2 stages{ vk::PipelineStageFlagBits2::eNone };
+        vk::AccessFlags2 access{ vk::AccessFlagBits2::eNone };
+        vk::ImageLayout layout{ vk::ImageLayout::eUndefined };     // Ignored for buffers
+    };
+
+    export struct ImageHandle
+    {
+        std::uint32_t index{ std::numeric_limits<std::uint32_t>::max() };
+
+        [[nodiscard]] bool isValid() const
+        { return index != std::numeric_limits<std::uint32_t>::max(); }
+    };
+
+    export struct BufferHandle
+    {
+        std::uint32_t index{ std::numeric_limits<std::uint32_t>::max() };
+
+        [[nodiscard]] bool isValid() const
+        { return index != std::numeric_limits<std::uint32_t>::max(); }
+    };
+
+    /**
+     * An image owned by the graph which only lives within a frame, its memory may be shared with other transient
+     * images whose lifetimes do not overlap. Its usage flags are derived from the passes which access it.
+     */
+    export struct TransientImageDesc
+    {
+        vk::Format format{ vk::Format::eUndefined };
+        vk::Extent2D extent;
+    };
+
+    export struct ColorAttachment
+    {
+        ImageHandle image;
+        std::optional<vk::ClearColorValue> clear;   // The previous contents are loaded if empty
+    };
+
+    export struct DepthAttachment
+    {
+        ImageHandle image;
+        std::optional<float> clear;     // The previous contents are loaded if empty
+        bool read_only{ false };
+    };
+
+    export struct ImageUse
+    {
+        ImageHandle image;
+        Access access;
+    };
+
+    export struct BufferUse
+    {
+        BufferHandle buffer;
+        Access access;
+    };
+
+    /**
+     * Declares a pass: the resources it accesses and the function recording its commands. A pass with attachments
+     * is recorded inside a dynamic rendering scope begun by the graph.
+     */
+    export struct PassDesc
+    {
+        std::string name;
+        std::vector<ColorAttachment> color_attachments;
+        std::optional<DepthAttachment> depth_attachment;
+        std::vector<ImageUse> images;       // Accesses to images other than the attachments
+        std::vector<BufferUse> buffers;
+        vk::RenderingFlags rendering_flags{ };
+        bool side_effects{ false };         // Never culled, even if nothing reads what it writes
+        std::function<void(const vk::CommandBuffer&)> record;
+    };
+
+    export struct GraphStatistics
+    {
+        std::uint32_t pass_count{ 0 };
+        std::uint32_t culled_passes{ 0 };       // Passes whose results were never read
+        std::uint32_t rendering_scopes{ 0 };    // Fewer than the graphics passes when passes were merged
+        std::uint32_t barriers{ 0 };            // Image and buffer barriers recorded per frame
+        std::uint32_t transient_images{ 0 };
+        vk::DeviceSize transient_bytes{ 0 };    // Memory backing the transient images, after aliasing
+        vk::DeviceSize aliased_bytes{ 0 };      // Memory saved by aliasing
+    };
+
+    /**
+     * A frame's passes and the resources flowing between them. Once compiled, the graph culls passes which
+     * contribute nothing to its outputs, merges consecutive passes rendering to the same attachments into one
+     * rendering scope, places the minimal synchronization2 barriers between the remaining passes, and aliases
+     * the memory of transient images whose lifetimes do not overlap. The graph assumes it is executed once per
+     * frame on a single queue, so each resource's first access in a frame is synchronized against its last
+     * access in the previous frame.
+     */
+    export class RenderGraph
+    {
+    public:
+        /* Constructors */
+
+        RenderGraph() = default;
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        RenderGraph(RenderGraph&&) noexcept = default;
+        RenderGraph& operator=(RenderGraph&&) noexcept = default;
+
+        /* Declaration Methods */
+
+        /**
+         * Declares an image owned outside of the graph, bound before each execution with bindImage
+         * @param name the name of the image, for diagnostics
+         * @param initial the state the image is in when the graph begins, e.g., undefined for a freshly acquired
+         *                swapchain image
+         * @param final the state the image is left in once the graph completes, e.g., ready for presentation
+         * @return the handle of the image
+         */
+        ImageHandle importImage(std::string name, const ResourceState& initial, const ResourceState& final);
+
+        /**
+         * Declares a buffer owned outside of the graph, its accesses are synchronized against the previous
+         * frame's execution of the graph
+         * @param name the name of the buffer, for diagnostics
+         * @param buffer the buffer, may be replaced before each execution with bindBuffer
+         * @return the handle of the buffer
+         */
+        BufferHandle importBuffer(std::string name, vk::Buffer buffer = {});
+
+        /**
+         * Declares an image created, and aliased, by the graph
+         * @param name the name of the image, for diagnostics
+         * @param desc the format and extent of the image
+         * @return the handle of the image
+         */
+        ImageHandle createImage(std::string name, const TransientImageDesc& desc);
+
+        void addPass(PassDesc pass);
+
+        /* Compilation Methods */
+
+        /**
+         * Culls, merges and schedules the declared passes, then creates the transient images
+         * @param device the logical device which will own the transient images
+         * @param allocator the allocator the transient images' memory is sub-allocated from, must outlive the graph
+         * @throws std::logic_error if a pass references an undeclared resource
+         */
+        void compile(const vk::SharedDevice& device, mem::DeviceAllocator& allocator);
+
+        /* Execution Methods */
+
+        /**
+         * Binds an imported image for the next executions
+         * @param handle the handle returned by importImage
+         * @param image the image
+         * @param image_view a view of the image, used when it is bound as an attachment
+         * @param extent the extent of the image
+         */
+        void bindImage(ImageHandle handle, vk::Image image, vk::ImageView image_view, const vk::Extent2D& extent);
+
+        /**
+         * Binds an imported buffer for the next executions, e.g., one of several buffers cycled per frame slot.
+         * Each buffer bound to a handle is assumed to be accessed the same way by every execution.
+         * @param handle the handle returned by importBuffer
+         * @param buffer the buffer
+         */
+        void bindBuffer(BufferHandle handle, vk::Buffer buffer);
+
+        /**
+         * Records the compiled passes and their barriers, every imported image and buffer must be bound
+         * @param command_buffer the command buffer to record into, must be in the recording state
+         */
+        void execute(const vk::CommandBuffer& command_buffer);
+
+        /* Accessors */
+
+        [[nodiscard]] bool isCompiled() const
+        { return m_compiled; }
+
+        // Returns the view of an image, valid for transient images once compiled and for imported images once bound
+        [[nodiscard]] vk::ImageView getImageView(ImageHandle handle) const;
+
+        // Returns an image, valid for transient images once compiled and for imported images once bound
+        [[nodiscard]] vk::Image getImage(ImageHandle handle) const;
+
+        [[nodiscard]] const GraphStatistics& getStatistics() const
+        { return m_statistics; }
+
+    private:
+        /* Resource Types */
+
+        struct ImageResource
+        {
+            std::string name;
+            std::optional<TransientImageDesc> transient;    // Empty for imported images
+            ResourceState initial;
+            ResourceState final;
+            vk::ImageUsageFlags usage;
+            vk::ImageAspectFlags aspect{ vk::ImageAspectFlagBits::eColor };
+
+            vk::Image image;
+            vk::ImageView image_view;
+            vk::Extent2D extent;
+        };
+
+        struct BufferResource
+        {
+            std::string name;
+            vk::Buffer buffer;
+        };
+
+        // A sub-allocation shared by aliased transient images, returned to the allocator on destruction
+        struct AliasedMemory
+        {
+            mem::DeviceAllocator* allocator{ nullptr };
+            mem::Allocation allocation;
+
+            AliasedMemory(mem::DeviceAllocator& owner, const mem::Allocation& memory)
+                : allocator{ &owner },
+                  allocation{ memory }
+            {}
+
+            AliasedMemory(const AliasedMemory&) = delete;
+            AliasedMemory& operator=(const AliasedMemory&) = delete;
+
+            AliasedMemory(AliasedMemory&& other) noexcept
+                : allocator{ std::exchange(other.allocator, nullptr) },
+                  allocation{ std::exchange(other.allocation, {}) }
+            {}
+
+            AliasedMemory& operator=(AliasedMemory&& other) noexcept
+            {
+                if (this != &other) {
+                    if (allocator)
+                        allocator->free(allocation);
+                    allocator = std::exchange(other.allocator, nullptr);
+                    allocation = std::exchange(other.allocation, {});
+                }
+                return *this;
+            }
+
+            ~AliasedMemory()
+            {
+                if (allocator)
+                    allocator->free(allocation);
+            }
+        };
+
+        /* Compiled Types */
+
+        struct ImageBarrier
+        {
+            std::uint32_t image;
+            ResourceState src;
+            ResourceState dst;
+        };
+
+        struct BufferBarrier
+        {
+            std::uint32_t buffer;
+            ResourceState src;
+            ResourceState dst;
+        };
+
+        // A batch of barriers followed by one or more passes, sharing a rendering scope if they have attachments
+        struct Step
+        {
+            std::vector<ImageBarrier> image_barriers;
+            std::vector<BufferBarrier> buffer_barriers;
+            std::vector<std::uint32_t> passes;
+            bool renders{ false };
+
+            // Attachments whose contents no later pass reads are discarded once the rendering scope ends
+            std::vector<vk::AttachmentStoreOp> color_store_ops;
+            vk::AttachmentStoreOp depth_store_op{ vk::AttachmentStoreOp::eStore };
+        };
+
+        /* Data Members */
+
+        std::vector<ImageResource>  m_images;
+        std::vector<BufferResource> m_buffers;
+        std::vector<PassDesc>       m_passes;
+
+        std::vector<Step>           m_steps;
+        std::vector<ImageBarrier>   m_final_barriers;
+        GraphStatistics             m_statistics;
+        bool                        m_compiled{ false };
+
+        // Declared last, so the transient images are destroyed before their memory is returned
+        std::vector<AliasedMemory>          m_transient_memory;
+        std::vector<vk::SharedImage>        m_transient_images;
+        std::vector<vk::SharedImageView>    m_transient_views;
+
+        // Scratch space for execute, kept to avoid per-frame allocations
+        std::vector<vk::ImageMemoryBarrier2>        m_image_barrier_scratch;
+        std::vector<vk::BufferMemoryBarrier2>       m_buffer_barrier_scratch;
+        std::vector<vk::RenderingAttachmentInfo>    m_attachment_scratch;
+
+        /* Compilation Helper Methods */
+
+        // Returns, for each pass, whether it contributes to an output of the graph
+        [[nodiscard]] std::vector<bool> cullPasses() const;
+
+        // Derives the usage flags of each image from its accesses
+        void deriveImageUsage(const std::vector<bool>& live_passes);
+
+        /**
+         * Creates the transient images, sharing memory between images whose lifetimes do not overlap
+         * @return for each image, the transient image which last occupied its memory, its own index if the
+         *         image is imported or its memory is not shared
+         */
+        [[nodiscard]] std::vector<std::uint32_t> allocateTransientImages(const vk::SharedDevice& device,
+                                                                         mem::DeviceAllocator& allocator,
+                                                                         const std::vector<bool>& live_passes);
+
+        // Groups the live passes into steps and places the barriers between them
+        void schedulePasses(const std::vector<bool>& live_passes, const std::vector<std::uint32_t>& alias_predecessors);
+
+        /* Execution Helper Methods */
+
+        void recordBarriers(const vk::CommandBuffer& command_buffer,
+                            std::span<const ImageBarrier> image_barriers,
+                            std::span<const BufferBarrier> buffer_barriers);
+
+        // Begins the rendering scope of a step, using the attachments of its first pass
+        void beginRendering(const vk::CommandBuffer& command_buffer, const Step& step);
+    };
+}
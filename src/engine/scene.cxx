@@ -0,0 +1,318 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <future>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+module scene;
+
+namespace eng::scene {
+    namespace {
+        /**
+         * The operations of the culling kernel on one object at a time
+         */
+        struct ScalarOps
+        {
+            using Float = float;
+            using Mask = bool;
+            static constexpr std::uint32_t WIDTH{ 1 };
+
+            static Float load(const float* values) { return *values; }
+            static Float broadcast(const float value) { return value; }
+            static Float add(const Float a, const Float b) { return a + b; }
+            static Float sub(const Float a, const Float b) { return a - b; }
+            static Float mul(const Float a, const Float b) { return a * b; }
+            static Mask greaterEqual(const Float a, const Float b) { return a >= b; }
+            static Mask lessEqual(const Float a, const Float b) { return a <= b; }
+            static Mask both(const Mask a, const Mask b) { return a && b; }
+            static std::uint32_t toBits(const Mask mask) { return mask ? 1u : 0u; }
+        };
+
+        /**
+         * The operations of the culling kernel on a vector of objects, the lanes of a mask are all ones if set
+         */
+#if defined(__AVX2__)
+        struct SimdOps
+        {
+            using Float = __m256;
+            using Mask = __m256;
+            static constexpr std::uint32_t WIDTH{ 8 };
+
+            static Float load(const float* values) { return _mm256_load_ps(values); }
+            static Float broadcast(const float value) { return _mm256_set1_ps(value); }
+            static Float add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+            static Float sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+            static Float mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+            static Mask greaterEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static Mask lessEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+            static Mask both(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+            static std::uint32_t toBits(const Mask mask) { return static_cast<std::uint32_t>(_mm256_movemask_ps(mask)); }
+        };
+#elif defined(__SSE__) || defined(_M_X64)
+        struct SimdOps
+        {
+            using Float = __m128;
+            using Mask = __m128;
+            static constexpr std::uint32_t WIDTH{ 4 };
+
+            static Float load(const float* values) { return _mm_load_ps(values); }
+            static Float broadcast(const float value) { return _mm_set1_ps(value); }
+            static Float add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+            static Float sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+            static Float mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+            static Mask greaterEqual(const Float a, const Float b) { return _mm_cmpge_ps(a, b); }
+            static Mask lessEqual(const Float a, const Float b) { return _mm_cmple_ps(a, b); }
+            static Mask both(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+            static std::uint32_t toBits(const Mask mask) { return static_cast<std::uint32_t>(_mm_movemask_ps(mask)); }
+        };
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        struct SimdOps
+        {
+            using Float = float32x4_t;
+            using Mask = uint32x4_t;
+            static constexpr std::uint32_t WIDTH{ 4 };
+
+            static Float load(const float* values) { return vld1q_f32(values); }
+            static Float broadcast(const float value) { return vdupq_n_f32(value); }
+            static Float add(const Float a, const Float b) { return vaddq_f32(a, b); }
+            static Float sub(const Float a, const Float b) { return vsubq_f32(a, b); }
+            static Float mul(const Float a, const Float b) { return vmulq_f32(a, b); }
+            static Mask greaterEqual(const Float a, const Float b) { return vcgeq_f32(a, b); }
+            static Mask lessEqual(const Float a, const Float b) { return vcleq_f32(a, b); }
+            static Mask both(const Mask a, const Mask b) { return vandq_u32(a, b); }
+
+            // NEON has no movemask, so each lane keeps its own bit and the lanes are summed
+            static std::uint32_t toBits(const Mask mask)
+            {
+                constexpr std::array<std::uint32_t, 4> lane_bits{ 1, 2, 4, 8 };
+                return vaddvq_u32(vandq_u32(mask, vld1q_u32(lane_bits.data())));
+            }
+        };
+#else
+        using SimdOps = ScalarOps;
+#endif
+        static_assert(SimdOps::WIDTH == SIMD_WIDTH);
+
+        /**
+         * Tests each vector of objects against every plane and the maximum distance, then appends the indices of the
+         * survivors. Every lane's index is written, but the count only advances past visible ones, so compaction has
+         * no branches to mispredict. A write never passes the range's own slice, since the count never exceeds the
+         * number of objects already tested.
+         */
+        template <typename Ops>
+        std::uint32_t cullObjects(const Scene& scene,
+                                  const CullingParams& params,
+                                  const std::uint32_t first,
+                                  const std::uint32_t last,
+                                  std::uint32_t* visible)
+        {
+            using Float = typename Ops::Float;
+
+            // Broadcast the planes and the camera once, rather than once per vector
+            struct Plane
+            {
+                Float x, y, z, w;
+            };
+            std::array<Plane, 6> planes;
+            for (std::size_t i = 0; i < planes.size(); ++i) {
+                planes[i] = {
+                    Ops::broadcast(params.frustum[i].x),
+                    Ops::broadcast(params.frustum[i].y),
+                    Ops::broadcast(params.frustum[i].z),
+                    Ops::broadcast(params.frustum[i].w)
+                };
+            }
+            const Float camera_x{ Ops::broadcast(params.camera_position.x) };
+            const Float camera_y{ Ops::broadcast(params.camera_position.y) };
+            const Float camera_z{ Ops::broadcast(params.camera_position.z) };
+            const Float max_distance{ Ops::broadcast(params.max_distance) };
+            const Float zero{ Ops::broadcast(0.0f) };
+
+            const float* center_x{ scene.getCenterX().data() };
+            const float* center_y{ scene.getCenterY().data() };
+            const float* center_z{ scene.getCenterZ().data() };
+            const float* radius{ scene.getRadius().data() };
+
+            std::uint32_t count{ 0 };
+            for (std::uint32_t object = first; object < last; object += Ops::WIDTH) {
+                const Float x{ Ops::load(center_x + object) };
+                const Float y{ Ops::load(center_y + object) };
+                const Float z{ Ops::load(center_z + object) };
+                const Float r{ Ops::load(radius + object) };
+
+                // Within reach if the squared distance to the center is at most (max_distance + radius)^2
+                const Float dx{ Ops::sub(x, camera_x) };
+                const Float dy{ Ops::sub(y, camera_y) };
+                const Float dz{ Ops::sub(z, camera_z) };
+                const Float reach{ Ops::add(max_distance, r) };
+                auto inside{ Ops::lessEqual(Ops::add(Ops::add(Ops::mul(dx, dx), Ops::mul(dy, dy)), Ops::mul(dz, dz)),
+                                            Ops::mul(reach, reach)) };
+
+                // Inside a plane if the signed distance to the center is at least -radius
+                const Float negative_r{ Ops::sub(zero, r) };
+                for (const auto& plane : planes) {
+                    const Float distance{ Ops::add(Ops::add(Ops::add(Ops::mul(plane.x, x), Ops::mul(plane.y, y)),
+                                                            Ops::mul(plane.z, z)),
+                                                   plane.w) };
+                    inside = Ops::both(inside, Ops::greaterEqual(distance, negative_r));
+                }
+
+                const auto bits{ Ops::toBits(inside) };
+                for (std::uint32_t lane = 0; lane < Ops::WIDTH; ++lane) {
+                    visible[count] = object + lane;
+                    count += (bits >> lane) & 1u;
+                }
+            }
+            return count;
+        }
+
+        // Runs the selected kernel over a range of whole cache lines within the padded count
+        std::uint32_t runKernel(const Scene& scene,
+                                const CullingParams& params,
+                                const std::uint32_t first,
+                                const std::uint32_t last,
+                                std::uint32_t* visible,
+                                const CullingKernel kernel)
+        {
+            return kernel == CullingKernel::Simd ? cullObjects<SimdOps>(scene, params, first, last, visible)
+                                                 : cullObjects<ScalarOps>(scene, params, first, last, visible);
+        }
+
+        [[nodiscard]] constexpr std::uint32_t roundUpToCacheLine(const std::uint32_t count)
+        { return (count + OBJECTS_PER_CACHE_LINE - 1) / OBJECTS_PER_CACHE_LINE * OBJECTS_PER_CACHE_LINE; }
+    }
+
+    Scene::Scene(const std::span<const cull::ObjectData> objects)
+        : m_object_count{ static_cast<std::uint32_t>(objects.size()) }
+    {
+        // The padding sits at the origin with a radius no signed distance reaches
+        const auto padded_count{ roundUpToCacheLine(m_object_count) };
+        m_center_x.resize(padded_count, 0.0f);
+        m_center_y.resize(padded_count, 0.0f);
+        m_center_z.resize(padded_count, 0.0f);
+        m_radius.resize(padded_count, -std::numeric_limits<float>::infinity());
+        m_offset_x.resize(padded_count, 0.0f);
+        m_offset_y.resize(padded_count, 0.0f);
+        m_scale.resize(padded_count, 0.0f);
+
+        for (std::uint32_t i = 0; i < m_object_count; ++i) {
+            const auto& [ bounds, transform ]{ objects[i] };
+            m_center_x[i] = bounds.x;
+            m_center_y[i] = bounds.y;
+            m_center_z[i] = bounds.z;
+            m_radius[i] = bounds.w;
+            m_offset_x[i] = transform.x;
+            m_offset_y[i] = transform.y;
+            m_scale[i] = transform.z;
+        }
+    }
+
+    std::vector<cull::ObjectData> Scene::getObjectData() const
+    {
+        std::vector<cull::ObjectData> objects;
+        objects.reserve(m_object_count);
+        for (std::uint32_t i = 0; i < m_object_count; ++i) {
+            objects.push_back({
+                glm::vec4{ m_center_x[i], m_center_y[i], m_center_z[i], m_radius[i] },
+                getTransform(i)
+            });
+        }
+        return objects;
+    }
+
+    std::uint32_t cullRange(const Scene& scene,
+                            const CullingParams& params,
+                            const std::uint32_t first,
+                            const std::uint32_t last,
+                            const std::span<std::uint32_t> visible,
+                            const CullingKernel kernel)
+    {
+        if (first > last || last > scene.getPaddedCount()
+         || first % OBJECTS_PER_CACHE_LINE != 0 || last % OBJECTS_PER_CACHE_LINE != 0)
+            throw std::invalid_argument(std::format("invalid culling range [{}, {}) of {} padded objects",
+                                                    first, last, scene.getPaddedCount()));
+        if (visible.size() < last - first)
+            throw std::invalid_argument(std::format("the visible list holds {} of the range's {} objects",
+                                                    visible.size(), last - first));
+
+        return runKernel(scene, params, first, last, visible.data(), kernel);
+    }
+
+    SceneCuller::SceneCuller(const std::uint32_t worker_count, const std::uint32_t parallel_threshold)
+        : m_worker_count{ worker_count },
+          m_parallel_threshold{ parallel_threshold },
+          m_workers{ worker_count }
+    {
+        m_chunk_counts.reserve(m_worker_count + 1);
+        m_chunks.reserve(m_worker_count);
+    }
+
+    std::span<const std::uint32_t> SceneCuller::cull(const Scene& scene,
+                                                     const CullingParams& params,
+                                                     const CullingKernel kernel)
+    {
+        // Keep the previous list, so the caller can tell whether the visible objects changed
+        std::swap(m_visible, m_previous);
+        const auto previous_count{ std::exchange(m_visible_count, 0) };
+        const auto padded_count{ scene.getPaddedCount() };
+        m_visible.resize(padded_count);
+
+        if (m_worker_count == 0 || scene.getObjectCount() < m_parallel_threshold) {
+            m_visible_count = runKernel(scene, params, 0, padded_count, m_visible.data(), kernel);
+        } else {
+            // Split the scene into chunks of whole cache lines, keeping enough objects in each to be worthwhile. Every
+            // chunk lies within the padded count, so none is validated.
+            const auto chunk_count{ std::clamp(padded_count / MIN_OBJECTS_PER_CHUNK, 1u, m_worker_count + 1) };
+            const auto chunk_size{ roundUpToCacheLine((padded_count + chunk_count - 1) / chunk_count) };
+            const auto cullChunk = [&, chunk_size](const std::uint32_t chunk) {
+                const auto first{ std::min(chunk * chunk_size, padded_count) };
+                const auto last{ std::min(first + chunk_size, padded_count) };
+                m_chunk_counts[chunk] = runKernel(scene, params, first, last, m_visible.data() + first, kernel);
+            };
+
+            // The calling thread culls the first chunk while the workers cull the rest
+            m_chunk_counts.assign(chunk_count, 0);
+            m_chunks.clear();
+            for (std::uint32_t i = 1; i < chunk_count; ++i)
+                m_chunks.push_back(m_workers.submit([&cullChunk, i] { cullChunk(i); }));
+            cullChunk(0);
+
+            // Wait for every worker before rethrowing, so no worker is still culling when the caller unwinds
+            for (auto& chunk : m_chunks)
+                chunk.wait();
+            for (auto& chunk : m_chunks)
+                chunk.get();
+
+            // Pack each chunk's visible objects after those of the chunks before it, never overtaking the source
+            m_visible_count = m_chunk_counts.front();
+            for (std::uint32_t i = 1; i < chunk_count; ++i) {
+                // Each slice moves toward the front, which std::copy allows unless it is already in place, when
+                // every earlier chunk was wholly visible
+                const auto offset{ std::min(i * chunk_size, padded_count) };
+                if (offset != m_visible_count) {
+                    const auto first{ m_visible.begin() + offset };
+                    std::copy(first, first + m_chunk_counts[i], m_visible.begin() + m_visible_count);
+                }
+                m_visible_count += m_chunk_counts[i];
+            }
+        }
+
+        m_changed = !std::ranges::equal(getVisible(), std::span{ m_previous }.first(previous_count));
+        return getVisible();
+    }
+}
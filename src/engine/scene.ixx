@@ -0,0 +1,227 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+export module scene;
+
+// External Dependencies
+import glm;
+
+// Internal Dependencies
+import container_utils;
+import culling;
+import thread_pool;
+
+namespace eng::scene {
+    /**
+     * The instruction set the culling kernel is vectorized with, and the number of objects it tests at once. The
+     * build selects the widest the target supports, falling back to one object at a time.
+     */
+#if defined(__AVX2__)
+    export constexpr std::string_view SIMD_KERNEL_NAME{ "avx2" };
+    export constexpr std::uint32_t SIMD_WIDTH{ 8 };
+#elif defined(__SSE__) || defined(_M_X64)
+    export constexpr std::string_view SIMD_KERNEL_NAME{ "sse" };
+    export constexpr std::uint32_t SIMD_WIDTH{ 4 };
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    export constexpr std::string_view SIMD_KERNEL_NAME{ "neon" };
+    export constexpr std::uint32_t SIMD_WIDTH{ 4 };
+#else
+    export constexpr std::string_view SIMD_KERNEL_NAME{ "scalar" };
+    export constexpr std::uint32_t SIMD_WIDTH{ 1 };
+#endif
+
+    /**
+     * The number of objects whose component fills a cache line. Every array of a scene is padded to a multiple of
+     * it, so the kernel never tests a partial vector and ranges culled on different threads never share a line.
+     */
+    export constexpr std::uint32_t OBJECTS_PER_CACHE_LINE{ util::CACHE_LINE_SIZE / sizeof(float) };
+    static_assert(OBJECTS_PER_CACHE_LINE % SIMD_WIDTH == 0);
+
+    /**
+     * The fewest objects a scene is culled across threads at, below this the whole scene is culled in less time
+     * than it takes to wake the workers
+     */
+    export constexpr std::uint32_t PARALLEL_CULLING_THRESHOLD{ 100'000 };
+
+    /**
+     * The fewest objects given to each thread when culling in parallel
+     */
+    export constexpr std::uint32_t MIN_OBJECTS_PER_CHUNK{ 16'384 };
+    static_assert(MIN_OBJECTS_PER_CHUNK % OBJECTS_PER_CACHE_LINE == 0);
+
+    /**
+     * The implementation of the culling kernel, the vectorized kernel is the scalar one if no vector instruction set
+     * is available
+     */
+    export enum class CullingKernel : std::uint8_t
+    {
+        Scalar,
+        Simd
+    };
+
+    /**
+     * The volume an object's bounding sphere must intersect to be drawn
+     */
+    export struct CullingParams
+    {
+        cull::Frustum frustum{ cull::extractFrustum(glm::mat4{ 1.0f }) };
+        glm::vec3 camera_position{ 0.0f };
+        float max_distance{ std::numeric_limits<float>::infinity() };   // From the camera to the nearest point of a sphere
+    };
+
+    /**
+     * The objects of a scene, with their bounding spheres and transforms in structure-of-arrays layout. Each
+     * component is a separate cache line aligned array, so culling streams through only the components it tests,
+     * and loads a full vector of objects with one aligned load.
+     */
+    export class Scene
+    {
+    public:
+        /* Constructors */
+
+        Scene() = default;
+
+        // Splits the objects into their components, padding each array with objects which are never visible
+        explicit Scene(std::span<const cull::ObjectData> objects);
+
+        /* Conversion Methods */
+
+        // Returns the objects interleaved as the culling shader and the indirect vertex shader read them
+        [[nodiscard]] std::vector<cull::ObjectData> getObjectData() const;
+
+        /* Accessors */
+
+        [[nodiscard]] std::uint32_t getObjectCount() const
+        { return m_object_count; }
+
+        // Returns the object count rounded up to whole cache lines, the length of every component array
+        [[nodiscard]] std::uint32_t getPaddedCount() const
+        { return static_cast<std::uint32_t>(m_radius.size()); }
+
+        // Returns an object's transform, its offset in xy and its uniform scale in z
+        [[nodiscard]] glm::vec4 getTransform(const std::uint32_t object) const
+        { return { m_offset_x[object], m_offset_y[object], m_scale[object], 0.0f }; }
+
+        [[nodiscard]] std::span<const float> getCenterX() const
+        { return m_center_x; }
+
+        [[nodiscard]] std::span<const float> getCenterY() const
+        { return m_center_y; }
+
+        [[nodiscard]] std::span<const float> getCenterZ() const
+        { return m_center_z; }
+
+        // The padding's radii are negative infinity, so it fails every plane test
+        [[nodiscard]] std::span<const float> getRadius() const
+        { return m_radius; }
+
+    private:
+        /* Data Members */
+
+        std::uint32_t m_object_count{ 0 };
+
+        // Bounding spheres
+        util::CacheLineVector<float> m_center_x;
+        util::CacheLineVector<float> m_center_y;
+        util::CacheLineVector<float> m_center_z;
+        util::CacheLineVector<float> m_radius;
+
+        // Transforms
+        util::CacheLineVector<float> m_offset_x;
+        util::CacheLineVector<float> m_offset_y;
+        util::CacheLineVector<float> m_scale;
+    };
+
+    /* Culling Functions */
+
+    /**
+     * Culls a range of a scene's objects against the frustum and the maximum distance, writing the indices of
+     * those visible in ascending order
+     * @param scene the scene to cull
+     * @param params the frustum and the maximum distance
+     * @param first the first object of the range, a multiple of OBJECTS_PER_CACHE_LINE
+     * @param last one past the last object of the range, a multiple of OBJECTS_PER_CACHE_LINE within the padded count
+     * @param visible receives the indices of the visible objects, must hold at least last - first indices
+     * @param kernel the implementation of the kernel
+     * @return the number of indices written
+     * @throws std::invalid_argument if the range is misaligned or out of bounds, or the visible list is too small
+     */
+    export [[nodiscard]] std::uint32_t
+    cullRange(const Scene& scene,
+              const CullingParams& params,
+              std::uint32_t first,
+              std::uint32_t last,
+              std::span<std::uint32_t> visible,
+              CullingKernel kernel = CullingKernel::Simd);
+
+    /**
+     * Culls a scene into a compact list of the visible objects' indices, which is recorded in place of the whole
+     * scene. Scenes of at least the parallel threshold are split into chunks of whole cache lines, one per worker
+     * and one for the calling thread, each writing into its own slice of the list before the slices are packed.
+     */
+    export class SceneCuller
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Starts the worker threads
+         * @param worker_count the number of workers culling alongside the calling thread
+         * @param parallel_threshold the fewest objects a scene is culled across threads at
+         */
+        explicit SceneCuller(std::uint32_t worker_count = static_cast<std::uint32_t>(util::ThreadPool::getDefaultThreadCount()),
+                             std::uint32_t parallel_threshold = PARALLEL_CULLING_THRESHOLD);
+
+        SceneCuller(const SceneCuller&) = delete;
+        SceneCuller& operator=(const SceneCuller&) = delete;
+
+        /* Culling Methods */
+
+        /**
+         * Culls the scene, replacing the previous visible list. Blocks until every chunk has been culled.
+         * @param scene the scene to cull
+         * @param params the frustum and the maximum distance
+         * @param kernel the implementation of the kernel
+         * @return the indices of the visible objects in ascending order, valid until the next call
+         */
+        std::span<const std::uint32_t> cull(const Scene& scene,
+                                            const CullingParams& params,
+                                            CullingKernel kernel = CullingKernel::Simd);
+
+        /* Accessors */
+
+        [[nodiscard]] std::span<const std::uint32_t> getVisible() const
+        { return std::span{ m_visible }.first(m_visible_count); }
+
+        // Returns true if the last cull's visible objects differ from those of the cull before it
+        [[nodiscard]] bool hasChanged() const
+        { return m_changed; }
+
+        [[nodiscard]] std::uint32_t getWorkerCount() const
+        { return m_worker_count; }
+
+        [[nodiscard]] std::uint32_t getParallelThreshold() const
+        { return m_parallel_threshold; }
+
+    private:
+        /* Data Members */
+
+        std::uint32_t                           m_worker_count;
+        std::uint32_t                           m_parallel_threshold;
+        util::CacheLineVector<std::uint32_t>    m_visible;
+        util::CacheLineVector<std::uint32_t>    m_previous;         // The list of the cull before, to detect changes
+        std::uint32_t                           m_visible_count{ 0 };
+        bool                                    m_changed{ true };
+        std::vector<std::uint32_t>              m_chunk_counts;     // The visible objects of each chunk
+        std::vector<std::future<void>>          m_chunks;
+
+        util::ThreadPool    m_workers;  // Declared last, so the workers are joined before the lists are destroyed
+    };
+}
@@ -0,0 +1,80 @@
+module;
+
+#include <filesystem>
+#include <format>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+module shader_cache;
+
+// Internal Dependencies
+import debug_utils;
+import file_utils;
+import hash_utils;
+
+namespace eng::pipe {
+    vk::ShaderModule ShaderModuleCache::acquire(const std::filesystem::path& file_path)
+    {
+        // Skip re-reading files which are unchanged since they were last loaded
+        const auto last_write_time{ std::filesystem::last_write_time(file_path) };
+        {
+            const std::scoped_lock lock{ m_mutex };
+            if (const auto path_iter{ m_paths.find(file_path.string()) };
+                path_iter != m_paths.end() && path_iter->second.last_write_time == last_write_time) {
+                if (const auto module_iter{ m_modules.find(path_iter->second.content_hash) };
+                    module_iter != m_modules.end()) {
+                    ++m_hits;
+                    return module_iter->second.shader_module.get();
+                }
+            }
+        }
+
+        // Map and hash the file outside the lock, so other threads are not blocked on I/O
+        const util::SPIRVFile spirv{ file_path };
+        const auto content_hash{ util::fnv1a(spirv.bytes()) };
+        const auto check_hash{ util::mix64(spirv.bytes()) };
+
+        const std::scoped_lock lock{ m_mutex };
+        // Return the existing module, rejecting hash collisions rather than silently binding the wrong code
+        if (const auto module_iter{ m_modules.find(content_hash) }; module_iter != m_modules.end()) {
+            if (module_iter->second.code_size != spirv.bytes().size() || module_iter->second.check_hash != check_hash)
+                throw std::logic_error(std::format("shader module hash collision on key {:#018x} loading {}",
+                                                   content_hash,
+                                                   file_path.string()));
+            m_paths.insert_or_assign(file_path.string(), PathEntry{ last_write_time, content_hash });
+            ++m_hits;
+            return module_iter->second.shader_module.get();
+        }
+
+        // The mapped words are handed to the driver directly, with no intermediate copy
+        const auto code{ spirv.code() };
+        const vk::ShaderModule shader_module{ m_device->createShaderModule(vk::ShaderModuleCreateInfo()
+            .setCodeSize( code.size_bytes() )
+            .setPCode( code.data() )
+        ) };
+        if constexpr (dbg::ENABLED)
+            dbg::setObjectName(m_device, shader_module, file_path.filename().string().c_str());
+        m_paths.insert_or_assign(file_path.string(), PathEntry{ last_write_time, content_hash });
+        m_modules.emplace(content_hash, ModuleEntry{
+            vk::SharedShaderModule{ shader_module, m_device },
+            spirv.bytes().size(),
+            check_hash
+        });
+        ++m_misses;
+        return shader_module;
+    }
+
+    void ShaderModuleCache::clear()
+    {
+        const std::scoped_lock lock{ m_mutex };
+        m_modules.clear();
+        m_paths.clear();
+    }
+
+    ShaderCacheStatistics ShaderModuleCache::getStatistics() const
+    {
+        const std::scoped_lock lock{ m_mutex };
+        return { m_modules.size(), m_hits, m_misses };
+    }
+}
@@ -0,0 +1,85 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+export module shader_cache;
+
+// External Dependencies
+import vulkan_hpp;
+
+namespace eng::pipe {
+    export struct ShaderCacheStatistics
+    {
+        std::size_t module_count{ 0 };     // Unique shader modules held by the cache
+        std::uint32_t hits{ 0 };            // Requests served by an existing module
+        std::uint32_t misses{ 0 };          // Requests which created a new module
+    };
+
+    /**
+     * Shares shader modules across pipelines, keyed by a hash of their SPIR-V contents so identical code
+     * loaded from different paths resolves to a single module. Each module keeps its code's size and a second,
+     * independent hash, so a hash collision is detected rather than resolving to the wrong module, without keeping a
+     * copy of the code. Safe to use from multiple threads.
+     */
+    export class ShaderModuleCache
+    {
+    public:
+        /* Constructors */
+
+        explicit ShaderModuleCache(vk::SharedDevice device)
+            : m_device{ std::move(device) }
+        {}
+
+        ShaderModuleCache(const ShaderModuleCache&) = delete;
+        ShaderModuleCache& operator=(const ShaderModuleCache&) = delete;
+
+        /* Lookup Methods */
+
+        /**
+         * Returns the module for a SPIR-V file, memory-mapping and validating the file only if it has not been seen
+         * or has been modified since it was last loaded
+         * @param file_path the path to the .spv file
+         * @return a shader module owned by the cache, valid until the cache is cleared or destroyed
+         * @throws std::runtime_error if the file cannot be loaded or is not valid SPIR-V
+         * @throws std::logic_error if the file's contents collide with a different module's hash
+         */
+        [[nodiscard]] vk::ShaderModule acquire(const std::filesystem::path& file_path);
+
+        // Releases every module, e.g., once startup compilation has finished. Must not be called while any
+        // pipeline using a module from this cache is still being created.
+        void clear();
+
+        [[nodiscard]] ShaderCacheStatistics getStatistics() const;
+
+    private:
+        /* Data Members */
+
+        struct PathEntry
+        {
+            std::filesystem::file_time_type last_write_time;
+            std::uint64_t content_hash;
+        };
+
+        struct ModuleEntry
+        {
+            vk::SharedShaderModule  shader_module;
+
+            // Compared against any file whose contents hash to the same key
+            std::size_t             code_size;
+            std::uint64_t           check_hash;
+        };
+
+        vk::SharedDevice                                    m_device;
+        mutable std::mutex                                  m_mutex;
+        std::unordered_map<std::string, PathEntry>          m_paths;
+        std::unordered_map<std::uint64_t, ModuleEntry>      m_modules;
+        std::uint32_t                                       m_hits{ 0 };
+        std::uint32_t                                       m_misses{ 0 };
+    };
+}
@@ -0,0 +1,202 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+module staging;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::staging {
+    namespace {
+        // Every range starts on this boundary, which satisfies the copy alignment of any buffer or image format
+        constexpr vk::DeviceSize RING_ALIGNMENT{ 16 };
+
+        // Smallest range handed out while the ring is partly full, so large uploads are not split into slivers
+        constexpr vk::DeviceSize MIN_CHUNK_SIZE{ 64ull * 1024 };
+
+        [[nodiscard]] constexpr vk::DeviceSize alignUp(const vk::DeviceSize value, const vk::DeviceSize alignment)
+        { return (value + alignment - 1) & ~(alignment - 1); }
+    }
+
+    StagingRing::StagingRing(vk::SharedDevice device,
+                             mem::DeviceAllocator& allocator,
+                             sched::QueueScheduler& scheduler,
+                             const std::uint32_t max_submissions_in_flight,
+                             const vk::DeviceSize capacity)
+        : m_device{ std::move(device) },
+          m_scheduler{ scheduler },
+          m_capacity{ capacity & ~(RING_ALIGNMENT - 1) }
+    {
+        if (max_submissions_in_flight == 0 || m_capacity == 0)
+            throw std::invalid_argument("staging ring requires a non-zero capacity and submission count");
+
+        m_ring = allocator.createBuffer(vk::BufferCreateInfo()
+            .setSize( m_capacity )
+            .setUsage( vk::BufferUsageFlagBits::eTransferSrc )
+            .setSharingMode( vk::SharingMode::eExclusive ),
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        m_command_pool = vk::SharedCommandPool{ m_device->createCommandPool(vk::CommandPoolCreateInfo()
+            .setFlags( vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer )
+            .setQueueFamilyIndex( m_scheduler.getFamilyIndex(sched::QueueType::Transfer) )
+        ), m_device };
+        dbg::setObjectName(m_device, m_ring.get().get(), "staging ring");
+        dbg::setObjectName(m_device, m_command_pool.get(), "staging command pool");
+
+        const auto command_buffers{ m_device->allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+            .setCommandPool( m_command_pool.get() )
+            .setLevel( vk::CommandBufferLevel::ePrimary )
+            .setCommandBufferCount( max_submissions_in_flight )
+        ) };
+
+        m_submissions.reserve(max_submissions_in_flight);
+        for (const auto& command_buffer : command_buffers) {
+            m_submissions.push_back({ vk::SharedCommandBuffer{ command_buffer, m_device, m_command_pool } });
+        }
+    }
+
+    void StagingRing::enqueueUpload(const std::span<const std::byte> data,
+                                    const vk::Buffer destination,
+                                    const vk::DeviceSize destination_offset)
+    {
+        // Data larger than the free space is streamed through the ring in chunks
+        vk::DeviceSize uploaded{ 0 };
+        while (uploaded < data.size()) {
+            const auto [ offset, size ]{ reserve(data.size() - uploaded) };
+            std::memcpy(m_ring.getMapped() + offset, data.data() + uploaded, size);
+            m_pending.push_back({ destination, vk::BufferCopy{ offset, destination_offset + uploaded, size } });
+            uploaded += size;
+        }
+        m_statistics.bytes_uploaded += data.size();
+    }
+
+    std::uint64_t StagingRing::submit()
+    {
+        flush();
+        retire(false);
+        return std::exchange(m_unreturned, 0);
+    }
+
+    void StagingRing::waitIdle()
+    {
+        flush();
+        while (!m_in_flight.empty())
+            retire(true);
+    }
+
+    std::pair<vk::DeviceSize, vk::DeviceSize> StagingRing::reserve(const vk::DeviceSize size)
+    {
+        const auto min_size{ std::min({ size, MIN_CHUNK_SIZE, m_capacity }) };
+        while (true) {
+            retire(false);
+
+            // Once nothing is pending or in flight the whole ring is free, including space skipped at a wrap
+            if (m_pending.empty() && m_in_flight.empty())
+                m_head = m_tail = m_used = 0;
+
+            const bool full{ m_used == m_capacity };
+            if (!full && m_head >= m_tail) {
+                // Free space runs from the head to the end of the ring, then from the start to the tail
+                const auto end_space{ m_capacity - m_head };
+                if (end_space >= min_size) {
+                    const auto granted{ std::min(size, end_space) };
+                    const auto offset{ m_head };
+                    m_head = alignUp(m_head + granted, RING_ALIGNMENT) % m_capacity;
+                    m_used += alignUp(granted, RING_ALIGNMENT);
+                    return { offset, granted };
+                }
+                if (m_tail >= min_size) {
+                    // Skip the unusable end of the ring, the skipped space is released with the data before it
+                    m_used += end_space;
+                    m_head = 0;
+                    continue;
+                }
+            } else if (!full) {
+                const auto space{ m_tail - m_head };
+                if (space >= min_size) {
+                    const auto granted{ std::min(size, space) };
+                    const auto offset{ m_head };
+                    m_head += alignUp(granted, RING_ALIGNMENT);
+                    m_used += alignUp(granted, RING_ALIGNMENT);
+                    return { offset, granted };
+                }
+            }
+
+            // The ring is full, submit what is queued so it can drain, then wait for the oldest submission
+            ++m_statistics.stalls;
+            if (!m_pending.empty())
+                flush();
+            retire(true);
+        }
+    }
+
+    void StagingRing::flush()
+    {
+        if (m_pending.empty())
+            return;
+
+        // Submission slots are reused in order, so only the oldest in-flight submission can occupy the next slot
+        while (!m_in_flight.empty() && std::ranges::contains(m_in_flight, m_next_submission)) {
+            ++m_statistics.stalls;
+            retire(true);
+        }
+        const auto& submission{ m_submissions[m_next_submission] };
+        const auto& command_buffer{ submission.command_buffer };
+
+        // Record one copy command per destination buffer, with a region for each queued upload
+        std::ranges::stable_sort(m_pending, {}, &PendingCopy::destination);
+        command_buffer->reset();
+        command_buffer->begin(vk::CommandBufferBeginInfo().setFlags( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ));
+        std::vector<vk::BufferCopy> regions;
+        for (auto iter{ m_pending.begin() }; iter != m_pending.end();) {
+            const auto destination{ iter->destination };
+            regions.clear();
+            for (; iter != m_pending.end() && iter->destination == destination; ++iter)
+                regions.push_back(iter->region);
+            command_buffer->copyBuffer(m_ring.get().get(), destination, regions);
+        }
+        command_buffer->end();
+
+        // Timeline values are signaled in submission order, so the new value also covers any earlier, unreturned one
+        const std::array command_buffers{ command_buffer.get() };
+        const auto timeline_value{ m_scheduler.submit(sched::QueueType::Transfer, command_buffers) };
+
+        m_submissions[m_next_submission].timeline_value = timeline_value;
+        m_submissions[m_next_submission].ring_end = m_head;
+        m_in_flight.push_back(m_next_submission);
+        m_unreturned = timeline_value;
+        m_next_submission = (m_next_submission + 1) % static_cast<std::uint32_t>(m_submissions.size());
+        m_pending.clear();
+        ++m_statistics.submissions;
+    }
+
+    void StagingRing::retire(bool wait)
+    {
+        auto completed{ m_scheduler.getCompletedValue(sched::QueueType::Transfer) };
+        while (!m_in_flight.empty()) {
+            const auto& submission{ m_submissions[m_in_flight.front()] };
+            if (wait && completed < submission.timeline_value) {
+                m_scheduler.wait(sched::QueueType::Transfer, submission.timeline_value);
+                completed = submission.timeline_value;
+            } else if (completed < submission.timeline_value) {
+                break;
+            }
+            wait = false;
+
+            // Release everything between the tail and the end of this submission's data, including skipped space
+            const auto released{ (submission.ring_end + m_capacity - m_tail) % m_capacity };
+            m_used -= released == 0 ? m_used : released;
+            m_tail = submission.ring_end;
+            m_in_flight.pop_front();
+        }
+    }
+}
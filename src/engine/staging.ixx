@@ -0,0 +1,143 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+export module staging;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+import queue_scheduler;
+
+namespace eng::staging {
+    /**
+     * The default size of the staging ring, uploads larger than the ring are streamed through it in chunks
+     */
+    export constexpr vk::DeviceSize DEFAULT_STAGING_CAPACITY{ 64ull * 1024 * 1024 };
+
+    export struct StagingStatistics
+    {
+        std::uint64_t bytes_uploaded{ 0 };
+        std::uint32_t submissions{ 0 };     // Transfer queue submissions, ideally one per frame with pending uploads
+        std::uint32_t stalls{ 0 };          // Times the CPU blocked because the ring was full
+    };
+
+    /**
+     * A persistently mapped, host-visible ring buffer which batches buffer uploads into a single transfer
+     * submission per frame. Space is reclaimed as the transfer queue's timeline passes each submission, so
+     * uploads only block the caller when more data is queued than the ring can hold.
+     */
+    export class StagingRing
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the ring buffer and the resources for each in-flight submission
+         * @param device the logical device which will own the resources
+         * @param allocator the allocator the ring buffer is sub-allocated from
+         * @param scheduler the scheduler uploads are submitted through, on its transfer queue
+         * @param max_submissions_in_flight the number of submissions which may be pending at once,
+         *                                  at least the number of frames in flight
+         * @param capacity the size of the ring buffer in bytes
+         */
+        StagingRing(vk::SharedDevice device,
+                    mem::DeviceAllocator& allocator,
+                    sched::QueueScheduler& scheduler,
+                    std::uint32_t max_submissions_in_flight,
+                    vk::DeviceSize capacity = DEFAULT_STAGING_CAPACITY);
+
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        /* Upload Methods */
+
+        /**
+         * Copies data into the ring and queues a copy into the destination buffer, executed on the next submit.
+         * Blocks only if the ring does not have room for the data.
+         * @param data the bytes to upload
+         * @param destination the buffer to upload into, must have been created with eTransferDst usage
+         * @param destination_offset the offset into the destination buffer
+         */
+        void enqueueUpload(std::span<const std::byte> data, vk::Buffer destination, vk::DeviceSize destination_offset = 0);
+
+        template <typename T>
+        void enqueueUpload(const std::span<const T> data,
+                           const vk::Buffer destination,
+                           const vk::DeviceSize destination_offset = 0)
+        { enqueueUpload(std::as_bytes(data), destination, destination_offset); }
+
+        /**
+         * Records every queued copy into one command buffer and submits it to the transfer queue
+         * @return the transfer timeline value the next submission consuming the uploaded data must wait for, or
+         *         zero if nothing was uploaded since the last call. It covers every earlier upload, including those
+         *         flushed early because the ring was full.
+         */
+        [[nodiscard]] std::uint64_t submit();
+
+        // Blocks until every submitted upload has completed
+        void waitIdle();
+
+        /* Accessors */
+
+        [[nodiscard]] const StagingStatistics& getStatistics() const
+        { return m_statistics; }
+
+    private:
+        /* Data Members */
+
+        struct PendingCopy
+        {
+            vk::Buffer destination;
+            vk::BufferCopy region;
+        };
+
+        struct Submission
+        {
+            vk::SharedCommandBuffer command_buffer;
+            std::uint64_t           timeline_value{ 0 };    // Reached by the transfer timeline once complete
+            vk::DeviceSize          ring_end{ 0 };  // The ring is free up to here once this submission completes
+        };
+
+        vk::SharedDevice        m_device;
+        sched::QueueScheduler&  m_scheduler;
+        vk::SharedCommandPool   m_command_pool;
+        mem::AllocatedBuffer    m_ring;
+        vk::DeviceSize          m_capacity;
+
+        vk::DeviceSize                  m_head{ 0 };        // Next write position
+        vk::DeviceSize                  m_tail{ 0 };        // Start of the oldest data still in use by the GPU
+        vk::DeviceSize                  m_used{ 0 };        // Bytes between tail and head, including skipped space
+
+        std::vector<PendingCopy>        m_pending;
+        std::vector<Submission>         m_submissions;
+        std::deque<std::uint32_t>       m_in_flight;        // Indices into m_submissions, oldest first
+        std::uint32_t                   m_next_submission{ 0 };
+        std::uint64_t                   m_unreturned{ 0 };  // Signaled by the latest submission, not yet returned by submit
+
+        StagingStatistics               m_statistics;
+
+        /* Helper Methods */
+
+        /**
+         * Reserves a contiguous range of the ring, waiting for in-flight submissions or flushing pending copies
+         * if the ring is full
+         * @param size the preferred size of the range
+         * @return the offset and size of the reserved range, which may be smaller than requested
+         */
+        [[nodiscard]] std::pair<vk::DeviceSize, vk::DeviceSize> reserve(vk::DeviceSize size);
+
+        // Records and submits the pending copies, if any
+        void flush();
+
+        // Releases the ring space of completed submissions, blocking on the oldest if wait is true
+        void retire(bool wait);
+    };
+}
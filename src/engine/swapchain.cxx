@@ -1,25 +1,35 @@
 module;
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <iterator>
 #include <limits>
+#include <span>
+#include <thread>
+#include <utility>
 
 module swapchain;
 
+// Internal Dependencies
+import debug_utils;
+
 namespace eng::swap {
     SwapchainComponents createSwapchain(const GPU& gpu,
                                         const vk::Device& device,
                                         const vk::SurfaceKHR& surface,
                                         const vk::Extent2D& window_extent,
                                         const vk::ImageUsageFlags usage,
+                                        const PresentConfig& config,
                                         const vk::SwapchainKHR& old_swapchain)
     {
         const auto surface_capabilities{ gpu.getDevice().getSurfaceCapabilitiesKHR(surface) };
         const auto [ color_format, color_space ] = selectSurfaceFormat(gpu.getDevice().getSurfaceFormatsKHR(surface));
         const auto image_extent{ getImageExtent(surface_capabilities, window_extent) };
+        const auto present_mode{ selectPresentMode(gpu.getDevice().getSurfacePresentModesKHR(surface), config.policy) };
         auto create_info = vk::SwapchainCreateInfoKHR()
             .setSurface( surface )
-            .setMinImageCount( chooseImageCount(surface_capabilities) )
+            .setMinImageCount( chooseImageCount(surface_capabilities, config.image_count) )
             .setImageFormat( color_format )
             .setImageColorSpace( color_space )
             .setImageExtent( image_extent )
@@ -27,35 +37,42 @@ namespace eng::swap {
             .setImageUsage( usage )
             .setPreTransform( surface_capabilities.currentTransform )
             .setCompositeAlpha( vk::CompositeAlphaFlagBitsKHR::eOpaque )
-            .setPresentMode( selectPresentMode(gpu.getDevice().getSurfacePresentModesKHR(surface)) )
+            .setPresentMode( present_mode )
             .setClipped( true )
             .setOldSwapchain( old_swapchain );
+        const std::array queue_family_indices{ gpu.getGraphicsFamilyIndex(), gpu.getPresentFamilyIndex() };
         if (gpu.getGraphicsFamilyIndex() == gpu.getPresentFamilyIndex()) {
             create_info.setImageSharingMode( vk::SharingMode::eExclusive );
         } else {
             create_info.setImageSharingMode( vk::SharingMode::eConcurrent );
-            create_info.setQueueFamilyIndexCount( 2 );
-            create_info.setPQueueFamilyIndices(
-                std::array{ gpu.getGraphicsFamilyIndex(), gpu.getPresentFamilyIndex() }.data()
-            );
+            create_info.setQueueFamilyIndices( queue_family_indices );
         }
 
         const vk::SwapchainKHR swapchain{ device.createSwapchainKHR(create_info) };
         const std::vector images{ device.getSwapchainImagesKHR(swapchain) };
+        auto image_views{ createImageViews(images, color_format, device) };
+
+        dbg::setObjectName(device, swapchain, "swapchain");
+        for (std::size_t i = 0; i < images.size(); ++i) {
+            dbg::setObjectName(device, images[i], "swapchain image {}", i);
+            dbg::setObjectName(device, image_views[i], "swapchain image {} view", i);
+        }
+
         return {
             color_format,
             image_extent,
+            present_mode,
             swapchain,
             images,
-            createImageViews(images, color_format, device)
+            std::move(image_views)
         };
     }
 
-    uint32_t chooseImageCount(const vk::SurfaceCapabilitiesKHR& capabilities)
+    uint32_t chooseImageCount(const vk::SurfaceCapabilitiesKHR& capabilities, const std::uint32_t requested_count)
     {
         const auto min_images{ capabilities.minImageCount };
         const auto max_images{ capabilities.maxImageCount };
-        const auto target_image_count{ min_images + 1 };
+        const auto target_image_count{ requested_count == 0 ? min_images + 1 : std::max(requested_count, min_images) };
         return target_image_count < max_images || max_images == 0 ? target_image_count : max_images;
     }
 
@@ -79,15 +96,22 @@ namespace eng::swap {
         return supported_formats.front();
     }
 
-    vk::PresentModeKHR selectPresentMode(const std::span<const vk::PresentModeKHR> supported_present_modes)
+    vk::PresentModeKHR selectPresentMode(const std::span<const vk::PresentModeKHR> supported_present_modes,
+                                         const PresentPolicy policy)
     {
-        constexpr auto target_present_mode{
-            vk::PresentModeKHR::eMailbox
-        };
+        // Each policy's preferred mode, followed by its fallbacks in order of increasing latency
+        constexpr std::array low_latency_modes{ vk::PresentModeKHR::eImmediate, vk::PresentModeKHR::eMailbox };
+        constexpr std::array mailbox_modes{ vk::PresentModeKHR::eMailbox };
+        std::span<const vk::PresentModeKHR> target_present_modes;
+        switch (policy) {
+            case PresentPolicy::LowLatency: target_present_modes = low_latency_modes; break;
+            case PresentPolicy::Mailbox:    target_present_modes = mailbox_modes; break;
+            case PresentPolicy::VSync:      break;
+        }
 
-        for (const auto& present_mode : supported_present_modes) {
-            if (present_mode == target_present_mode)
-                return present_mode;
+        for (const auto& target : target_present_modes) {
+            if (std::ranges::contains(supported_present_modes, target))
+                return target;
         }
 
         // Fallback to FIFO mode, which is guaranteed to be supported
@@ -132,4 +156,35 @@ namespace eng::swap {
         }
         return image_views;
     }
+
+    FrameLimiter::FrameLimiter(const double frames_per_second)
+    {
+        setRate(frames_per_second);
+    }
+
+    std::chrono::nanoseconds FrameLimiter::wait()
+    {
+        if (!isEnabled())
+            return std::chrono::nanoseconds{ 0 };
+
+        // A frame which started late moves the schedule, so the following frames are not rushed to make up for it
+        const auto now{ std::chrono::steady_clock::now() };
+        if (now >= m_next_frame) {
+            m_next_frame = now + m_interval;
+            return std::chrono::nanoseconds{ 0 };
+        }
+
+        std::this_thread::sleep_until(m_next_frame);
+        const auto woken{ std::chrono::steady_clock::now() };
+        m_next_frame += m_interval;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(woken - now);
+    }
+
+    void FrameLimiter::setRate(const double frames_per_second)
+    {
+        m_interval = frames_per_second > 0.0
+            ? std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>{ 1.0 / frames_per_second })
+            : std::chrono::nanoseconds{ 0 };
+        m_next_frame = { };
+    }
 }
@@ -1,5 +1,7 @@
 module;
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 export module swapchain;
@@ -12,15 +14,70 @@ import gpu;
 import vulkan_utils;
 
 namespace eng::swap {
+    /**
+     * How frames are handed to the presentation engine, trading latency against tearing and power
+     */
+    export enum class PresentPolicy : std::uint8_t
+    {
+        LowLatency,     // Immediate, presenting without waiting for vertical blank, and tearing
+        VSync,          // FIFO, never tearing and throttling rendering to the refresh rate
+        Mailbox         // Mailbox, never tearing while rendering unthrottled, replacing queued frames
+    };
+
+    export struct PresentConfig
+    {
+        PresentPolicy policy{ PresentPolicy::Mailbox };
+        std::uint32_t image_count{ 0 };         // Clamped to the surface's limits, one above the minimum if zero
+        std::uint32_t max_queued_presents{ 1 }; // Presents which may be pending before a frame starts, with present wait
+    };
+
     export struct SwapchainComponents
     {
         vk::Format color_format;
         vk::Extent2D extent;
+        vk::PresentModeKHR present_mode;
         vk::SwapchainKHR swapchain;
         std::vector<vk::Image> images;
         std::vector<vk::ImageView> image_views;
     };
 
+    /**
+     * Caps the rate at which frames start by sleeping the CPU until each frame's deadline, which also bounds
+     * latency under an unthrottled present mode. A limiter which falls behind restarts its schedule rather than
+     * rushing to catch up.
+     */
+    export class FrameLimiter
+    {
+    public:
+        /* Constructors */
+
+        // Creates a limiter, a rate of zero imposes no limit
+        explicit FrameLimiter(double frames_per_second = 0.0);
+
+        /* Pacing Methods */
+
+        // Blocks until the next frame may start, returning the time spent sleeping
+        std::chrono::nanoseconds wait();
+
+        /* Mutators */
+
+        void setRate(double frames_per_second);
+
+        /* Accessors */
+
+        [[nodiscard]] bool isEnabled() const
+        { return m_interval.count() > 0; }
+
+        [[nodiscard]] std::chrono::nanoseconds getInterval() const
+        { return m_interval; }
+
+    private:
+        /* Data Members */
+
+        std::chrono::nanoseconds                m_interval{ 0 };
+        std::chrono::steady_clock::time_point   m_next_frame{ };
+    };
+
     /* Swapchain Creation Methods */
 
     /**
@@ -30,6 +87,7 @@ namespace eng::swap {
      * @param surface the surface to which images will be presented
      * @param window_extent the extent of the window corresponding to the surface
      * @param usage the usage flags for this swapchain
+     * @param config the presentation policy and image count
      * @param old_swapchain optional parameter, a reference to an existing swapchain being recreated
      * @return a SwapchainComponents struct containing handles to the swapchain, images and image views,
      *         as well as relevant data for recreating the swapchain if necessary
@@ -40,6 +98,7 @@ namespace eng::swap {
                     const vk::SurfaceKHR& surface,
                     const vk::Extent2D& window_extent,
                     const vk::ImageUsageFlags usage,
+                    const PresentConfig& config = { },
                     const vk::SwapchainKHR& old_swapchain = {});
 
     /* Creation Helper Methods */
@@ -47,10 +106,11 @@ namespace eng::swap {
     /**
      * Selects a swapchain image count within the bounds of the surface capabilities
      * @param capabilities the surface capabilities for the target GPU
+     * @param requested_count the requested number of images, or zero for one above the minimum
      * @return the number of images to create in the swapchain
      */
     [[nodiscard]] uint32_t
-    chooseImageCount(const vk::SurfaceCapabilitiesKHR& capabilities);
+    chooseImageCount(const vk::SurfaceCapabilitiesKHR& capabilities, std::uint32_t requested_count);
 
     /**
      * Selects a targeted color format and color space from the list of supported surface formats,
@@ -62,13 +122,14 @@ namespace eng::swap {
     selectSurfaceFormat(std::span<const vk::SurfaceFormatKHR> supported_formats) ;
 
     /**
-     * Selects a targeted presentation mode from the list of supported modes, or falls back to
-     * the default if the targeted mode(s) is not supported
+     * Selects the presentation mode of a policy from the list of supported modes, falling back to the next
+     * lowest-latency mode, and finally to FIFO, if it is not supported
      * @param supported_present_modes the list of presentation modes supported by the target GPU
+     * @param policy the presentation policy
      * @return the selected present mode for the swapchain
      */
-    [[nodiscard]] vk::PresentModeKHR
-    selectPresentMode(std::span<const vk::PresentModeKHR> supported_present_modes);
+    export [[nodiscard]] vk::PresentModeKHR
+    selectPresentMode(std::span<const vk::PresentModeKHR> supported_present_modes, PresentPolicy policy);
 
     /**
      * Calculates the extent for images in the swapchain, handling the case where screen coordinates
@@ -87,6 +148,6 @@ namespace eng::swap {
      * @param device the logical device managing the swapchain images
      * @return a vector of ImageViews corresponding to the underlying swapchain images
      */
-    [[nodiscard]] std::vector<vk::ImageView>
+    export [[nodiscard]] std::vector<vk::ImageView>
     createImageViews(std::span<const vk::Image> images, const vk::Format& color_format, const vk::Device& device);
 }
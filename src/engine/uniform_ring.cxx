@@ -0,0 +1,100 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+module uniform_ring;
+
+// Internal Dependencies
+import debug_utils;
+
+namespace eng::ubo {
+    UniformRing::UniformRing(vk::SharedDevice device,
+                             mem::DeviceAllocator& allocator,
+                             const GPU& gpu,
+                             const std::uint32_t frames_in_flight,
+                             const vk::DeviceSize frame_capacity)
+        : m_device{ std::move(device) },
+          m_alignment{ std::max<vk::DeviceSize>(gpu.getProperties().limits.minUniformBufferOffsetAlignment, 1) },
+          m_frame_capacity{ frame_capacity - frame_capacity % m_alignment },
+          m_slice_range{ std::min<vk::DeviceSize>(MAX_SLICE_SIZE, gpu.getProperties().limits.maxUniformBufferRange) }
+    {
+        if (frames_in_flight == 0 || m_frame_capacity < m_slice_range)
+            throw std::invalid_argument("uniform ring requires a frame and a frame capacity of at least one slice");
+
+        // The descriptor's range extends past the last slice's offset, so the buffer is padded by one range
+        m_buffer = allocator.createBuffer(vk::BufferCreateInfo()
+            .setSize( m_frame_capacity * frames_in_flight + m_slice_range )
+            .setUsage( vk::BufferUsageFlagBits::eUniformBuffer )
+            .setSharingMode( vk::SharingMode::eExclusive ),
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+        constexpr vk::DescriptorSetLayoutBinding binding{
+            0,
+            vk::DescriptorType::eUniformBufferDynamic,
+            1,
+            vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute
+        };
+        m_set_layout = vk::SharedDescriptorSetLayout{
+            m_device->createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo().setBindings( binding )), m_device };
+
+        constexpr vk::DescriptorPoolSize pool_size{ vk::DescriptorType::eUniformBufferDynamic, 1 };
+        m_descriptor_pool = vk::SharedDescriptorPool{ m_device->createDescriptorPool(vk::DescriptorPoolCreateInfo()
+            .setMaxSets( 1 )
+            .setPoolSizes( pool_size )
+        ), m_device };
+
+        const std::array set_layouts{ m_set_layout.get() };
+        m_descriptor_set = m_device->allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool( m_descriptor_pool.get() )
+            .setSetLayouts( set_layouts )
+        )[0];
+
+        // The descriptor is written once, every slice is selected by its dynamic offset
+        const vk::DescriptorBufferInfo buffer_info{ m_buffer.get().get(), 0, m_slice_range };
+        m_device->updateDescriptorSets(vk::WriteDescriptorSet()
+            .setDstSet( m_descriptor_set )
+            .setDstBinding( 0 )
+            .setDescriptorType( vk::DescriptorType::eUniformBufferDynamic )
+            .setBufferInfo( buffer_info ), {});
+
+        dbg::setObjectName(m_device, m_buffer.get().get(), "uniform ring");
+        dbg::setObjectName(m_device, m_set_layout.get(), "uniform ring layout");
+        dbg::setObjectName(m_device, m_descriptor_pool.get(), "uniform ring pool");
+        dbg::setObjectName(m_device, m_descriptor_set, "uniform ring");
+    }
+
+    void UniformRing::beginFrame(const std::uint32_t frame_index)
+    {
+        m_frame_begin = m_frame_capacity * frame_index;
+        m_head = 0;
+    }
+
+    void UniformRing::bind(const vk::CommandBuffer& command_buffer,
+                           const vk::PipelineLayout& pipeline_layout,
+                           const std::uint32_t offset,
+                           const std::span<const vk::PipelineBindPoint> bind_points) const
+    {
+        for (const auto bind_point : bind_points)
+            command_buffer.bindDescriptorSets(bind_point, pipeline_layout, UNIFORM_SET, m_descriptor_set, offset);
+    }
+
+    std::uint32_t UniformRing::allocateBytes(const vk::DeviceSize size)
+    {
+        if (size > m_slice_range)
+            throw std::length_error("uniform slice exceeds the range of the dynamic descriptor");
+
+        const auto offset{ (m_head + m_alignment - 1) / m_alignment * m_alignment };
+        if (offset + size > m_frame_capacity)
+            throw std::runtime_error("uniform ring frame region exhausted");
+        m_head = offset + size;
+
+        ++m_statistics.slices;
+        m_statistics.peak_frame_bytes = std::max(m_statistics.peak_frame_bytes, m_head);
+        return static_cast<std::uint32_t>(m_frame_begin + offset);
+    }
+}
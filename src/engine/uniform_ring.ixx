@@ -0,0 +1,166 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+export module uniform_ring;
+
+// External Dependencies
+import vulkan_hpp;
+
+// Internal Dependencies
+import allocator;
+import gpu;
+
+namespace eng::ubo {
+    /**
+     * The bytes of uniform data each frame in flight may write, enough for tens of thousands of small slices
+     */
+    export constexpr vk::DeviceSize DEFAULT_FRAME_CAPACITY{ 1ull * 1024 * 1024 };
+
+    /**
+     * The set the ring's dynamic uniform buffer is bound to, following the descriptor heap's global set
+     */
+    export constexpr std::uint32_t UNIFORM_SET{ 1 };
+
+    /**
+     * The largest slice the ring hands out, the minimum maxUniformBufferRange guaranteed by the spec. The dynamic
+     * descriptor covers this range from each slice's offset.
+     */
+    export constexpr vk::DeviceSize MAX_SLICE_SIZE{ 16384 };
+
+    /**
+     * A type which may be copied into a uniform buffer as-is, its member layout must match the std140 block
+     * declared in the shaders
+     */
+    export template <typename T>
+    concept UniformBlock = std::is_trivially_copyable_v<T>
+                           && std::is_standard_layout_v<T>
+                           && sizeof(T) <= MAX_SLICE_SIZE;
+
+    /**
+     * A slice of the current frame's uniform data, written through the mapped pointer and selected in shaders by
+     * binding the ring's set with the slice's dynamic offset
+     */
+    export template <typename T>
+    struct UniformSlice
+    {
+        std::uint32_t offset{ 0 };  // The dynamic offset to bind the ring's set with
+        std::span<T> data;
+    };
+
+    export struct UniformStatistics
+    {
+        std::uint64_t slices{ 0 };              // Slices handed out since creation
+        vk::DeviceSize peak_frame_bytes{ 0 };   // The most any frame has used, including alignment padding
+    };
+
+    /**
+     * A persistently mapped, host-coherent uniform buffer divided into one linear region per frame in flight.
+     * Each frame's region is reset once the frame's completion has been waited on, and slices are bump-allocated from
+     * it, so writing per-frame data costs no allocations and no descriptor updates. A single dynamic uniform
+     * buffer descriptor covers the whole buffer, and each slice is selected by its offset at bind time.
+     */
+    export class UniformRing
+    {
+    public:
+        /* Constructors */
+
+        /**
+         * Creates the ring buffer and its descriptor set
+         * @param device the logical device which will own the resources
+         * @param allocator the allocator the ring buffer is sub-allocated from
+         * @param gpu the GPU, queried for its uniform buffer alignment and range limits
+         * @param frames_in_flight the number of frame regions
+         * @param frame_capacity the size of each frame region in bytes
+         */
+        UniformRing(vk::SharedDevice device,
+                    mem::DeviceAllocator& allocator,
+                    const GPU& gpu,
+                    std::uint32_t frames_in_flight,
+                    vk::DeviceSize frame_capacity = DEFAULT_FRAME_CAPACITY);
+
+        UniformRing(const UniformRing&) = delete;
+        UniformRing& operator=(const UniformRing&) = delete;
+
+        /* Frame Methods */
+
+        /**
+         * Starts writing into a frame's region, discarding the slices written the last time the frame slot was used
+         * @param frame_index the frame slot, whose previous submission must have completed
+         */
+        void beginFrame(std::uint32_t frame_index);
+
+        /**
+         * Reserves a slice of the current frame's region
+         * @param count the number of elements in the slice
+         * @return the slice, valid until its frame slot is next begun
+         * @throws std::runtime_error if the frame's region is exhausted
+         * @throws std::length_error if the slice exceeds the range of the dynamic descriptor
+         */
+        template <UniformBlock T>
+        [[nodiscard]] UniformSlice<T> allocate(const std::size_t count = 1)
+        {
+            const auto offset{ allocateBytes(sizeof(T) * count) };
+            return { offset, std::span{ reinterpret_cast<T*>(m_buffer.getMapped() + offset), count } };
+        }
+
+        /**
+         * Copies a value into a new slice of the current frame's region
+         * @return the dynamic offset of the slice
+         */
+        template <UniformBlock T>
+        [[nodiscard]] std::uint32_t push(const T& value)
+        {
+            const auto offset{ allocateBytes(sizeof(T)) };
+            std::memcpy(m_buffer.getMapped() + offset, &value, sizeof(T));
+            return offset;
+        }
+
+        /**
+         * Binds the ring's set, selecting the slice at an offset
+         * @param command_buffer the command buffer to record into
+         * @param pipeline_layout a pipeline layout whose set UNIFORM_SET is the ring's set layout
+         * @param offset the dynamic offset of the slice, as returned by allocate or push
+         * @param bind_points the bind points to bind the set to, supported by the command buffer's queue family
+         */
+        void bind(const vk::CommandBuffer& command_buffer,
+                  const vk::PipelineLayout& pipeline_layout,
+                  std::uint32_t offset,
+                  std::span<const vk::PipelineBindPoint> bind_points) const;
+
+        /* Accessors */
+
+        [[nodiscard]] vk::DescriptorSetLayout getSetLayout() const
+        { return m_set_layout.get(); }
+
+        [[nodiscard]] const UniformStatistics& getStatistics() const
+        { return m_statistics; }
+
+    private:
+        /* Data Members */
+
+        vk::SharedDevice                m_device;
+        mem::AllocatedBuffer            m_buffer;
+        vk::DeviceSize                  m_alignment;        // minUniformBufferOffsetAlignment
+        vk::DeviceSize                  m_frame_capacity;   // Rounded down to the alignment
+        vk::DeviceSize                  m_slice_range;      // The range of the dynamic descriptor
+
+        vk::SharedDescriptorSetLayout   m_set_layout;
+        vk::SharedDescriptorPool        m_descriptor_pool;
+        vk::DescriptorSet               m_descriptor_set;   // Freed with the pool
+
+        vk::DeviceSize                  m_frame_begin{ 0 };
+        vk::DeviceSize                  m_head{ 0 };        // Next free byte of the current frame's region
+
+        UniformStatistics               m_statistics;
+
+        /* Helper Methods */
+
+        // Bump-allocates an aligned range of the current frame's region, returning its offset into the buffer
+        [[nodiscard]] std::uint32_t allocateBytes(vk::DeviceSize size);
+    };
+}